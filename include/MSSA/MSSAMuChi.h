@@ -32,6 +32,8 @@
 
 #include "MSSA/MemRegion.h"
 
+#include <atomic>
+
 
 class MSSADEF;
 
@@ -43,8 +45,8 @@ class MRVer {
 public:
     typedef MSSADEF MSSADef;
 private:
-    /// ver ID 0 is reserved
-    static Size_t totalVERNum;
+    /// ver ID 0 is reserved, versions of different functions may be created in parallel
+    static std::atomic<Size_t> totalVERNum;
     const MemRegion* mr;
     VERSION version;
     MRVERID vid;
@@ -153,4 +153,38 @@ private:
     PointsToList inters;
 };
 
+/*!
+ * Create memory regions by clustering the objects a function accesses together.
+ * The objects are first split into disjoint sets accessed by the same loads/stores/callsites (as IntraDisjointMRG),
+ * sets mostly accessed together (similarity of the accesses above -mr-coaccess) are then merged into one region
+ * as long as the region has no more than -mr-max-size objects (a disjoint set larger than that stays one region,
+ * splitting it would only add mus/chis).
+ * Fewer regions means fewer mus/chis per access, at the price of spurious value-flows through the merged objects.
+ */
+class ClusteredMRG : public IntraDisjointMRG {
+public:
+    ClusteredMRG(BVDataPTAImpl* p) : IntraDisjointMRG(p)
+    {}
+
+    ~ClusteredMRG() {}
+
+protected:
+    /// Partition regions
+    virtual void partitionMRs();
+
+    /// Regions of a load are the regions of the function including any object it accesses
+    //@{
+    virtual inline void getMRsForLoad(MRSet& aliasMRs, const PointsTo& cpts, const llvm::Function* fun) {
+        getAliasMemRegions(aliasMRs, cpts, fun);
+    }
+    virtual inline void getMRsForCallSiteRef(MRSet& aliasMRs, const PointsTo& cpts, const llvm::Function* fun) {
+        getAliasMemRegions(aliasMRs, cpts, fun);
+    }
+    //@}
+
+private:
+    /// Merge the disjoint sets of objects of a function into clusters
+    void clusterObjects(const PointsToList& accesses, const PointsToList& disjoints, PointsToList& clusters);
+};
+
 #endif /* DISNCTMRGENERATOR_H_ */
@@ -179,6 +179,8 @@ private:
     CallSiteToMRsMap callsiteToRefMRsMap;
     /// Map a callsite to its mods regions
     CallSiteToMRsMap callsiteToModMRsMap;
+    /// Regions of the loads/stores/callsites not in the maps above
+    MRSet emptyMRSet;
     /// Map a load PAG Edge to its CPts set map
     LoadsToPointsToMap loadsToPointsToMap;
     /// Map a store PAG Edge to its CPts set map
@@ -369,10 +371,23 @@ protected:
     //@}
 
 public:
+    /// Regions and the mus/chis they give the loads/stores/callsites, to compare partitions
+    struct MRCost {
+        Size_t numOfMRs;
+        Size_t maxMRSize;
+        Size_t numOfLoadMus;
+        Size_t numOfStoreChis;
+        Size_t numOfCallSiteMus;
+        Size_t numOfCallSiteChis;
+    };
+
     inline Size_t getMRNum() const {
         return memRegSet.size();
     }
 
+    /// Cost of the regions generated
+    MRCost getCost() const;
+
     /// Destructor
     virtual ~MRGenerator() {
         destroy();
@@ -411,6 +426,32 @@ public:
         return callsiteToModMRsMap[cs];
     }
     //@}
+    /// Get Memory Region set without changing the maps, regions are looked up in parallel while building
+    /// memory SSA of different functions
+    //@{
+    inline const MRSet& getLoadMRSet(const LoadPE* load) const {
+        LoadsToMRsMap::const_iterator it = loadsToMRsMap.find(load);
+        return it == loadsToMRsMap.end() ? emptyMRSet : it->second;
+    }
+    inline const MRSet& getStoreMRSet(const StorePE* store) const {
+        StoresToMRsMap::const_iterator it = storesToMRsMap.find(store);
+        return it == storesToMRsMap.end() ? emptyMRSet : it->second;
+    }
+    inline bool hasRefMRSet(llvm::CallSite cs) const {
+        return callsiteToRefMRsMap.find(cs)!=callsiteToRefMRsMap.end();
+    }
+    inline bool hasModMRSet(llvm::CallSite cs) const {
+        return callsiteToModMRsMap.find(cs)!=callsiteToModMRsMap.end();
+    }
+    inline const MRSet& getCallSiteRefMRSet(llvm::CallSite cs) const {
+        CallSiteToMRsMap::const_iterator it = callsiteToRefMRsMap.find(cs);
+        return it == callsiteToRefMRsMap.end() ? emptyMRSet : it->second;
+    }
+    inline const MRSet& getCallSiteModMRSet(llvm::CallSite cs) const {
+        CallSiteToMRsMap::const_iterator it = callsiteToModMRsMap.find(cs);
+        return it == callsiteToModMRsMap.end() ? emptyMRSet : it->second;
+    }
+    //@}
     /// Whether this instruction has PAG Edge
     inline bool hasPAGEdgeList(const llvm::Instruction* inst) {
         return pta->getPAG()->hasPAGEdgeList(inst);
@@ -104,21 +104,66 @@ public:
     static double timeOfSSARenaming;	///< Time for SSA rename
     //@}
 
+    /*!
+     * State of building the memory SSA of one function.
+     * The mus/chis/phis of a function are collected here and added into MemSSA afterwards (addFunMSSA),
+     * so that different functions can be built in parallel.
+     */
+    struct FunMSSA {
+        FunMSSA(const llvm::Function* f, llvm::DominanceFrontier* d, llvm::DominatorTree* t) :
+            fun(f), df(d), dt(t), muchiTime(0), phiTime(0), renameTime(0) {
+        }
+
+        const llvm::Function* fun;
+        llvm::DominanceFrontier* df;	///< only used while building
+        llvm::DominatorTree* dt;	///< only used while building
+
+        /// The following three set are used for prune SSA phi insertion
+        // (see algorithm in book Engineering A Compiler section 9.3)
+        ///@{
+        /// Collects used memory regions
+        MRSet usedRegs;
+        /// Maps memory region to its basic block
+        MemRegToBBsMap reg2BBMap;
+        /// Collect memory regions whose definition killed
+        MRSet varKills;
+        //@}
+
+        /// For SSA renaming
+        //@{
+        MemRegToVerStackMap mr2VerStackMap;
+        MemRegToCounterMap mr2CounterMap;
+        //@}
+
+        /// Mus/chis/phis of the function
+        //@{
+        LoadToMUSetMap load2MuSetMap;
+        StoreToChiSetMap store2ChiSetMap;
+        CallSiteToMUSetMap callsiteToMuSetMap;
+        CallSiteToCHISetMap callsiteToChiSetMap;
+        BBToPhiSetMap bb2PhiSetMap;
+        CHISet entryChiSet;
+        MUSet returnMuSet;
+        //@}
+
+        double muchiTime;	///< Time for generating mu/chi
+        double phiTime;	///< Time for inserting phis
+        double renameTime;	///< Time for SSA rename
+    };
+
 protected:
     BVDataPTAImpl* pta;
     MRGenerator* mrGen;
-    llvm::DominanceFrontier* df;
-    llvm::DominatorTree* dt;
     MemSSAStat* stat;
 
     /// Create mu chi for candidate regions in a function
-    virtual void createMUCHI(const llvm::Function& fun);
+    virtual void createMUCHI(FunMSSA& fm);
     /// Insert phi for candidate regions in a fucntion
-    virtual void insertPHI(const llvm::Function& fun);
+    virtual void insertPHI(FunMSSA& fm);
     /// SSA rename for a function
-    virtual void SSARename(const llvm::Function& fun);
+    virtual void SSARename(FunMSSA& fm);
     /// SSA rename for a basic block
-    virtual void SSARenameBB(const llvm::BasicBlock& bb);
+    virtual void SSARenameBB(FunMSSA& fm, const llvm::BasicBlock& bb);
 private:
     LoadToMUSetMap load2MuSetMap;
     StoreToChiSetMap store2ChiSetMap;
@@ -129,20 +174,6 @@ private:
     FunToEntryChiSetMap funToEntryChiSetMap;
     FunToReturnMuSetMap funToReturnMuSetMap;
 
-    MemRegToVerStackMap mr2VerStackMap;
-    MemRegToCounterMap mr2CounterMap;
-
-    /// The following three set are used for prune SSA phi insertion
-    // (see algorithm in book Engineering A Compiler section 9.3)
-    ///@{
-    /// Collects used memory regions
-    MRSet usedRegs;
-    /// Maps memory region to its basic block
-    MemRegToBBsMap reg2BBMap;
-    /// Collect memory regions whose definition killed
-    MRSet varKills;
-    //@}
-
     /// Release the memory
     void destroy();
 
@@ -151,128 +182,118 @@ private:
                         const llvm::BasicBlock* succb);
 
     /// Get a new SSA name of a memory region
-    MRVer* newSSAName(const MemRegion* mr, MSSADEF* def);
+    MRVer* newSSAName(FunMSSA& fm, const MemRegion* mr, MSSADEF* def);
 
     /// Get the last version of the SSA ver of memory region
-    inline MRVer* getTopStackVer(const MemRegion* mr) {
-        std::vector<MRVer*> &stack = mr2VerStackMap[mr];
+    inline MRVer* getTopStackVer(FunMSSA& fm, const MemRegion* mr) {
+        std::vector<MRVer*> &stack = fm.mr2VerStackMap[mr];
         assert(!stack.empty() && "stack is empty!!");
         return stack.back();
     }
 
     /// Collect region uses and region defs according to mus/chis, in order to insert phis
     //@{
-    inline void collectRegUses(const MemRegion* mr) {
-        if (0 == varKills.count(mr))
-            usedRegs.insert(mr);
+    inline void collectRegUses(FunMSSA& fm, const MemRegion* mr) {
+        if (0 == fm.varKills.count(mr))
+            fm.usedRegs.insert(mr);
     }
-    inline void collectRegDefs(const llvm::BasicBlock* bb, const MemRegion* mr) {
-        varKills.insert(mr);
-        reg2BBMap[mr].push_back(bb);
+    inline void collectRegDefs(FunMSSA& fm, const llvm::BasicBlock* bb, const MemRegion* mr) {
+        fm.varKills.insert(mr);
+        fm.reg2BBMap[mr].push_back(bb);
     }
     //@}
 
     /// Add methods for mus/chis/phis
     //@{
-    inline void AddLoadMU(const llvm::BasicBlock* bb, const LoadPE* load, const MRSet& mrSet) {
+    inline void AddLoadMU(FunMSSA& fm, const llvm::BasicBlock* bb, const LoadPE* load, const MRSet& mrSet) {
         for (MRSet::iterator iter = mrSet.begin(), eiter = mrSet.end(); iter != eiter; ++iter)
-            AddLoadMU(bb,load,*iter);
+            AddLoadMU(fm,bb,load,*iter);
     }
-    inline void AddStoreCHI(const llvm::BasicBlock* bb, const StorePE* store, const MRSet& mrSet) {
+    inline void AddStoreCHI(FunMSSA& fm, const llvm::BasicBlock* bb, const StorePE* store, const MRSet& mrSet) {
         for (MRSet::iterator iter = mrSet.begin(), eiter = mrSet.end(); iter != eiter; ++iter)
-            AddStoreCHI(bb,store,*iter);
+            AddStoreCHI(fm,bb,store,*iter);
     }
-    inline void AddCallSiteMU(llvm::CallSite cs,  const MRSet& mrSet) {
+    inline void AddCallSiteMU(FunMSSA& fm, llvm::CallSite cs,  const MRSet& mrSet) {
         for (MRSet::iterator iter = mrSet.begin(), eiter = mrSet.end(); iter != eiter; ++iter)
-            AddCallSiteMU(cs,*iter);
+            AddCallSiteMU(fm,cs,*iter);
     }
-    inline void AddCallSiteCHI(llvm::CallSite cs,  const MRSet& mrSet) {
+    inline void AddCallSiteCHI(FunMSSA& fm, llvm::CallSite cs,  const MRSet& mrSet) {
         for (MRSet::iterator iter = mrSet.begin(), eiter = mrSet.end(); iter != eiter; ++iter)
-            AddCallSiteCHI(cs,*iter);
+            AddCallSiteCHI(fm,cs,*iter);
     }
-    inline void AddMSSAPHI(const llvm::BasicBlock* bb, const MRSet& mrSet) {
+    inline void AddMSSAPHI(FunMSSA& fm, const llvm::BasicBlock* bb, const MRSet& mrSet) {
         for (MRSet::iterator iter = mrSet.begin(), eiter = mrSet.end(); iter != eiter; ++iter)
-            AddMSSAPHI(bb,*iter);
+            AddMSSAPHI(fm,bb,*iter);
     }
-    inline void AddLoadMU(const llvm::BasicBlock* bb, const LoadPE* load, const MemRegion* mr) {
+    inline void AddLoadMU(FunMSSA& fm, const llvm::BasicBlock* bb, const LoadPE* load, const MemRegion* mr) {
         LOADMU* mu = new LOADMU(bb,load, mr);
-        load2MuSetMap[load].insert(mu);
-        collectRegUses(mr);
+        fm.load2MuSetMap[load].insert(mu);
+        collectRegUses(fm,mr);
     }
-    inline void AddStoreCHI(const llvm::BasicBlock* bb, const StorePE* store, const MemRegion* mr) {
+    inline void AddStoreCHI(FunMSSA& fm, const llvm::BasicBlock* bb, const StorePE* store, const MemRegion* mr) {
         STORECHI* chi = new STORECHI(bb,store, mr);
-        store2ChiSetMap[store].insert(chi);
-        collectRegUses(mr);
-        collectRegDefs(bb,mr);
+        fm.store2ChiSetMap[store].insert(chi);
+        collectRegUses(fm,mr);
+        collectRegDefs(fm,bb,mr);
     }
-    inline void AddCallSiteMU(llvm::CallSite cs, const MemRegion* mr) {
+    inline void AddCallSiteMU(FunMSSA& fm, llvm::CallSite cs, const MemRegion* mr) {
         CALLMU* mu = new CALLMU(cs, mr);
-        callsiteToMuSetMap[cs].insert(mu);
-        collectRegUses(mr);
+        fm.callsiteToMuSetMap[cs].insert(mu);
+        collectRegUses(fm,mr);
     }
-    inline void AddCallSiteCHI(llvm::CallSite cs, const MemRegion* mr) {
+    inline void AddCallSiteCHI(FunMSSA& fm, llvm::CallSite cs, const MemRegion* mr) {
         CALLCHI* chi = new CALLCHI(cs, mr);
-        callsiteToChiSetMap[cs].insert(chi);
-        collectRegUses(mr);
-        collectRegDefs(chi->getBasicBlock(),mr);
+        fm.callsiteToChiSetMap[cs].insert(chi);
+        collectRegUses(fm,mr);
+        collectRegDefs(fm,chi->getBasicBlock(),mr);
     }
-    inline void AddMSSAPHI(const llvm::BasicBlock* bb, const MemRegion* mr) {
-        bb2PhiSetMap[bb].insert(new PHI(bb, mr));
+    inline void AddMSSAPHI(FunMSSA& fm, const llvm::BasicBlock* bb, const MemRegion* mr) {
+        fm.bb2PhiSetMap[bb].insert(new PHI(bb, mr));
     }
     //@}
 
     /// Rename mus, chis and phis
     //@{
     /// Rename mu set
-    inline void RenameMuSet(const MUSet& muSet) {
+    inline void RenameMuSet(FunMSSA& fm, const MUSet& muSet) {
         for (MUSet::iterator mit = muSet.begin(), emit = muSet.end();
                 mit != emit; ++mit) {
             MU* mu = (*mit);
-            mu->setVer(getTopStackVer(mu->getMR()));
+            mu->setVer(getTopStackVer(fm,mu->getMR()));
         }
     }
 
     /// Rename chi set
-    inline void RenameChiSet(const CHISet& chiSet, MRVector& memRegs) {
+    inline void RenameChiSet(FunMSSA& fm, const CHISet& chiSet, MRVector& memRegs) {
         for (CHISet::iterator cit = chiSet.begin(), ecit = chiSet.end();
                 cit != ecit; ++cit) {
             CHI* chi = (*cit);
-            chi->setOpVer(getTopStackVer(chi->getMR()));
-            chi->setResVer(newSSAName(chi->getMR(),chi));
+            chi->setOpVer(getTopStackVer(fm,chi->getMR()));
+            chi->setResVer(newSSAName(fm,chi->getMR(),chi));
             memRegs.push_back(chi->getMR());
         }
     }
 
     /// Rename result (LHS) of phis
-    inline void RenamePhiRes(const PHISet& phiSet, MRVector& memRegs) {
+    inline void RenamePhiRes(FunMSSA& fm, const PHISet& phiSet, MRVector& memRegs) {
         for (PHISet::iterator iter = phiSet.begin(), eiter = phiSet.end();
                 iter != eiter; ++iter) {
             PHI* phi = *iter;
-            phi->setResVer(newSSAName(phi->getMR(),phi));
+            phi->setResVer(newSSAName(fm,phi->getMR(),phi));
             memRegs.push_back(phi->getMR());
         }
     }
 
     /// Rename operands (RHS) of phis
-    inline void RenamePhiOps(const PHISet& phiSet, u32_t pos, MRVector& memRegs) {
+    inline void RenamePhiOps(FunMSSA& fm, const PHISet& phiSet, u32_t pos, MRVector& memRegs) {
         for (PHISet::iterator iter = phiSet.begin(), eiter = phiSet.end();
                 iter != eiter; ++iter) {
             PHI* phi = *iter;
-            phi->setOpVer(getTopStackVer(phi->getMR()), pos);
+            phi->setOpVer(getTopStackVer(fm,phi->getMR()), pos);
         }
     }
 
     //@}
-    /// Get/set methods for dominace frontier/tree
-    //@{
-    llvm::DominanceFrontier* getDF(const llvm::Function& fn) {
-        return df;
-    }
-    llvm::DominatorTree* getDT(const llvm::Function& fn) {
-        return dt;
-    }
-    void setCurrentDFDT(llvm::DominanceFrontier* f, llvm::DominatorTree* t);
-    //@}
 
 public:
     /// Constructor
@@ -297,6 +318,11 @@ public:
     /// We start from here
     virtual void buildMemSSA(const llvm::Function& fun,llvm::DominanceFrontier*, llvm::DominatorTree*);
 
+    /// Build the memory SSA of fm.fun into fm only, the functions of different fm can be built in parallel
+    void buildFunMSSA(FunMSSA& fm);
+    /// Add the mus/chis/phis of a built function, one function at a time
+    void addFunMSSA(FunMSSA& fm);
+
     /// Perform statistics
     void performStat();
 
@@ -447,6 +447,36 @@ protected:
     void connectDirectSVFGEdges();
     /// Connect direct SVFG edges between two SVFG nodes (value-flow of top address-taken variables)
     void connectIndirectSVFGEdges();
+
+    /// An edge to be connected to a node, collected before any edge is added.
+    /// The objects of an indirect edge are not copied, they are the objects of a memory region or
+    /// node (cpts), intersected with those of another node (mask) for call/ret edges.
+    struct PendingSVFGEdge {
+        SVFGEdge::SVFGEdgeK kind;
+        NodeID src;
+        NodeID dst;
+        CallSiteID csId;
+        const PointsTo* cpts;
+        const PointsTo* mask;
+        PendingSVFGEdge(SVFGEdge::SVFGEdgeK k, NodeID s, NodeID d, CallSiteID id = 0,
+                        const PointsTo* pts = NULL, const PointsTo* m = NULL) :
+            kind(k), src(s), dst(d), csId(id), cpts(pts), mask(m) {
+        }
+    };
+    typedef std::vector<PendingSVFGEdge> PendingSVFGEdges;
+
+    /// Connect the incoming direct or indirect edges of every node.
+    /// Edges of each node are collected without touching the graph (on parallel threads with -svfg-parallel)
+    /// and then added node by node, so the graph is the same either way.
+    /// The whole graph is still built at once, there are no per-function fragments reused across runs.
+    void connectSVFGEdgesOfNodes(bool direct);
+    /// Collect the incoming edges of node, must only read the graph and memory SSA
+    //@{
+    void collectDirectSVFGEdges(const SVFGNode* node, PendingSVFGEdges& edges) const;
+    void collectIndirectSVFGEdges(const SVFGNode* node, PendingSVFGEdges& edges) const;
+    //@}
+    /// Add the collected edges to the graph
+    void addPendingSVFGEdges(const PendingSVFGEdges& edges);
     /// Connect indirect SVFG edges from global initializers (store) to main function entry
     void connectFromGlobalToProgEntry();
 
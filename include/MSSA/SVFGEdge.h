@@ -33,6 +33,9 @@
 
 #include "MSSA/MemSSA.h"
 
+#include <deque>
+#include <unordered_map>
+
 class SVFGNode;
 
 /*!
@@ -220,6 +223,60 @@ public:
     //@}
 };
 
+/*!
+ * Points-to labels of the indirect SVFG edges, hash-consed.
+ * Many edges carry the same objects (the points-to of one memory region), every distinct label is stored once
+ * and an edge only keeps its ID. Labels are not changed while the table is in use, so the intersection of two
+ * labels is cached by their IDs.
+ * The table is shared by the SVFGs alive, each of them retains it when built and releases it when destroyed,
+ * the labels and the cache are freed with the last one.
+ * It is not thread-safe: labels are only made while edges are added, which SVFG construction (including
+ * -svfg-parallel, whose threads only collect the edges) and SVFGOPT do sequentially.
+ */
+class IndirectSVFGEdgeLabels {
+public:
+    typedef u32_t LabelID;
+
+    static const LabelID EmptyLabel = 0;
+
+    /// Return the ID of the label equal to pts
+    static LabelID getLabel(const PointsTo& pts);
+
+    /// Objects of a label
+    static inline const PointsTo& getPointsTo(LabelID label) {
+        return labels[label];
+    }
+
+    /// Cached intersection of two labels
+    static LabelID intersectLabels(LabelID l1, LabelID l2);
+
+    /// Keep the table alive for an SVFG, or free it once no SVFG is left
+    //@{
+    static inline void retain() {
+        numOfOwners++;
+    }
+    static void release();
+    //@}
+
+    /// Number of distinct labels
+    static inline Size_t getNumOfLabels() {
+        return labels.size();
+    }
+
+private:
+    typedef std::pair<LabelID, LabelID> LabelPair;
+    typedef llvm::DenseMap<LabelPair, LabelID> LabelPairToLabelMap;
+
+    static std::deque<PointsTo> labels;	///< never reallocated, references to the labels stay valid
+    static std::unordered_multimap<size_t, LabelID> hashToLabels;
+    static LabelPairToLabelMap intersectionCache;
+    static u32_t numOfOwners;	///< SVFGs using the table
+
+    static inline LabelPair getLabelPair(LabelID l1, LabelID l2) {
+        return l1 < l2 ? std::make_pair(l1, l2) : std::make_pair(l2, l1);
+    }
+};
+
 /*!
  * SVFG edge representing indirect value-flows from a caller to its callee at a callsite
  */
@@ -227,20 +284,48 @@ class IndirectSVFGEdge : public SVFGEdge {
 
 public:
     typedef std::set<const MRVer*> MRVerSet;
+    typedef IndirectSVFGEdgeLabels::LabelID LabelID;
 private:
     MRVerSet mrs;
-    PointsTo cpts;
+    mutable LabelID label;	///< objects of the edge, hash-consed
+    mutable PointsTo* pending;	///< objects of the edge not interned yet, NULL if there are none
+
+    /// Intern the objects added since the edge was last queried
+    inline void internPending() const {
+        if (pending != NULL) {
+            label = IndirectSVFGEdgeLabels::getLabel(*pending);
+            delete pending;
+            pending = NULL;
+        }
+    }
 public:
     /// Constructor
-    IndirectSVFGEdge(SVFGNode* s, SVFGNode* d, GEdgeFlag k): SVFGEdge(s,d,k) {
+    IndirectSVFGEdge(SVFGNode* s, SVFGNode* d, GEdgeFlag k): SVFGEdge(s,d,k), label(IndirectSVFGEdgeLabels::EmptyLabel), pending(NULL) {
+    }
+    /// Destructor
+    virtual ~IndirectSVFGEdge() {
+        delete pending;
     }
     /// Handle memory region
     //@{
+    /// Objects are collected on the edge and only interned once it is queried,
+    /// so adding objects to an edge repeatedly while it is built interns a single label
     inline bool addPointsTo(const PointsTo& c) {
-        return (cpts |= c);
+        if (pending == NULL) {
+            const PointsTo& pts = IndirectSVFGEdgeLabels::getPointsTo(label);
+            if (pts.contains(c))
+                return false;
+            pending = new PointsTo(pts);
+        }
+        return (*pending |= c);
     }
     inline const PointsTo& getPointsTo() const {
-        return cpts;
+        internPending();
+        return IndirectSVFGEdgeLabels::getPointsTo(label);
+    }
+    inline LabelID getLabel() const {
+        internPending();
+        return label;
     }
 
     inline MRVerSet& getMRVer() {
@@ -248,7 +333,7 @@ public:
     }
     inline bool addMrVer(const MRVer* mr) {
         // collect memory regions' pts to edge;
-        cpts |= mr->getMR()->getPointsTo();
+        addPointsTo(mr->getMR()->getPointsTo());
         return mrs.insert(mr).second;
     }
     //@}
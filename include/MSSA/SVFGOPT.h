@@ -50,6 +50,11 @@
  * 3. FormalIns/FormalOuts reside at the entry/exit of non-address-taken functions is
  *    removed as ActualIn/ActualOuts.
  * 4. MSSAPHI nodes are removed if it have no self cycle. Otherwise depends on user option.
+ * 5. (-svfg-opt-passes=dead) Address-taken value-flows which never reach a load are removed.
+ * 6. (-svfg-opt-passes=phichain) Chains and two-node cycles of MSSAPHI nodes are collapsed into
+ *    one node where no value-flow changes, without the extra edges of bypassing them as 4.
+ * 7. (-svfg-opt-passes=mergephi) MSSAPHI nodes of a function with the same incoming edges are merged.
+ * 1-3 always run first, -svfg-opt-passes gives the passes run after them (default: 4).
  */
 class SVFGOPT : public SVFG {
     typedef std::set<SVFGNode*> SVFGNodeSet;
@@ -57,6 +62,15 @@ class SVFGOPT : public SVFG {
     typedef FIFOWorkList<const MSSAPHISVFGNode*> WorkList;
 
 public:
+    /// Optimisation passes
+    enum OptPassKind {
+        InterValueFlowPass,	///< 1-3 above
+        MSSAPHIPass,		///< 4 above
+        DeadValueFlowPass,	///< 5 above
+        PHIChainPass,		///< 6 above
+        MergePHIPass		///< 7 above
+    };
+
     /// Constructor
     SVFGOPT() : SVFG(OPTSVFGK) {
         keepAllSelfCycle = keepContextSelfCycle = keepActualOutFormalIn = false;
@@ -89,9 +103,7 @@ protected:
         DBOUT(DGENERAL, llvm::outs() << analysisUtil::pasMsg("\tSVFG Optimisation\n"));
 
         stat->sfvgOptStart();
-        handleInterValueFlow();
-
-        handleIntraValueFlow();
+        runOptPasses();
         stat->sfvgOptEnd();
 
     }
@@ -194,6 +206,20 @@ protected:
 private:
     void parseSelfCycleHandleOption();
 
+    /// Run the optimisation passes, recording the nodes/edges each of them removed
+    //@{
+    void runOptPasses();
+    void runOptPass(OptPassKind pass);
+    //@}
+
+    /// Number of nodes/edges in the graph now
+    //@{
+    inline Size_t getNumOfNodes() const {
+        return IDToNodeMap.size();
+    }
+    Size_t getNumOfEdges() const;
+    //@}
+
     /// Add inter-procedural value flow edge
     //@{
     /// Add indirect call edge from src to dst with one call site ID.
@@ -249,6 +275,50 @@ private:
     /// Remove MSSAPHI node if possible
     void bypassMSSAPHINode(const MSSAPHISVFGNode* node);
 
+    /// Remove the address-taken value-flows which never reach a load.
+    /// A store, MSSAPHI or removable actual/formal-in/out node is dead if none of its successors is live,
+    /// other nodes are live. Dead nodes are removed, dead stores only lose their indirect outgoing edges.
+    void removeDeadValueFlow();
+
+    /// Whether a node is dead unless a live node uses its memory value-flows
+    bool mayBeDeadValueFlow(const SVFGNode* node);
+
+    /// Collapse chains and two-node cycles of MSSAPHI nodes
+    //@{
+    void collapseMSSAPHIChains();
+    /// Return the MSSAPHI node which node can be merged into, NULL if there is none.
+    /// inEdge/outEdge are set to the intra edges from/to it which are replaced by the merge.
+    const SVFGNode* getMSSAPHIChainRep(const SVFGNode* node, const SVFGEdge*& inEdge, const SVFGEdge*& outEdge);
+    /// Whether an edge is an intra indirect edge between two different MSSAPHI nodes
+    inline bool isMSSAPHIChainEdge(const SVFGEdge* edge) const {
+        return llvm::isa<IntraIndSVFGEdge>(edge) && edge->getSrcID() != edge->getDstID()
+               && llvm::isa<MSSAPHISVFGNode>(edge->getSrcNode()) && llvm::isa<MSSAPHISVFGNode>(edge->getDstNode());
+    }
+    /// Whether the objects of edge1 are all objects of edge2
+    inline bool labelCovered(const SVFGEdge* edge1, const SVFGEdge* edge2) const {
+        IndirectSVFGEdge::LabelID label1 = llvm::cast<IndirectSVFGEdge>(edge1)->getLabel();
+        IndirectSVFGEdge::LabelID label2 = llvm::cast<IndirectSVFGEdge>(edge2)->getLabel();
+        return IndirectSVFGEdgeLabels::intersectLabels(label1, label2) == label1;
+    }
+    /// Move the edges of node to rep through inEdge (rep->node) and outEdge (node->rep), then remove node
+    void mergeMSSAPHINode(const SVFGNode* node, const SVFGNode* rep, const SVFGEdge* inEdge, const SVFGEdge* outEdge);
+    //@}
+
+    /// Merge the MSSAPHI nodes of a function which have the same incoming edges
+    //@{
+    typedef std::pair<const llvm::Function*, std::vector<NodeID> > MSSAPHIInEdgesKey;
+    void mergeEquivalentMSSAPHINodes();
+    /// Function and incoming edges (src, kind, call site, label) of a MSSAPHI node
+    void getMSSAPHIInEdgesKey(const SVFGNode* node, MSSAPHIInEdgesKey& key) const;
+    /// Add an indirect edge from src to dst of the same kind, call site and objects as edge
+    SVFGEdge* addIndirectSVFGEdgeLike(NodeID srcId, NodeID dstId, const SVFGEdge* edge);
+    //@}
+
+    /// MSSAPHI nodes which can be merged into another node: not the def-site of actual-in/formal-out
+    inline bool isMergeableMSSAPHI(const SVFGNode* node) {
+        return llvm::isa<MSSAPHISVFGNode>(node) && isDefOfAInFOut(node) == false;
+    }
+
     /// Remove self cycle edges if needed. Return TRUE if some self cycle edges remained.
     bool checkSelfCycleEdges(const MSSAPHISVFGNode* node);
 
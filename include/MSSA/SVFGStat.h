@@ -143,6 +143,11 @@ public:
         svfgOptTimeEnd = CLOCK_IN_MS();
     }
 
+    /// Record a statistic of a SVFG optimisation pass, the key is a literal name
+    void addOptPassStat(const char* key, Size_t num) {
+        optPassNumMap[key] = num;
+    }
+
 private:
     void clear();
 
@@ -156,6 +161,8 @@ private:
 
     SVFG* graph;
 
+    NUMStatMap optPassNumMap;	///< nodes/edges changed by each SVFG optimisation pass
+
     int numOfNodes;	///< number of svfg nodes.
 
     int numOfFormalIn;	///< number of formal in svfg nodes.
@@ -11,46 +11,123 @@
 #define K_LIMIT 2
 
 namespace ctx {
+    /*!
+     * Call strings interned into a tree: a context is a node of the tree, identified by a dense 32-bit ID,
+     * its parent is the context without the last pushed call site. ID 0 is the empty context.
+     * Contexts are compared and hashed by ID, push/pop only walk one edge of the tree.
+     */
+    class CallSiteTree {
+    public:
+        typedef u32_t ContextID;
+        static const ContextID EMPTY = 0;
+
+    private:
+        struct TreeNode {
+            ContextID parent;
+            const PTACallGraphNode *callSite;
+            u32_t depth;
+        };
+        typedef std::pair<ContextID, const PTACallGraphNode *> ChildKey;
+
+        std::vector<TreeNode> nodes;
+        llvm::DenseMap<ChildKey, ContextID> children;
+
+    public:
+        CallSiteTree() {
+            nodes.push_back(TreeNode{EMPTY, nullptr, 0});
+        }
+
+        /// The context extended by callSite, interned on first use
+        inline ContextID getChild(ContextID ctx, const PTACallGraphNode *callSite) {
+            auto it = children.find(std::make_pair(ctx, callSite));
+            if (it != children.end()) {
+                return it->second;
+            }
+            auto id = static_cast<ContextID>(nodes.size());
+            nodes.push_back(TreeNode{ctx, callSite, nodes[ctx].depth + 1});
+            children[std::make_pair(ctx, callSite)] = id;
+            return id;
+        }
+
+        inline ContextID getParent(ContextID ctx) const {
+            assert(ctx != EMPTY && "pop from an empty context");
+            return nodes[ctx].parent;
+        }
+
+        inline const PTACallGraphNode *getCallSite(ContextID ctx) const {
+            return nodes[ctx].callSite;
+        }
+
+        inline u32_t getDepth(ContextID ctx) const {
+            return nodes[ctx].depth;
+        }
+
+        inline u32_t getNumOfContexts() const {
+            return nodes.size();
+        }
+    };
+
     class CallSite {
     public:
+        typedef CallSiteTree::ContextID ContextID;
         typedef std::vector<const PTACallGraphNode *> CallChain;
 
     private:
-        CallChain callSiteChain;
+        ContextID id;
+
+        explicit CallSite(ContextID id) : id(id) {}
+
+        static CallSite fromCallChain(const CallChain &chain) {
+            ContextID ctx = CallSiteTree::EMPTY;
+            for (const PTACallGraphNode *callSite : chain) {
+                ctx = getTree().getChild(ctx, callSite);
+            }
+            return CallSite(ctx);
+        }
 
     public:
-        CallSite() = default;
+        CallSite() : id(CallSiteTree::EMPTY) {}
+
+        /// All call site contexts share one tree
+        static CallSiteTree &getTree();
 
         static CallSite emptyCtx() {
             return CallSite();
         }
 
         inline void push(PTACallGraphNode *callSite) {
-            this->callSiteChain.push_back(callSite);
+            id = getTree().getChild(id, callSite);
         }
 
         inline void pop() {
-            callSiteChain.pop_back();
+            id = getTree().getParent(id);
         }
 
+        // the front of the chain is the first pushed call site, rebuilding is bounded by K_LIMIT
         inline void addNodeInFrontAndPopBack(PTACallGraphNode *node) {
-            callSiteChain.pop_back();
-            callSiteChain.insert(callSiteChain.begin(), node);
+            CallChain chain = getCallChain();
+            chain.pop_back();
+            chain.insert(chain.begin(), node);
+            *this = fromCallChain(chain);
         }
 
         inline void addNodeInFront(PTACallGraphNode *node) {
-            callSiteChain.insert(callSiteChain.begin(), node);
+            CallChain chain = getCallChain();
+            chain.insert(chain.begin(), node);
+            *this = fromCallChain(chain);
         }
 
-        std::string toString() const {    
+        std::string toString() const {
             std::string str;
             llvm::raw_string_ostream rawstr(str);
-            if (callSiteChain.empty()) {
+            if (id == CallSiteTree::EMPTY) {
                 rawstr << "( empty )";
             } else {
-                rawstr << "{ " << callSiteChain.back()->getFunction()->getName();
-                for (int i = callSiteChain.size() - 2; i >= 0; i --) {
-                    rawstr << "->" << callSiteChain[i]->getFunction()->getName();
+                // from the last pushed call site to the first one
+                const CallSiteTree &tree = getTree();
+                rawstr << "{ " << tree.getCallSite(id)->getFunction()->getName();
+                for (ContextID cur = tree.getParent(id); cur != CallSiteTree::EMPTY; cur = tree.getParent(cur)) {
+                    rawstr << "->" << tree.getCallSite(cur)->getFunction()->getName();
                 }
                 rawstr << "}";
             }
@@ -58,27 +135,35 @@ namespace ctx {
         }
 
         friend bool operator<(const CallSite &lhs, const CallSite &rhs) {
-            return lhs.toString() < rhs.toString();
+            return lhs.id < rhs.id;
         }
 
         friend bool operator==(const CallSite &lhs, const CallSite &rhs) {
-            if (lhs.callSiteChain.size() == rhs.callSiteChain.size()) {
-                for (int i = 0; i < lhs.callSiteChain.size(); i++) {
-                    if (lhs.callSiteChain[i] != rhs.callSiteChain[i]) {
-                        return false;
-                    }
-                }
-                return true;
-            }
-            return false;
+            return lhs.id == rhs.id;
+        }
+
+        inline ContextID getID() const {
+            return id;
+        }
+
+        inline u32_t getDepth() const {
+            return getTree().getDepth(id);
         }
 
-        const CallChain *getCallChain() const {
-            return &this->callSiteChain;
+        /// The call sites from the first pushed one to the last one
+        CallChain getCallChain() const {
+            const CallSiteTree &tree = getTree();
+            CallChain chain(tree.getDepth(id));
+            ContextID cur = id;
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                *it = tree.getCallSite(cur);
+                cur = tree.getParent(cur);
+            }
+            return chain;
         }
 
-        bool isEmptyCtx() {
-            return callSiteChain.empty();
+        bool isEmptyCtx() const {
+            return id == CallSiteTree::EMPTY;
         }
     };
 }
@@ -88,13 +173,28 @@ private:
     typedef llvm::SparseBitVector<20> Origins;
     typedef std::map<const llvm::Function *, Origins> FuncToOriginsMap;
 
+    /// A function cloned under one context
+    typedef std::pair<const llvm::Function *, ctx::CallSite> FuncInstance;
+    typedef std::map<const llvm::Function *, std::vector<PAGNode *>> FuncToNodesMap;
+    typedef std::map<const llvm::Function *, std::vector<PAGEdge *>> FuncToEdgesMap;
+
 private:
     SVFModule &module;
     PTACallGraph *callGraph; // pre-built call graph
     FuncToOriginsMap funcToOrigins;
 
+    /// Cloning of the reachable function instances only
+    //@{
+    FuncToNodesMap funcToNodes;         ///< nodes local to a function
+    FuncToEdgesMap funcToIntraEdges;    ///< intra edges with an end local to a function
+    FuncToEdgesMap funcToCallEdges;     ///< call/ret edges of the call sites in a function
+    std::set<FuncInstance> reachedInstances;
+    std::vector<FuncInstance> instancesToClone;
+    //@}
+
 private:
     void addNodes() override;
+    void addEdges() override;
 
     void addNodeWithCallSite(PAGNode *node, const llvm::Function *func);
     void recAddNodes(PAGNode *node, PTACallGraphNode *callGraphNode, ctx::CallSite &ctx, int depth);
@@ -105,11 +205,26 @@ private:
     void addCtxRetEdges(PAGNode *src, PAGNode *dst, RetPE *callEdge, const llvm::Function *func);
     void recAddCtxRetEdges(PAGNode *src, PAGNode *dst, PTACallGraphNode *callGraphNode, PTACallGraphNode *curNode, ctx::CallSite &ctx, RetPE *callEdge, int depth);
 
+    /// The context of the callees of caller under callerCtx (k-limited)
+    static ctx::CallSite getCalleeCtx(const ctx::CallSite &callerCtx, PTACallGraphNode *caller);
+
+    /// Cloning of the reachable function instances only
+    //@{
+    void indexEdges();
+    void reachInstance(const llvm::Function *func, const ctx::CallSite &ctx);
+    void cloneInstance(const FuncInstance &instance);
+    void addInstanceCallEdges(const FuncInstance &instance);
+    CtxPAGNode<ctx::CallSite> *getCloneInCtx(PAGNode *node, const ctx::CallSite &ctx);
+    //@}
+
+    /// Whether node is cloned per context of the function it is local to
+    bool hasCtx(PAGNode *node) const;
+
 public:
-    CallSitePAG(SVFModule &module, PTACallGraph *callGraph) : CtxPAG<ctx::CallSite>(), module(module), callGraph(callGraph) {
-        // TODO: not a good practice!! change it to singleton pattern later!
-        CallSitePAG::ctxPAG = this;
-    }
+    CallSitePAG(SVFModule &module, PTACallGraph *callGraph, bool cloneReachable);
+
+    /// The function a node is local to, nullptr for nodes without context (globals, constants, dummies)
+    static const llvm::Function *getOwnerFunction(PAGNode *node);
 
     std::string getGraphName() override {
         return "CallSite PAG";
@@ -118,6 +233,9 @@ public:
 
     void dupCtxCallEdge(CallPE *callEdge) override;
     void dupCtxRetEdge(RetPE *retEdge) override;
+
+    bool cloneReachedInstances() override;
+    bool connectIndirectCall(llvm::CallSite cs, const llvm::Function *callee, const ctx::CallSite &callerCtx) override;
 };
 
 namespace llvm {
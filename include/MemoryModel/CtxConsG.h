@@ -38,6 +38,9 @@ public:
         buildCG();
     }
 
+    /// Mirror a (cloned) PAG edge, return false if the constraint edge exists already
+    bool addCGEdge(CtxPAGEdge<Ctx> *edge);
+
     inline void addConstraintNode(CtxConstraintNode<Ctx>* node, NodeID id) {
         this->addGNode(id,node);
     }
@@ -453,6 +456,38 @@ bool CtxConstraintGraph<Ctx>::moveOutEdgesToRepNode(CtxConstraintNode<Ctx> *node
     return criticalGepInsideSCC;
 }
 
+template <typename Ctx>
+bool CtxConstraintGraph<Ctx>::addCGEdge(CtxPAGEdge<Ctx> *edge) {
+    switch (edge->getEdgeKind()) {
+        case PAGEdge::Addr:
+            return addAddrCGEdge(edge->getSrcID(), edge->getDstID());
+        case PAGEdge::Copy:
+        case PAGEdge::Call:
+        case PAGEdge::Ret:
+        case PAGEdge::ThreadFork:
+        case PAGEdge::ThreadJoin:
+            return addCopyCGEdge(edge->getSrcID(), edge->getDstID());
+        case PAGEdge::NormalGep: {
+            auto *ngep = cast<CtxNormalGepPE<Ctx>>(edge);
+            return addNormalGepCGEdge(ngep->getSrcID(), ngep->getDstID(), ngep->getLocationSet());
+        }
+        case PAGEdge::VariantGep:
+            return addVariantGepCGEdge(edge->getSrcID(), edge->getDstID());
+        case PAGEdge::Store:
+            return addStoreCGEdge(edge->getSrcID(), edge->getDstID());
+        case PAGEdge::Load:
+            return addLoadCGEdge(edge->getSrcID(), edge->getDstID());
+        default:
+            assert(false && "no other kind!");
+    }
+    return false;
+}
+
+/*!
+ * Constraint nodes reuse the IDs of the clones in the context-sensitive PAG, so the points-to of a node
+ * is the points-to of its clone. Contexts are switched by the cloned call/ret/fork/join edges already,
+ * all of which become copy edges.
+ */
 template <typename Ctx>
 void CtxConstraintGraph<Ctx>::buildCG() {
 
@@ -462,57 +497,24 @@ void CtxConstraintGraph<Ctx>::buildCG() {
     }
 
     // initialize edges
-    typename CtxPAGEdge<Ctx>::PAGEdgeSetTy& addrs = ctxPAG->getEdgeSet(PAGEdge::Addr);
-    for (CtxPAGEdge<Ctx>* edge : addrs) {
-        addAddrCGEdge(edge->getSrcID(),edge->getDstID());
-    }
-
-    typename CtxPAGEdge<Ctx>::PAGEdgeSetTy& copys = ctxPAG->getEdgeSet(PAGEdge::Copy);
-    for (CtxPAGEdge<Ctx> *edge : copys) {
-        addCopyCGEdge(edge->getSrcID(),edge->getDstID());
-    }
-
-    typename CtxPAGEdge<Ctx>::PAGEdgeSetTy& calls = ctxPAG->getEdgeSet(PAGEdge::Call);
-    for (CtxPAGEdge<Ctx> *edge : calls) {
-        addCopyCGEdge(edge->getSrcID(),edge->getDstID());
-    }
-
-    typename CtxPAGEdge<Ctx>::PAGEdgeSetTy& rets = ctxPAG->getEdgeSet(PAGEdge::Ret);
-    for (CtxPAGEdge<Ctx> *edge : rets) {
-        addCopyCGEdge(edge->getSrcID(),edge->getDstID());
-    }
-
-    typename CtxPAGEdge<Ctx>::PAGEdgeSetTy& tdfks = ctxPAG->getEdgeSet(PAGEdge::ThreadFork);
-    for (CtxPAGEdge<Ctx> *edge : tdfks) {
-        addCopyCGEdge(edge->getSrcID(),edge->getDstID());
-    }
-
-    typename CtxPAGEdge<Ctx>::PAGEdgeSetTy& tdjns = ctxPAG->getEdgeSet(PAGEdge::ThreadJoin);
-    for (CtxPAGEdge<Ctx> *edge : tdjns) {
-        addCopyCGEdge(edge->getSrcID(),edge->getDstID());
-    }
-
-    typename CtxPAGEdge<Ctx>::PAGEdgeSetTy& ngeps = ctxPAG->getEdgeSet(PAGEdge::NormalGep);
-    for (CtxPAGEdge<Ctx> *edge : ngeps) {
-        auto *ngep = cast<CtxNormalGepPE<Ctx>>(edge);
-        addNormalGepCGEdge(ngep->getSrcID(),ngep->getDstID(),ngep->getLocationSet());
-    }
-
-    typename CtxPAGEdge<Ctx>::PAGEdgeSetTy& vgeps = ctxPAG->getEdgeSet(PAGEdge::VariantGep);
-    for (CtxPAGEdge<Ctx> *edge : vgeps) {
-        auto* vgep = cast<CtxVariantGepPE<Ctx>>(edge);
-        addVariantGepCGEdge(vgep->getSrcID(),vgep->getDstID());
-    }
-
-    typename CtxPAGEdge<Ctx>::PAGEdgeSetTy& stores = ctxPAG->getEdgeSet(PAGEdge::Store);
-    for (CtxPAGEdge<Ctx> *edge : stores) {
-        addStoreCGEdge(edge->getSrcID(),edge->getDstID());
-    }
-
-    typename CtxPAGEdge<Ctx>::PAGEdgeSetTy& loads = ctxPAG->getEdgeSet(PAGEdge::Load);
-    for (CtxPAGEdge<Ctx> *edge : loads) {
-        addLoadCGEdge(edge->getSrcID(),edge->getDstID());
+    const PAGEdge::PEDGEK kinds[] = {PAGEdge::Addr, PAGEdge::Copy, PAGEdge::Call, PAGEdge::Ret,
+                                     PAGEdge::ThreadFork, PAGEdge::ThreadJoin, PAGEdge::NormalGep,
+                                     PAGEdge::VariantGep, PAGEdge::Store, PAGEdge::Load};
+    for (PAGEdge::PEDGEK kind : kinds) {
+        for (CtxPAGEdge<Ctx> *edge : ctxPAG->getEdgeSet(kind)) {
+            addCGEdge(edge);
+        }
     }
 }
 
+/// The constraint graph of the origin-sensitive PAG.
+/// These only name the instantiation, there are no origin-specific nodes or edges yet:
+/// fork/join edges are copies between clones of different origins like any other copy.
+//@{
+class OriginID;
+typedef CtxConstraintNode<OriginID> OriginConsNode;
+typedef CtxConstraintEdge<OriginID> OriginConsEdge;
+typedef CtxConstraintGraph<OriginID> OriginConstraintGraph;
+//@}
+
 #endif //SVF_ORIGIN_CTXCONSG_H
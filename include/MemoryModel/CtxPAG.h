@@ -8,6 +8,7 @@
 #include "MemoryModel/CtxPAGNode.h"
 #include "MemoryModel/CtxPAGEdge.h"
 #include "MemoryModel/PAG.h"
+#include "MemoryModel/CtxSelection.h"
 
 /*!
  * Program Assignment Graph for pointer analysis
@@ -17,13 +18,14 @@ template<class Ctx>
 class CtxPAG : public GenericGraph<CtxPAGNode<Ctx>,CtxPAGEdge<Ctx>> {
 
 protected:
-    typedef std::pair<NodeID, Ctx> CtxInSensID;
-    typedef std::map<CtxInSensID, NodeID> CtxInSensToSensIDMap;
+    // contexts are keyed by their dense 32-bit ID (Ctx::getID), no context object is compared on lookups
+    typedef std::pair<NodeID, u32_t> CtxInSensID;
+    typedef llvm::DenseMap<CtxInSensID, NodeID> CtxInSensToSensIDMap;
 
     typedef std::set<NodeID> CtxSenIDs;
     typedef std::map<NodeID, CtxSenIDs> CtxInSensToSensIDSetMap;
 
-    typedef std::tuple<NodeID, Ctx, LocationSet> NodeLocationSet;
+    typedef std::tuple<NodeID, u32_t, LocationSet> NodeLocationSet;
     typedef std::map<NodeLocationSet,NodeID> NodeLocationSetMap;
 
 protected:
@@ -37,10 +39,35 @@ protected:
     u64_t objNodeNum;
     u64_t ptrNodeNum;
 
+    /// Clones added after initFromPAG (cloning of reachable instances, resolved indirect calls, fields)
+    /// are recorded until the constraint graph takes them
+    //@{
+    bool cloneReachable;
+    bool initialized;
+    std::vector<NodeID> newNodes;
+    std::vector<CtxPAGEdge<Ctx> *> newEdges;
+    //@}
+
+    const CtxSelection *selection;  ///< functions and objects with contexts, all of them if null
+
+    /// Call/ret edges of indirect calls resolved while solving which the PAG does not have.
+    /// They are owned here, the PAG is shared with the other analyses and stays as built.
+    typedef std::tuple<PAGEdge::PEDGEK, NodeID, NodeID, const llvm::Instruction *> InterEdgeKey;
+    std::map<InterEdgeKey, PAGEdge *> resolvedInterEdges;
+
+    static inline CtxInSensID getCtxInSensID(NodeID id, const Ctx &ctx) {
+        return std::make_pair(id, ctx.getID());
+    }
+
     typename CtxPAGEdge<Ctx>::PAGKindToEdgeSetMapTy PAGEdgeKindToSetMap;  // < PAG edge map
 public:
     static CtxPAG<Ctx> *ctxPAG;
-    CtxPAG() : pag(nullptr), totalNodeNum(0), objNodeNum(0), ptrNodeNum(0) {}
+    CtxPAG() : pag(nullptr), totalNodeNum(0), objNodeNum(0), ptrNodeNum(0), cloneReachable(false), initialized(false), selection(nullptr) {}
+    ~CtxPAG() override {
+        for (auto &entry : resolvedInterEdges) {
+            delete entry.second;
+        }
+    }
 
     //virtual void initFromPAG(PAG *) = 0;
     u64_t inline getObjNodeNum() {
@@ -60,6 +87,35 @@ public:
         return ctxPAG;
     }
 
+    /// Selective context sensitivity, to be set before initFromPAG
+    inline void setSelection(const CtxSelection *selection) {
+        this->selection = selection;
+    }
+
+    /// Cloning of the reachable function instances only
+    //@{
+    inline bool isCloningReachable() const {
+        return cloneReachable;
+    }
+
+    /// Clone the function instances reached since the last call, return false if there was none
+    virtual bool cloneReachedInstances() {
+        return false;
+    }
+
+    /// Connect the clones of an indirect call site in callerCtx to a callee resolved while solving,
+    /// return false if they were connected already
+    virtual bool connectIndirectCall(llvm::CallSite cs, const llvm::Function *callee, const Ctx &callerCtx) = 0;
+
+    /// Hand over the nodes and edges added since the last call
+    void takeNewElements(std::vector<NodeID> &nodes, std::vector<CtxPAGEdge<Ctx> *> &edges) {
+        nodes.clear();
+        edges.clear();
+        nodes.swap(newNodes);
+        edges.swap(newEdges);
+    }
+    //@}
+
     inline bool isBlkPtr(NodeID id) const {
         return (SymbolTableInfo::isBlkPtr(id));
     }
@@ -100,7 +156,7 @@ public:
 
     inline NodeID getBaseObjNode(NodeID id) const {
         CtxPAGNode<Ctx>* node = this->getCtxPAGNode(id);
-        auto iter = inSensToSensIDMap.find(std::make_pair(getBaseObj(id)->getSymId(), node->getContext()));
+        auto iter = inSensToSensIDMap.find(getCtxInSensID(getBaseObj(id)->getSymId(), node->getContext()));
         assert(iter != inSensToSensIDMap.end());
         return iter->second;
     }
@@ -113,14 +169,14 @@ public:
     }
 
     inline NodeID getObjectNode(const MemObj* obj, Ctx ctx) const {
-        auto iter = inSensToSensIDMap.find(std::make_pair(obj->getSymId(), ctx));
+        auto iter = inSensToSensIDMap.find(getCtxInSensID(obj->getSymId(), ctx));
         assert(iter != inSensToSensIDMap.end());
 
         return iter->second;
     }
 
     inline NodeID getFIObjNode(const MemObj* obj, Ctx ctx) const {
-        auto iter = inSensToSensIDMap.find(std::make_pair(obj->getSymId(), ctx));
+        auto iter = inSensToSensIDMap.find(getCtxInSensID(obj->getSymId(), ctx));
         assert(iter != inSensToSensIDMap.end());
 
         return iter->second;
@@ -208,18 +264,21 @@ public:
 
         assert(ctxNode);
         // must be adding a new node
-        if (inSensToSensIDMap.find(std::make_pair(node->getId(), ctx)) != inSensToSensIDMap.end()) {
+        if (inSensToSensIDMap.find(getCtxInSensID(node->getId(), ctx)) != inSensToSensIDMap.end()) {
             return;
         }
 
-        inSensToSensIDMap[std::make_pair(node->getId(), ctx)] = id;
+        inSensToSensIDMap[getCtxInSensID(node->getId(), ctx)] = id;
         inSensToSensSetMap[node->getId()].insert(id);
 
         if (llvm::isa<CtxGepObjPN<Ctx>>(ctxNode)) {
             auto *gepObj = llvm::dyn_cast<CtxGepObjPN<Ctx>>(ctxNode);
-            gepObjNodeMap[std::make_tuple(gepObj->getMemObj()->getSymId(), ctx, gepObj->getLocationSet())] = gepObj->getId();
+            gepObjNodeMap[std::make_tuple(gepObj->getMemObj()->getSymId(), ctx.getID(), gepObj->getLocationSet())] = gepObj->getId();
         }
         this->addGNode(id, ctxNode);
+        if (initialized) {
+            newNodes.push_back(id);
+        }
     }
 
     NodeID getGepObjNode(const MemObj* obj, Ctx ctx, const LocationSet& ls) {
@@ -231,10 +290,15 @@ public:
 
         LocationSet newLS = SymbolTableInfo::Symbolnfo()->getModulusOffset(obj->getTypeInfo(),ls);
 
-        auto iter = gepObjNodeMap.find(std::make_tuple(obj->getSymId(), ctx, newLS));
+        auto iter = gepObjNodeMap.find(std::make_tuple(obj->getSymId(), ctx.getID(), newLS));
+        if (iter != gepObjNodeMap.end()) {
+            return iter->second;
+        }
 
-        assert(iter != gepObjNodeMap.end());
-        return iter->second;
+        // a field no insensitive analysis has accessed yet, create it in the context of its base
+        PAGNode *gepNode = pag->getPAGNode(pag->getGepObjNode(obj, newLS));
+        addNodeInCtx(gepNode, ctx);
+        return gepObjNodeMap[std::make_tuple(obj->getSymId(), ctx.getID(), newLS)];
     }
 
 
@@ -268,6 +332,9 @@ public:
         bool added = PAGEdgeKindToSetMap[edge->getEdgeKind()].insert(edge).second;
         this->incEdgeNum();
         assert(added && "duplicated edge, not added!!!");
+        if (initialized) {
+            newEdges.push_back(edge);
+        }
 
         return true;
     }
@@ -314,7 +381,7 @@ public:
 
         for (NodeID ctxSrcID : ctxSrcIDs) {
             CtxPAGNode<Ctx> *ctxSrcNode = this->getGNode(ctxSrcID);
-            auto destNode = inSensToSensIDMap.find(std::make_pair(dest, ctxSrcNode->getContext()));
+            auto destNode = inSensToSensIDMap.find(getCtxInSensID(dest, ctxSrcNode->getContext()));
 
             // we should have the corresponding node in the same context
             assert(destNode != inSensToSensIDMap.end());
@@ -330,13 +397,47 @@ public:
         }
     }
 
+    template <typename EdgeType>
+    void cloneIntraEdgeOfType(PAGEdge *pagEdge, CtxPAGNode<Ctx> *src, CtxPAGNode<Ctx> *dst) {
+        if (!hasIntraEdge(src, dst, EdgeType::TYPE)) {
+            addEdge(src, dst, new EdgeType(src, dst, pagEdge));
+        }
+    }
+
+    /// Clone an intra-procedural edge between two given clones
+    void cloneIntraEdge(PAGEdge *pagEdge, CtxPAGNode<Ctx> *src, CtxPAGNode<Ctx> *dst) {
+        switch (pagEdge->getEdgeKind()) {
+            case PAGEdge::Addr:
+                cloneIntraEdgeOfType<CtxAddrPE<Ctx>>(pagEdge, src, dst);
+                break;
+            case PAGEdge::Copy:
+                cloneIntraEdgeOfType<CtxCopyPE<Ctx>>(pagEdge, src, dst);
+                break;
+            case PAGEdge::Load:
+                cloneIntraEdgeOfType<CtxLoadPE<Ctx>>(pagEdge, src, dst);
+                break;
+            case PAGEdge::Store:
+                cloneIntraEdgeOfType<CtxStorePE<Ctx>>(pagEdge, src, dst);
+                break;
+            case PAGEdge::VariantGep:
+                cloneIntraEdgeOfType<CtxVariantGepPE<Ctx>>(pagEdge, src, dst);
+                break;
+            case PAGEdge::NormalGep:
+                cloneIntraEdgeOfType<CtxNormalGepPE<Ctx>>(pagEdge, src, dst);
+                break;
+            default:
+                assert(false && "not an intra-procedural edge");
+        }
+    }
+
     // The following two kinds of edges requires Context Switch (e.g., call into a different origins)
     virtual void dupCtxCallEdge(CallPE *callEdge) = 0;
     virtual void dupCtxRetEdge(RetPE *retEdge) = 0;
 
-    // TODO: handle it later
-    void dupCtxForkEdge(NodeID src, NodeID dest) {}
-    void dupCtxJoinEdge(NodeID src, NodeID dest) {}
+    // Fork/join edges switch into/out of the context of the thread, they are only cloned by
+    // the PAGs whose contexts follow threads (origins)
+    virtual void dupCtxForkEdge(TDForkPE *forkEdge) {}
+    virtual void dupCtxJoinEdge(TDJoinPE *joinEdge) {}
 
     void addIntraEdges() {
         PAGEdge::PAGEdgeSetTy& addrs = pag->getEdgeSet(PAGEdge::Addr);
@@ -385,12 +486,12 @@ public:
         // Fork/Join
         PAGEdge::PAGEdgeSetTy& tdfks = pag->getEdgeSet(PAGEdge::ThreadFork);
         for (auto edge : tdfks) {
-            dupCtxForkEdge(edge->getSrcID(),edge->getDstID());
+            dupCtxForkEdge(llvm::dyn_cast<TDForkPE>(edge));
         }
 
         PAGEdge::PAGEdgeSetTy& tdjns = pag->getEdgeSet(PAGEdge::ThreadJoin);
         for (auto edge : tdjns) {
-            dupCtxJoinEdge(edge->getSrcID(),edge->getDstID());
+            dupCtxJoinEdge(llvm::dyn_cast<TDJoinPE>(edge));
         }
     }
 
@@ -408,12 +509,116 @@ public:
 
         // add edges
         addEdges();
+
+        // everything so far is taken by the constraint graph as a whole
+        initialized = true;
     }
 
     // getters and setters
     CtxPAGNode<Ctx> *getCtxPAGNode(NodeID id) const {
         return this->getGNode(id);
     }
+
+    /// All clones of an insensitive node
+    inline const CtxSenIDs &getCtxSenIDs(NodeID id) {
+        return inSensToSensSetMap[id];
+    }
+
+    inline bool hasCtxNode(NodeID id, const Ctx &ctx) const {
+        return inSensToSensIDMap.find(getCtxInSensID(id, ctx)) != inSensToSensIDMap.end();
+    }
+
+    inline CtxPAGNode<Ctx> *getCtxNode(NodeID id, const Ctx &ctx) const {
+        auto iter = inSensToSensIDMap.find(getCtxInSensID(id, ctx));
+        assert(iter != inSensToSensIDMap.end() && "node not cloned in the context");
+        return this->getGNode(iter->second);
+    }
+
+protected:
+    /// The insensitive call/ret edge of an indirect call resolved on the fly: the one of the PAG if it exists,
+    /// otherwise one made on first use and owned by this graph, the shared PAG is not changed
+    PAGEdge *getOrAddInterEdge(PAGEdge::PEDGEK kind, NodeID src, NodeID dst, const llvm::Instruction *cs) {
+        for (PAGEdge *edge : pag->getPAGNode(src)->getOutgoingEdges(kind)) {
+            if (edge->getDstID() != dst) {
+                continue;
+            }
+            if (auto *callEdge = llvm::dyn_cast<CallPE>(edge)) {
+                if (callEdge->getCallInst() == cs) {
+                    return edge;
+                }
+            } else if (llvm::cast<RetPE>(edge)->getCallInst() == cs) {
+                return edge;
+            }
+        }
+
+        PAGEdge *&edge = resolvedInterEdges[std::make_tuple(kind, src, dst, cs)];
+        if (edge == nullptr) {
+            PAGNode *srcNode = pag->getPAGNode(src);
+            PAGNode *dstNode = pag->getPAGNode(dst);
+            if (kind == PAGEdge::Call) {
+                edge = new CallPE(srcNode, dstNode, cs);
+            } else {
+                edge = new RetPE(srcNode, dstNode, cs);
+            }
+        }
+        return edge;
+    }
+
+    /// Insensitive call/ret edges between an indirect call site and its callee, as Andersen connects them
+    void getIndirectCallEdges(llvm::CallSite cs, const llvm::Function *callee, std::vector<PAGEdge *> &edges) {
+        const llvm::Instruction *inst = cs.getInstruction();
+
+        if (pag->funHasRet(callee) && pag->callsiteHasRet(cs)) {
+            const PAGNode *csRet = pag->getCallSiteRet(cs);
+            const PAGNode *funRet = pag->getFunRet(callee);
+            if (csRet->isPointer() && funRet->isPointer()) {
+                edges.push_back(getOrAddInterEdge(PAGEdge::Ret, funRet->getId(), csRet->getId(), inst));
+            }
+        }
+
+        if (!pag->hasCallSiteArgsMap(cs) || !pag->hasFunArgsMap(callee)) {
+            return;
+        }
+
+        const PAG::PAGNodeList &csArgList = pag->getCallSiteArgsList(cs);
+        const PAG::PAGNodeList &funArgList = pag->getFunArgsList(callee);
+        auto csArgIt = csArgList.begin(), csArgEit = csArgList.end();
+        for (auto funArgIt = funArgList.begin(); funArgIt != funArgList.end(); ++funArgIt, ++csArgIt) {
+            //Some programs (e.g. Linux kernel) leave unneeded parameters empty.
+            if (csArgIt == csArgEit) {
+                return;
+            }
+            if ((*csArgIt)->isPointer() && (*funArgIt)->isPointer()) {
+                edges.push_back(getOrAddInterEdge(PAGEdge::Call, (*csArgIt)->getId(), (*funArgIt)->getId(), inst));
+            }
+        }
+
+        //Any remaining actual args must be varargs.
+        if (callee->isVarArg()) {
+            NodeID vaF = pag->getVarargNode(callee);
+            for (; csArgIt != csArgEit; ++csArgIt) {
+                if ((*csArgIt)->isPointer()) {
+                    edges.push_back(getOrAddInterEdge(PAGEdge::Call, (*csArgIt)->getId(), vaF, inst));
+                }
+            }
+        }
+    }
+
+    /// Clone a call/ret edge between two given clones, return false if it exists
+    bool cloneInterEdge(PAGEdge *pagEdge, CtxPAGNode<Ctx> *src, CtxPAGNode<Ctx> *dst) {
+        if (auto *callEdge = llvm::dyn_cast<CallPE>(pagEdge)) {
+            if (hasInterEdge(src, dst, PAGEdge::Call, callEdge->getCallInst())) {
+                return false;
+            }
+            return addEdge(src, dst, new CtxCallPE<Ctx>(src, dst, callEdge));
+        }
+
+        auto *retEdge = llvm::cast<RetPE>(pagEdge);
+        if (hasInterEdge(src, dst, PAGEdge::Ret, retEdge->getCallInst())) {
+            return false;
+        }
+        return addEdge(src, dst, new CtxRetPE<Ctx>(src, dst, retEdge));
+    }
 };
 
 
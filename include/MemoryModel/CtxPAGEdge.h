@@ -393,6 +393,11 @@ public:
         return edge->getEdgeKind() == PAGEdge::ThreadFork;
     }
 
+    CtxTDForkPE(CtxPAGNode<Cond>* s, CtxPAGNode<Cond>* d, TDForkPE *forkPE) :
+            CtxPAGEdge<Cond>(s,d, forkPE->getUnmaskedFlag()), inst(forkPE->getCallInst()) {
+
+    }
+
     /// Get method for the instruction at the fork site
     inline const llvm::Instruction* getCallInst() const {
         return inst;
@@ -424,6 +429,11 @@ public:
         return edge->getEdgeKind() == PAGEdge::ThreadJoin;
     }
 
+    CtxTDJoinPE(CtxPAGNode<Cond>* s, CtxPAGNode<Cond>* d, TDJoinPE *joinPE) :
+            CtxPAGEdge<Cond>(s,d, joinPE->getUnmaskedFlag()), inst(joinPE->getCallInst()) {
+
+    }
+
     /// Get method for the instruction at the join site
     inline const llvm::Instruction* getCallInst() const {
         return inst;
@@ -39,7 +39,7 @@ public:
     }
 
     NodeID getInnerID() {
-        this->pagNode->getId();
+        return this->pagNode->getId();
     }
 
     PAGNode *getInnerNode() const{
@@ -48,18 +48,18 @@ public:
 
     /// Get name of the LLVM value
     virtual const std::string getValueName() {
-        this->pagNode->getValueName();
+        return this->pagNode->getValueName();
     }
 
     /// Get/has methods of the components
     /// Delegate to inner PagNode
     inline const llvm::Value* getValue() const {
-        this->pagNode->getValue();
+        return this->pagNode->getValue();
     }
 
     /// Return type of the value
     inline virtual const llvm::Type* getType() const{
-        this->pagNode->getType();
+        return this->pagNode->getType();
     }
 
     inline bool hasValue() const {
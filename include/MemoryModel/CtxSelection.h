@@ -0,0 +1,96 @@
+//===- CtxSelection.h -- Selective context sensitivity------------------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SVF_ORIGIN_CTXSELECTION_H
+#define SVF_ORIGIN_CTXSELECTION_H
+
+#include "Util/BasicTypes.h"
+
+#include <llvm/IR/Function.h>
+
+#include <map>
+#include <string>
+
+class MemObj;
+class PAGNode;
+class PointerAnalysis;
+
+/*!
+ * Selective context sensitivity (in the style of introspective analysis).
+ * A cost model over a context-insensitive pre-analysis decides which functions and which objects get contexts,
+ * everything else has a single clone without context.
+ *  - function f: cost(f) = fanIn(f) * (ptsVolume(f) + sum of pointedBy(o) of the heap objects o allocated in f),
+ *    i.e. the points-to work added by one more context of f, f stays insensitive if the cost is too high.
+ *  - object o (allocated in a context-sensitive function): o stays insensitive if it is pointed by too many pointers,
+ *    widely shared objects gain little from being cloned.
+ */
+class CtxSelection {
+public:
+    struct FuncCost {
+        u32_t fanIn = 0;            ///< call sites calling the function
+        u32_t numOfNodes = 0;       ///< PAG nodes local to the function
+        u32_t numOfHeapObjs = 0;    ///< heap objects allocated in the function
+        u64_t ptsVolume = 0;        ///< total points-to size of the local pointers
+        u64_t heapPointedBy = 0;    ///< total pointedBy of the heap objects
+        u64_t cost = 0;
+        bool sensitive = true;
+    };
+
+    struct ObjCost {
+        u32_t pointedBy = 0;        ///< pointers which may point to the object
+        bool sensitive = true;
+    };
+
+private:
+    typedef std::map<const llvm::Function *, FuncCost> FuncToCostMap;
+    typedef std::map<const MemObj *, ObjCost> ObjToCostMap;
+
+    PointerAnalysis *pta;
+    FuncToCostMap funcCosts;
+    ObjToCostMap objCosts;
+    u32_t numOfInsensitiveFuncs;
+    u32_t numOfInsensitiveObjs;
+
+    void computeCosts();
+    void dump(const std::string &fileName) const;
+
+public:
+    /// pta is a solved context-insensitive analysis
+    explicit CtxSelection(PointerAnalysis *pta) : pta(pta), numOfInsensitiveFuncs(0), numOfInsensitiveObjs(0) {}
+
+    /// Decide the functions and objects with contexts, and dump the decisions if asked to
+    void select();
+
+    bool isCtxSensitive(const llvm::Function *func) const;
+    bool isCtxSensitive(const MemObj *obj) const;
+    /// Whether a node local to func is cloned per context of func
+    bool isCtxSensitive(const PAGNode *node, const llvm::Function *func) const;
+
+    inline u32_t getNumOfInsensitiveFuncs() const {
+        return numOfInsensitiveFuncs;
+    }
+    inline u32_t getNumOfInsensitiveObjs() const {
+        return numOfInsensitiveObjs;
+    }
+};
+
+#endif //SVF_ORIGIN_CTXSELECTION_H
@@ -58,17 +58,54 @@ private:
     SVFModule &module;
     PTACallGraph *callGraph; // pre-built call graph
     FuncToOriginsMap funcToOrigins;
+    std::vector<const llvm::Function *> originEntries;  ///< entry function of origin i + 1 (0 is the default origin)
 
 private:
-    void markOrigin(llvm::Function*, u32_t);
+    void addOriginEntry(const llvm::Function *func);
+    void collectOriginEntries();
     void markFuncOrigins();
 
+    Origins getNodeOrigins(PAGNode *node, const llvm::Function *func);
     void addNodeInOrigins(PAGNode *node, Origins &origins);
 
     void addNodes() override;
 
     std::set<uint32_t> commonOrigins(const CtxPAG<OriginID>::CtxSenIDs&, const CtxPAG<OriginID>::CtxSenIDs&);
 
+    /// Clone an inter-procedural edge in every origin both ends are in, or, if they share no origin,
+    /// from every clone of the source to every clone of the destination (origin switch)
+    template <typename EdgeType, typename PAGEdgeType>
+    void dupInterEdge(PAGEdgeType *pagEdge) {
+        assert(pagEdge);
+        NodeID src = pagEdge->getSrcID();
+        NodeID dest = pagEdge->getDstID();
+        const auto &ctxSrcIDs = inSensToSensSetMap[src];
+        const auto &ctxDestIDs = inSensToSensSetMap[dest];
+
+        auto commonSet = commonOrigins(ctxSrcIDs, ctxDestIDs);
+        if (commonSet.empty()) {
+            // origin switch
+            for (NodeID srcID : ctxSrcIDs) {
+                for (NodeID destID : ctxDestIDs) {
+                    auto *srcNode = getGNode(srcID);
+                    auto *destNode = getGNode(destID);
+                    addEdge(srcNode, destNode, new EdgeType(srcNode, destNode, pagEdge));
+                }
+            }
+        } else {
+            //invoke in the same origin
+            for (OriginID id : commonSet) {
+                auto srcIt = inSensToSensIDMap.find(getCtxInSensID(src, id));
+                auto destIt = inSensToSensIDMap.find(getCtxInSensID(dest, id));
+                assert(srcIt != inSensToSensIDMap.end() && destIt != inSensToSensIDMap.end());
+
+                auto *srcNode = getGNode((*srcIt).second);
+                auto *destNode = getGNode((*destIt).second);
+                addEdge(srcNode, destNode, new EdgeType(srcNode, destNode, pagEdge));
+            }
+        }
+    }
+
 public:
     OriginPAG(SVFModule &module, PTACallGraph *callGraph) : CtxPAG<OriginID>(), module(module), callGraph(callGraph) {
         // TODO: not a good practice!! change it to singleton pattern later!
@@ -76,11 +113,28 @@ public:
         markFuncOrigins();
     }
 
+    inline u32_t getNumOfOrigins() const {
+        return originEntries.size() + 1;
+    }
+    /// Entry function of an origin, nullptr for the default origin
+    inline const llvm::Function *getOriginEntry(u32_t origin) const {
+        return origin == 0 ? nullptr : originEntries[origin - 1];
+    }
+    /// Origin of an entry function, the default origin if func is not an origin entry
+    inline u32_t getOriginOfEntry(const llvm::Function *func) const {
+        auto it = std::find(originEntries.begin(), originEntries.end(), func);
+        return it == originEntries.end() ? 0 : it - originEntries.begin() + 1;
+    }
+
     std::string getGraphName() override;
     void dump(std::string name) override;
 
     void dupCtxCallEdge(CallPE *callEdge) override;
     void dupCtxRetEdge(RetPE *retEdge) override;
+    void dupCtxForkEdge(TDForkPE *forkEdge) override;
+    void dupCtxJoinEdge(TDJoinPE *joinEdge) override;
+
+    bool connectIndirectCall(llvm::CallSite cs, const llvm::Function *callee, const OriginID &callerCtx) override;
 };
 
 namespace llvm {
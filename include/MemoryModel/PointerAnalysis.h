@@ -66,6 +66,7 @@ public:
         CSSummary_WPA,		///< Summary based context sensitive WPA
         FSDATAFLOW_WPA,	///< Traditional Dataflow-based flow sensitive WPA
         FSSPARSE_WPA,		///< Sparse flow sensitive WPA
+        VFS_WPA,		///< Versioned sparse flow sensitive WPA
         FSCS_WPA,			///< Flow-, context- sensitive WPA
         FSCSPS_WPA,		///< Flow-, context-, path- sensitive WPA
         ADAPTFSCS_WPA,		///< Adaptive Flow-, context-, sensitive WPA
@@ -231,10 +232,10 @@ public:
 
     /// Determine whether a points-to contains a black hole or constant node
     //@{
-    inline bool containBlackHoleNode(PointsTo& pts) {
+    inline bool containBlackHoleNode(const PointsTo& pts) {
         return pts.test(pag->getBlackHoleNode());
     }
-    inline bool containConstantNode(PointsTo& pts) {
+    inline bool containConstantNode(const PointsTo& pts) {
         return pts.test(pag->getConstantNode());
     }
     inline bool isBlkObjOrConstantObj(NodeID ptd) const {
@@ -426,10 +427,10 @@ public:
     /// Get points-to and reverse points-to
     ///@{
     virtual inline PointsTo& getPts(NodeID id) {
-        return ptD->getPts(id);
+        return getPTDataTy()->getPts(id);
     }
     virtual inline PointsTo& getRevPts(NodeID nodeId) {
-        return ptD->getRevPts(nodeId);
+        return getPTDataTy()->getRevPts(nodeId);
     }
     //@}
 
@@ -452,6 +453,7 @@ protected:
 
     /// Get points-to data structure
     inline PTDataTy* getPTDataTy() const {
+        assert(ptD && "no points-to data, kept by the subclass?");
         return ptD;
     }
     inline DiffPTDataTy* getDiffPTDataTy() const {
@@ -465,19 +467,19 @@ protected:
     /// To be noted that adding reverse pts might incur 10% total overhead during solving
     //@{
     virtual inline bool unionPts(NodeID id, const PointsTo& target) {
-        return ptD->unionPts(id, target);
+        return getPTDataTy()->unionPts(id, target);
     }
     virtual inline bool unionPts(NodeID id, NodeID ptd) {
-        return ptD->unionPts(id,ptd);
+        return getPTDataTy()->unionPts(id,ptd);
     }
     virtual inline bool addPts(NodeID id, NodeID ptd) {
-        return ptD->addPts(id,ptd);
+        return getPTDataTy()->addPts(id,ptd);
     }
     //@}
 
     /// Clear all data
     virtual inline void clearPts() {
-        ptD->clear();
+        getPTDataTy()->clear();
     }
 
     /// On the fly call graph construction
@@ -505,7 +507,7 @@ public:
     /// dump and debug, print out conditional pts
     //@{
     virtual void dumpCPts() {
-        ptD->dumpPTData();
+        getPTDataTy()->dumpPTData();
     }
 
     virtual void dumpTopLevelPtsTo();
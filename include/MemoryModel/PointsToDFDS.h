@@ -34,10 +34,17 @@
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Support/FileSystem.h>		// for file open flag
 
+#include <algorithm>
+#include <vector>
+
 /*!
  * Data-flow points-to data structure, points-to is maintained for each program point (statement)
  * For address-taken variables, every program point has two sets IN and OUT points-to sets
  * For top-level variables, their points-to sets are maintained in a flow-insensitive manner via getPts(var).
+ *
+ * IN/OUT sets are kept flat per location: the variables of a location are numbered once (initDFVars)
+ * and IN/OUT are arrays indexed by this local number, a variable without a number gets one on its first update.
+ * OUT[loc:var] shares IN[loc:var] while both are equal, IN is copied into OUT only when one of them is about to diverge.
  */
 template<class Key, class Data>
 class DFPTData : public PTData<Key,Data> {
@@ -45,13 +52,26 @@ public:
     typedef NodeID LocID;
     typedef typename PTData<Key,Data>::PtsMap PtsMap;
     typedef typename PTData<Key,Data>::PtsMapConstIter PtsMapConstIter;
-    typedef std::map<LocID, PtsMap> DFPtsMap;	///< Data-flow point-to map
-    typedef typename DFPtsMap::iterator DFPtsMapIter;
-    typedef typename DFPtsMap::const_iterator DFPtsMapconstIter;
     typedef typename PTData<Key,Data>::PTDataTY PTDataTy;
+    typedef std::vector<Key> VarList;
+
+protected:
+    /// IN/OUT sets of one location
+    struct LocPts {
+        VarList vars;                   ///< numbered variables in ascending order, the position is the local number
+        std::vector<Data> in;           ///< IN set of each local number
+        std::vector<Data> out;          ///< OUT set of each local number, empty while it shares IN
+        std::vector<bool> outSharesIn;  ///< whether OUT is the IN set of the same local number
+        bool hasIn = false;
+        bool hasOut = false;
+    };
+    typedef std::vector<LocPts> DFPtsList;
 
-    DFPtsMap dfInPtsMap;	///< Data-flow IN set
-    DFPtsMap dfOutPtsMap;	///< Data-flow OUT set
+    DFPtsList dfPts;	///< Data-flow IN/OUT sets indexed by location
+    const VarList emptyVars;
+    const Data emptyData;
+
+public:
     /// Constructor
     DFPTData(PTDataTy ty = (PTData<Key,Data>::DFPTD)): PTData<Key,Data>(ty) {
     }
@@ -59,51 +79,78 @@ public:
     virtual ~DFPTData() {
     }
 
+    /// Number the variables which may have IN/OUT sets at loc, done once before solving
+    inline void initDFVars(LocID loc, const Data& vars) {
+        LocPts& locPts = getLocPts(loc);
+        if (!locPts.vars.empty()) {
+            for (typename Data::iterator it = vars.begin(), eit = vars.end(); it != eit; ++it)
+                addVar(locPts, *it);
+            return;
+        }
+        locPts.vars.reserve(vars.count());
+        for (typename Data::iterator it = vars.begin(), eit = vars.end(); it != eit; ++it)
+            locPts.vars.push_back(*it);
+        locPts.in.resize(locPts.vars.size());
+        locPts.out.resize(locPts.vars.size());
+        locPts.outSharesIn.resize(locPts.vars.size(), false);
+    }
+
+    /// Make room for the locations below numOfLocs, afterwards updating the IN/OUT sets of distinct
+    /// locations below numOfLocs does not touch any storage shared between them
+    virtual inline void initLocs(LocID numOfLocs) {
+        if (numOfLocs > dfPts.size())
+            dfPts.resize(numOfLocs);
+    }
+
     /// Determine whether the DF IN/OUT sets have ptsMap
     //@{
     inline bool hasDFInSet(LocID loc) const {
-        return (dfInPtsMap.find(loc) != dfInPtsMap.end());
+        return loc < dfPts.size() && dfPts[loc].hasIn;
     }
     inline bool hasDFOutSet(LocID loc) const {
-        return (dfOutPtsMap.find(loc) != dfOutPtsMap.end());
+        return loc < dfPts.size() && dfPts[loc].hasOut;
     }
     inline bool hasDFInSet(LocID loc,const Key& var) const {
-        DFPtsMapconstIter it = dfInPtsMap.find(loc);
-        if ( it == dfInPtsMap.end())
-            return false;
-        const PtsMap& ptsMap = it->second;
-        return (ptsMap.find(var) != ptsMap.end());
+        return hasDFInSet(loc) && findVar(dfPts[loc], var) != NoVar;
     }
     inline bool hasDFOutSet(LocID loc,const Key& var) const {
-        DFPtsMapconstIter it = dfOutPtsMap.find(loc);
-        if ( it == dfOutPtsMap.end())
-            return false;
-        const PtsMap& ptsMap = it->second;
-        return (ptsMap.find(var) != ptsMap.end());
+        return hasDFOutSet(loc) && findVar(dfPts[loc], var) != NoVar;
     }
-    inline const PtsMap& getDFInPtsMap(LocID loc)  {
-        return dfInPtsMap[loc];
+    /// Locations with IN/OUT sets are below getNumOfLocs()
+    inline LocID getNumOfLocs() const {
+        return dfPts.size();
     }
-    inline const PtsMap& getDFOutPtsMap(LocID loc)  {
-        return dfOutPtsMap[loc];
+    /// Numbered variables of loc, IN/OUT of the others are empty
+    inline const VarList& getDFVars(LocID loc) const {
+        return loc < dfPts.size() ? dfPts[loc].vars : emptyVars;
     }
-    inline const DFPtsMap& getDFIn()  {
-        return dfInPtsMap;
+    //@}
+
+    /// Whether IN/OUT[loc:var] may have points-to not propagated yet, always TRUE without incremental updates
+    //@{
+    virtual inline bool hasNewDFInPts(LocID loc, const Key& var) const {
+        return true;
     }
-    inline const DFPtsMap& getDFOut()  {
-        return dfOutPtsMap;
+    virtual inline bool hasNewDFOutPts(LocID loc, const Key& var) const {
+        return true;
     }
     //@}
 
     /// Get points-to from data-flow IN/OUT set
     ///@{
-    inline Data& getDFInPtsSet(LocID loc, const Key& var) {
-        PtsMap& inSet = dfInPtsMap[loc];
-        return inSet[var];
-    }
-    inline Data& getDFOutPtsSet(LocID loc, const Key& var) {
-        PtsMap& outSet = dfOutPtsMap[loc];
-        return outSet[var];
+    inline const Data& getDFInPtsSet(LocID loc, const Key& var) const {
+        if (loc >= dfPts.size())
+            return emptyData;
+        const LocPts& locPts = dfPts[loc];
+        u32_t idx = findVar(locPts, var);
+        return idx == NoVar ? emptyData : locPts.in[idx];
+    }
+    inline const Data& getDFOutPtsSet(LocID loc, const Key& var) const {
+        if (loc >= dfPts.size())
+            return emptyData;
+        const LocPts& locPts = dfPts[loc];
+        u32_t idx = findVar(locPts, var);
+        return idx == NoVar ? emptyData : getOut(locPts, idx);
     }
     ///@}
 
@@ -113,15 +160,26 @@ public:
     //@{
     /// union (IN[dstLoc:dstVar], IN[srcLoc:srcVar])
     virtual inline bool updateDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        return this->unionPts(getDFInPtsSet(dstLoc,dstVar), getDFInPtsSet(srcLoc,srcVar));
+        return unionDFIn(srcLoc, srcVar, false, dstLoc, dstVar);
     }
     /// union (IN[dstLoc:dstVar], OUT[srcLoc:srcVar])
     virtual inline bool updateDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        return this->unionPts(getDFInPtsSet(dstLoc,dstVar), getDFOutPtsSet(srcLoc,srcVar));
+        return unionDFIn(srcLoc, srcVar, true, dstLoc, dstVar);
     }
     /// union (OUT[dstLoc:dstVar], IN[srcLoc:srcVar])
     virtual inline bool updateDFOutFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        return this->unionPts(getDFOutPtsSet(dstLoc,dstVar), getDFInPtsSet(srcLoc,srcVar));
+        if (srcLoc == dstLoc && srcVar == dstVar) {
+            if (srcLoc >= dfPts.size())
+                return false;
+            LocPts& locPts = dfPts[srcLoc];
+            u32_t idx = findVar(locPts, srcVar);
+            return idx != NoVar && unionOutWithIn(locPts, idx);
+        }
+        if (getDFInPtsSet(srcLoc, srcVar).empty())
+            return false;
+        LocPts& dst = getLocPts(dstLoc);
+        u32_t dstIdx = addVar(dst, dstVar);
+        return unionOut(dst, dstIdx, getDFInPtsSet(srcLoc, srcVar));
     }
     /// union (IN[dstLoc::dstVar], OUT[srcLoc:srcVar]. It differs from the above method in that there's
     /// no flag check.
@@ -138,14 +196,12 @@ public:
     {
         bool changed = false;
         if (this->hasDFInSet(loc)) {
-            /// Only variables has new pts from IN set need to be updated.
-            const PtsMap & ptsMap = getDFInPtsMap(loc);
-            for (typename PtsMap::const_iterator ptsIt = ptsMap.begin(), ptsEit = ptsMap.end(); ptsIt != ptsEit; ++ptsIt) {
-                const Key var = ptsIt->first;
+            LocPts& locPts = dfPts[loc];
+            for (u32_t idx = 0; idx < locPts.vars.size(); idx++) {
                 /// Enable strong updates if it is required to do so
-                if (strongUpdates && var == singleton)
+                if (strongUpdates && locPts.vars[idx] == singleton)
                     continue;
-                if (updateDFOutFromIn(loc, var, loc, var))
+                if (unionOutWithIn(locPts, idx))
                     changed = true;
             }
         }
@@ -157,7 +213,9 @@ public:
     }
     /// Update address-taken variables OUT[dstLoc:dstVar] with points-to of top-level pointers
     virtual inline bool updateATVPts(const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        return (this->unionPts(this->getDFOutPtsSet(dstLoc, dstVar), this->getPts(srcVar)));
+        LocPts& dst = getLocPts(dstLoc);
+        u32_t dstIdx = addVar(dst, dstVar);
+        return unionOut(dst, dstIdx, this->getPts(srcVar));
     }
     virtual inline void clearAllDFOutUpdatedVar(LocID loc) {
     }
@@ -192,6 +250,89 @@ protected:
         return dstData |= srcData;
     }
 
+    /// Local numbering of the variables of a location
+    //@{
+    static const u32_t NoVar = ~0U;
+
+    inline LocPts& getLocPts(LocID loc) {
+        if (loc >= dfPts.size())
+            dfPts.resize(loc + 1);
+        return dfPts[loc];
+    }
+    inline u32_t findVar(const LocPts& locPts, const Key& var) const {
+        typename VarList::const_iterator it = std::lower_bound(locPts.vars.begin(), locPts.vars.end(), var);
+        if (it == locPts.vars.end() || *it != var)
+            return NoVar;
+        return it - locPts.vars.begin();
+    }
+    /// Number var at the location if it is not yet, references into the IN/OUT sets of the location are invalidated
+    inline u32_t addVar(LocPts& locPts, const Key& var) {
+        typename VarList::iterator it = std::lower_bound(locPts.vars.begin(), locPts.vars.end(), var);
+        u32_t idx = it - locPts.vars.begin();
+        if (it != locPts.vars.end() && *it == var)
+            return idx;
+        locPts.vars.insert(it, var);
+        locPts.in.insert(locPts.in.begin() + idx, Data());
+        locPts.out.insert(locPts.out.begin() + idx, Data());
+        locPts.outSharesIn.insert(locPts.outSharesIn.begin() + idx, false);
+        return idx;
+    }
+    //@}
+
+    /// IN/OUT of a local number, the shared OUT is copied before IN and OUT diverge
+    //@{
+    inline const Data& getOut(const LocPts& locPts, u32_t idx) const {
+        return locPts.outSharesIn[idx] ? locPts.in[idx] : locPts.out[idx];
+    }
+    inline void unshareOut(LocPts& locPts, u32_t idx) {
+        locPts.out[idx] = locPts.in[idx];
+        locPts.outSharesIn[idx] = false;
+    }
+    /// union (IN[idx], pts)
+    inline bool unionIn(LocPts& locPts, u32_t idx, const Data& pts) {
+        locPts.hasIn = true;
+        if (locPts.outSharesIn[idx]) {
+            if (locPts.in[idx].contains(pts))
+                return false;
+            unshareOut(locPts, idx);
+        }
+        return locPts.in[idx] |= pts;
+    }
+    /// union (OUT[idx], pts)
+    inline bool unionOut(LocPts& locPts, u32_t idx, const Data& pts) {
+        locPts.hasOut = true;
+        if (locPts.outSharesIn[idx]) {
+            if (locPts.in[idx].contains(pts))
+                return false;
+            unshareOut(locPts, idx);
+        }
+        return locPts.out[idx] |= pts;
+    }
+    /// union (OUT[idx], IN[idx]), OUT shares IN from the moment both are equal
+    inline bool unionOutWithIn(LocPts& locPts, u32_t idx) {
+        locPts.hasOut = true;
+        // IN can not have changed since, it would have unshared OUT first
+        if (locPts.outSharesIn[idx])
+            return false;
+        bool changed = (locPts.out[idx] |= locPts.in[idx]);
+        if (locPts.out[idx] == locPts.in[idx]) {
+            locPts.out[idx].clear();
+            locPts.outSharesIn[idx] = true;
+        }
+        return changed;
+    }
+    /// union (IN[dstLoc:dstVar], IN/OUT[srcLoc:srcVar])
+    inline bool unionDFIn(LocID srcLoc, const Key& srcVar, bool fromOut, LocID dstLoc, const Key& dstVar) {
+        const Data& srcPts = fromOut ? getDFOutPtsSet(srcLoc, srcVar) : getDFInPtsSet(srcLoc, srcVar);
+        if (srcPts.empty())
+            return false;
+        // numbering dstVar may move the sets of srcLoc, look the source up again afterwards
+        LocPts& dst = getLocPts(dstLoc);
+        u32_t dstIdx = addVar(dst, dstVar);
+        return unionIn(dst, dstIdx, fromOut ? getDFOutPtsSet(srcLoc, srcVar) : getDFInPtsSet(srcLoc, srcVar));
+    }
+    //@}
+
 public:
     /// Dump the DF IN/OUT set information for debugging purpose
     //@{
@@ -203,24 +344,16 @@ public:
         llvm::ToolOutputFile F("svfg_pts.data", ErrInfo, llvm::sys::fs::F_None);
         if (!ErrInfo) {
             llvm::raw_fd_ostream & osm = F.os();
-            NodeBS locs;
-            for(DFPtsMapconstIter it = dfInPtsMap.begin(), eit = dfInPtsMap.end(); it!=eit; ++it)
-                locs.set(it->first);
-
-            for(DFPtsMapconstIter it = dfOutPtsMap.begin(), eit = dfOutPtsMap.end(); it!=eit; ++it)
-                locs.set(it->first);
-
-            for (NodeBS::iterator it = locs.begin(), eit = locs.end(); it != eit; it++) {
-                LocID loc = *it;
+            for (LocID loc = 0; loc < dfPts.size(); loc++) {
                 if (this->hasDFInSet(loc)) {
                     osm << "Loc:" << loc << " IN:{";
-                    this->dumpPts(this->getDFInPtsMap(loc), osm);
+                    this->dumpDFPts(loc, false, osm);
                     osm << "}\n";
                 }
 
                 if (this->hasDFOutSet(loc)) {
                     osm << "Loc:" << loc << " OUT:{";
-                    this->dumpPts(this->getDFOutPtsMap(loc), osm);
+                    this->dumpDFPts(loc, true, osm);
                     osm << "}\n";
                 }
             }
@@ -246,6 +379,18 @@ public:
             O << "}> ";
         }
     }
+    /// Dump IN or OUT of all the variables at loc
+    inline void dumpDFPts(LocID loc, bool out, llvm::raw_ostream & O = llvm::outs()) const {
+        const LocPts& locPts = dfPts[loc];
+        for (u32_t idx = 0; idx < locPts.vars.size(); idx++) {
+            const Data& pts = out ? getOut(locPts, idx) : locPts.in[idx];
+            if (pts.empty())
+                continue;
+            O << "<" << locPts.vars[idx] << ",{";
+            analysisUtil::dumpSet(pts,O);
+            O << "}> ";
+        }
+    }
     //@}
 
 };
@@ -257,14 +402,12 @@ template<class Key, class Data>
 class IncDFPTData : public DFPTData<Key,Data> {
 public:
     typedef typename DFPTData<Key,Data>::LocID LocID;
-    typedef std::map<LocID, Data> UpdatedVarMap;	///< for propagating only newly added variable in IN/OUT set
-    typedef typename UpdatedVarMap::iterator UpdatedVarMapIter;
-    typedef typename UpdatedVarMap::const_iterator UpdatedVarconstIter;
+    typedef std::vector<Data> UpdatedVarList;	///< for propagating only newly added variable in IN/OUT set, indexed by location
     typedef typename PTData<Key,Data>::PTDataTY PTDataTy;
     typedef typename Data::iterator DataIter;
 private:
-    UpdatedVarMap outUpdatedVarMap;
-    UpdatedVarMap inUpdatedVarMap;
+    UpdatedVarList outUpdatedVars;
+    UpdatedVarList inUpdatedVars;
 
 public:
     /// Constructor
@@ -274,6 +417,25 @@ public:
     virtual ~IncDFPTData() {
     }
 
+    /// Make room for the locations below numOfLocs, including their updated variables
+    virtual inline void initLocs(LocID numOfLocs) {
+        DFPTData<Key,Data>::initLocs(numOfLocs);
+        if (numOfLocs > inUpdatedVars.size())
+            inUpdatedVars.resize(numOfLocs);
+        if (numOfLocs > outUpdatedVars.size())
+            outUpdatedVars.resize(numOfLocs);
+    }
+
+    /// Whether IN/OUT[loc:var] has points-to not propagated yet
+    //@{
+    virtual inline bool hasNewDFInPts(LocID loc, const Key& var) const {
+        return varHasNewDFInPts(loc, var);
+    }
+    virtual inline bool hasNewDFOutPts(LocID loc, const Key& var) const {
+        return varHasNewDFOutPts(loc, var);
+    }
+    //@}
+
     /// Update points-to for IN/OUT set
     /// IN[loc:var] represents the points-to of variable var from IN set of location loc
     /// union(ptsDst,ptsSrc) represents union ptsSrc to ptsDst
@@ -281,7 +443,7 @@ public:
     /// union (IN[dstLoc:dstVar], IN[srcLoc:srcVar])
     inline bool updateDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
         if(varHasNewDFInPts(srcLoc, srcVar) &&
-                this->unionPts(this->getDFInPtsSet(dstLoc,dstVar), this->getDFInPtsSet(srcLoc,srcVar))) {
+                DFPTData<Key,Data>::updateDFInFromIn(srcLoc, srcVar, dstLoc, dstVar)) {
             setVarDFInSetUpdated(dstLoc,dstVar);
             return true;
         }
@@ -290,7 +452,7 @@ public:
     /// union (IN[dstLoc:dstVar], OUT[srcLoc:srcVar])
     inline bool updateDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
         if(varHasNewDFOutPts(srcLoc, srcVar) &&
-                this->unionPts(this->getDFInPtsSet(dstLoc,dstVar), this->getDFOutPtsSet(srcLoc,srcVar))) {
+                DFPTData<Key,Data>::updateDFInFromOut(srcLoc, srcVar, dstLoc, dstVar)) {
             setVarDFInSetUpdated(dstLoc,dstVar);
             return true;
         }
@@ -300,7 +462,7 @@ public:
     inline bool updateDFOutFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
         if(varHasNewDFInPts(srcLoc,srcVar)) {
             removeVarFromDFInUpdatedSet(srcLoc,srcVar);
-            if (this->unionPts(this->getDFOutPtsSet(dstLoc,dstVar), this->getDFInPtsSet(srcLoc,srcVar))) {
+            if (DFPTData<Key,Data>::updateDFOutFromIn(srcLoc, srcVar, dstLoc, dstVar)) {
                 setVarDFOutSetUpdated(dstLoc,dstVar);
                 return true;
             }
@@ -311,7 +473,7 @@ public:
     /// union (IN[dstLoc::dstVar], OUT[srcLoc:srcVar]. It differs from the above method in that there's
     /// no flag check.
     inline bool updateAllDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        if(this->unionPts(this->getDFInPtsSet(dstLoc,dstVar), this->getDFOutPtsSet(srcLoc,srcVar))) {
+        if(DFPTData<Key,Data>::updateDFInFromOut(srcLoc, srcVar, dstLoc, dstVar)) {
             setVarDFInSetUpdated(dstLoc,dstVar);
             return true;
         }
@@ -320,7 +482,7 @@ public:
     /// union (IN[dstLoc::dstVar], IN[srcLoc:srcVar]. It differs from the above method in that there's
     /// no flag check.
     inline bool updateAllDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        if(this->unionPts(this->getDFInPtsSet(dstLoc,dstVar), this->getDFInPtsSet(srcLoc,srcVar))) {
+        if(DFPTData<Key,Data>::updateDFInFromIn(srcLoc, srcVar, dstLoc, dstVar)) {
             setVarDFInSetUpdated(dstLoc,dstVar);
             return true;
         }
@@ -354,7 +516,7 @@ public:
     }
     /// Update address-taken variables OUT[dstLoc:dstVar] with points-to of top-level pointers
     virtual inline bool updateATVPts(const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        if (this->unionPts(this->getDFOutPtsSet(dstLoc, dstVar), this->getPts(srcVar))) {
+        if (DFPTData<Key,Data>::updateATVPts(srcVar, dstLoc, dstVar)) {
             setVarDFOutSetUpdated(dstLoc, dstVar);
             return true;
         }
@@ -377,37 +539,30 @@ public:
     //@}
 
     inline void clearAllDFOutUpdatedVar(LocID loc) {
-        if (this->hasDFOutSet(loc)) {
-            Data pts = getDFOutUpdatedVar(loc);
-            for (DataIter ptsIt = pts.begin(), ptsEit = pts.end(); ptsIt != ptsEit; ++ptsIt) {
-                const Key var = *ptsIt;
-                removeVarFromDFOutUpdatedSet(loc, var);
-            }
-        }
+        if (loc < outUpdatedVars.size())
+            outUpdatedVars[loc].clear();
     }
 private:
     /// Handle address-taken variables whose IN pts changed
     //@{
     /// Add var into loc's IN updated set. Called when var's pts in loc's IN set changed
     inline void setVarDFInSetUpdated(LocID loc,const Key& var) {
-        inUpdatedVarMap[loc].set(var);
+        if (loc >= inUpdatedVars.size())
+            inUpdatedVars.resize(loc + 1);
+        inUpdatedVars[loc].set(var);
     }
     /// Remove var from loc's IN updated set
     inline void removeVarFromDFInUpdatedSet(LocID loc,const Key& var) {
-        UpdatedVarMapIter it = inUpdatedVarMap.find(loc);
-        if (it != inUpdatedVarMap.end())
-            it->second.reset(var);
+        if (loc < inUpdatedVars.size())
+            inUpdatedVars[loc].reset(var);
     }
     /// Return TRUE if var has new pts in loc's IN set
-    inline bool varHasNewDFInPts(LocID loc,const Key& var) {
-        UpdatedVarMapIter it = inUpdatedVarMap.find(loc);
-        if (it != inUpdatedVarMap.end())
-            return it->second.test(var);
-        return false;
+    inline bool varHasNewDFInPts(LocID loc,const Key& var) const {
+        return loc < inUpdatedVars.size() && inUpdatedVars[loc].test(var);
     }
     /// Get all var which have new pts informationin loc's IN set
-    inline const Data& getDFInUpdatedVar(LocID loc) {
-        return inUpdatedVarMap[loc];
+    inline const Data& getDFInUpdatedVar(LocID loc) const {
+        return loc < inUpdatedVars.size() ? inUpdatedVars[loc] : this->emptyData;
     }
     //@}
 
@@ -415,24 +570,22 @@ private:
     //@{
     /// Add var into loc's OUT updated set. Called when var's pts in loc's OUT set changed
     inline void setVarDFOutSetUpdated(LocID loc,const Key& var) {
-        outUpdatedVarMap[loc].set(var);
+        if (loc >= outUpdatedVars.size())
+            outUpdatedVars.resize(loc + 1);
+        outUpdatedVars[loc].set(var);
     }
     /// Remove var from loc's OUT updated set
     inline void removeVarFromDFOutUpdatedSet(LocID loc,const Key& var) {
-        UpdatedVarMapIter it = outUpdatedVarMap.find(loc);
-        if (it != outUpdatedVarMap.end())
-            it->second.reset(var);
+        if (loc < outUpdatedVars.size())
+            outUpdatedVars[loc].reset(var);
     }
     /// Return TRUE if var has new pts in loc's OUT set
-    inline bool varHasNewDFOutPts(LocID loc,const Key& var) {
-        UpdatedVarMapIter it = outUpdatedVarMap.find(loc);
-        if (it != outUpdatedVarMap.end())
-            return it->second.test(var);
-        return false;
+    inline bool varHasNewDFOutPts(LocID loc,const Key& var) const {
+        return loc < outUpdatedVars.size() && outUpdatedVars[loc].test(var);
     }
     /// Get all var which have new pts informationin loc's OUT set
-    inline const Data& getDFOutUpdatedVar(LocID loc) {
-        return outUpdatedVarMap[loc];
+    inline const Data& getDFOutUpdatedVar(LocID loc) const {
+        return loc < outUpdatedVars.size() ? outUpdatedVars[loc] : this->emptyData;
     }
     //@}
 };
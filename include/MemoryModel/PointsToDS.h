@@ -35,6 +35,9 @@
 #include "MemoryModel/ConditionalPT.h"
 #include "Util/AnalysisUtil.h"
 
+#include <llvm/ADT/Hashing.h>
+#include <unordered_map>
+
 /// Overloading operator << for dumping conditional variable
 //@{
 template<class Cond>
@@ -250,4 +253,231 @@ private:
     CahcePtsMap CacheMap;	///< points-to processed at load/store edge
 };
 
+/*!
+ * Diff points-to data whose points-to sets are shared between variables (hash-consed) and copied on write.
+ * Meant for analyses where many variables end up with equal sets, e.g. the clones of one variable in a
+ * context-sensitive analysis.
+ *  - every variable refers to a shared set, a union which changes it makes a new set, or finds an equal
+ *    set already shared by other variables.
+ *  - the points-to already propagated (diff propagation) refer to a shared set too, remembering them costs no copy.
+ * A set no longer referred to is freed by collectGarbage(), so references returned by getPts stay valid until then.
+ * Reverse points-to are not maintained.
+ */
+template<class Key, class Data, class CacheKey>
+class SharedDiffPTData {
+public:
+    typedef u32_t PtsID;    ///< ID of a shared set, 0 is the empty set
+    typedef std::map<const Key, Data> PtsMap;
+    typedef std::map<const CacheKey, Data> CachePtsMap;
+
+private:
+    struct SharedPts {
+        Data pts;
+        size_t hash;
+        u32_t refs;
+    };
+    typedef llvm::DenseMap<Key, PtsID> KeyToPtsIDMap;
+
+    std::deque<SharedPts> sets;     ///< never reallocated, references to the sets stay valid
+    std::unordered_multimap<size_t, PtsID> hashToSets;
+    std::vector<PtsID> freeIDs;
+    std::vector<PtsID> releasedIDs; ///< sets whose last reference was dropped since the last collectGarbage()
+
+    KeyToPtsIDMap ptsMap;
+    KeyToPtsIDMap propaPtsMap;      ///< points-to already propagated
+    PtsMap diffPtsMap;              ///< diff points-to to be propagated
+    CachePtsMap cacheMap;           ///< points-to processed at load/store edge
+
+    static inline size_t hashPts(const Data &pts) {
+        return llvm::hash_combine_range(pts.begin(), pts.end());
+    }
+
+    /// Return the ID of the shared set equal to pts, with one more reference
+    PtsID intern(Data &&pts) {
+        if (pts.empty())
+            return 0;
+
+        size_t hash = hashPts(pts);
+        auto range = hashToSets.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            SharedPts &shared = sets[it->second];
+            if (shared.pts == pts) {
+                shared.refs++;
+                return it->second;
+            }
+        }
+
+        PtsID id;
+        if (freeIDs.empty()) {
+            id = sets.size();
+            sets.push_back(SharedPts{std::move(pts), hash, 1});
+        } else {
+            id = freeIDs.back();
+            freeIDs.pop_back();
+            sets[id] = SharedPts{std::move(pts), hash, 1};
+        }
+        hashToSets.insert(std::make_pair(hash, id));
+        return id;
+    }
+
+    inline void retain(PtsID id) {
+        if (id != 0)
+            sets[id].refs++;
+    }
+    inline void release(PtsID id) {
+        if (id != 0 && --sets[id].refs == 0)
+            releasedIDs.push_back(id);
+    }
+
+    /// Let var refer to the set id, which already carries the reference of var
+    inline void setPtsID(KeyToPtsIDMap &map, const Key &var, PtsID id) {
+        PtsID &cur = map[var];
+        PtsID old = cur;
+        cur = id;
+        release(old);
+    }
+
+public:
+    SharedDiffPTData() {
+        // the empty set
+        sets.push_back(SharedPts{Data(), hashPts(Data()), 1});
+    }
+
+    /// Free the sets which are no longer referred to, references returned before may be invalidated
+    void collectGarbage() {
+        for (PtsID id : releasedIDs) {
+            SharedPts &shared = sets[id];
+            if (shared.refs != 0 || shared.pts.empty())
+                continue;   // referred to again, or collected already
+
+            auto range = hashToSets.equal_range(shared.hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == id) {
+                    hashToSets.erase(it);
+                    break;
+                }
+            }
+            shared.pts.clear();
+            freeIDs.push_back(id);
+        }
+        releasedIDs.clear();
+    }
+
+    void clear() {
+        sets.erase(sets.begin() + 1, sets.end());
+        hashToSets.clear();
+        freeIDs.clear();
+        releasedIDs.clear();
+        ptsMap.clear();
+        propaPtsMap.clear();
+        diffPtsMap.clear();
+        cacheMap.clear();
+    }
+
+    /// Points-to of var, it may be shared and is changed by unionPts/addPts only
+    inline const Data& getPts(const Key &var) const {
+        auto it = ptsMap.find(var);
+        return sets[it == ptsMap.end() ? 0 : it->second].pts;
+    }
+
+    /// Union/add points-to
+    //@{
+    inline bool unionPts(const Key &dstKey, const Data &srcData) {
+        Data pts = getPts(dstKey);
+        if (!(pts |= srcData))
+            return false;
+        setPtsID(ptsMap, dstKey, intern(std::move(pts)));
+        return true;
+    }
+    inline bool unionPts(const Key &dstKey, const Key &srcKey) {
+        PtsID src = ptsMap.lookup(srcKey);
+        PtsID &dst = ptsMap[dstKey];
+        if (src == dst || src == 0)
+            return false;
+        if (dst == 0) {
+            // dst shares src's set
+            retain(src);
+            dst = src;
+            return true;
+        }
+        return unionPts(dstKey, sets[src].pts);
+    }
+    inline bool addPts(const Key &dstKey, const Key &element) {
+        if (getPts(dstKey).test(element))
+            return false;
+        Data pts = getPts(dstKey);
+        pts.set(element);
+        setPtsID(ptsMap, dstKey, intern(std::move(pts)));
+        return true;
+    }
+    //@}
+
+    /// Get diff points to.
+    inline Data & getDiffPts(const Key &var) {
+        return diffPtsMap[var];
+    }
+
+    /**
+     * Compute diff points to. Return TRUE if diff is not empty.
+     * 1. calculate diff by: diff = all - propa;
+     * 2. update propagated pts: propa = all (shared, not copied).
+     */
+    inline bool computeDiffPts(const Key &var) {
+        Data &diff = getDiffPts(var);
+        diff.clear();
+
+        PtsID all = ptsMap.lookup(var);
+        PtsID &propa = propaPtsMap[var];
+        if (all == propa)
+            return false;
+
+        diff.intersectWithComplement(sets[all].pts, sets[propa].pts);
+        retain(all);
+        setPtsID(propaPtsMap, var, all);
+        return (diff.empty() == false);
+    }
+
+    /**
+     * Update dst's propagated points-to set with src's.
+     * The final result is the intersection of these two sets.
+     */
+    inline void updatePropaPtsMap(const Key &src, const Key &dst) {
+        PtsID srcPropa = propaPtsMap.lookup(src);
+        PtsID dstPropa = propaPtsMap.lookup(dst);
+        if (srcPropa == dstPropa)
+            return;
+
+        Data pts = sets[dstPropa].pts;
+        if (pts &= sets[srcPropa].pts)
+            setPtsID(propaPtsMap, dst, intern(std::move(pts)));
+    }
+
+    /// Clear propagated pts
+    inline void clearPropaPts(const Key &var) {
+        setPtsID(propaPtsMap, var, 0);
+    }
+
+    /// Get cached points-to
+    inline Data& getCachePts(const CacheKey &cache) {
+        return cacheMap[cache];
+    }
+
+    /// Statistics
+    //@{
+    /// number of variables with a non-empty points-to set
+    inline u32_t getNumOfVars() const {
+        u32_t num = 0;
+        for (const auto &entry : ptsMap) {
+            if (entry.second != 0)
+                num++;
+        }
+        return num;
+    }
+    /// number of distinct points-to sets in use
+    inline u32_t getNumOfSharedSets() const {
+        return hashToSets.size();
+    }
+    //@}
+};
+
 #endif /* POINTSTO_H_ */
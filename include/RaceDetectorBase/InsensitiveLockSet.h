@@ -24,18 +24,54 @@
 using namespace std;
 using namespace llvm;
 
+/*
+ * Must-lockset analysis, flow-sensitive within a function and context-insensitive across functions.
+ * Locks are interned into alias classes of the lock objects they may point to, so a lockset is a
+ * bitvector of class IDs. The analysis runs over basic blocks in two phases:
+ *  - bottom-up: a lock effect summary of every function (locks it may release, locks it surely holds on return),
+ *    which is applied at its call sites instead of walking into the callee,
+ *  - top-down: the lockset at a function entry is the intersection of the locksets at its call sites
+ *    (empty for main and thread start routines), and the lockset of every read/write is recorded.
+ */
 class InsensitiveLockSet {
 private:
-    using LockSet = set<Value *>;
-    using StmtLockSetMap = map<const Instruction *, LockSet *>;
-    using Func2CallSites =  map<Function *, set<Instruction *>>;
+    using LockID = u32_t;
+    using LockBS = NodeBS;  ///< set of LockIDs
+    using FuncSet = set<Function *>;
 
-    StmtLockSetMap *inLockSetMap;
-    StmtLockSetMap *outLockSetMap;
-    Func2CallSites *func2CallSitesMap;
-    Func2CallSites *func2ReturnMap;
+    struct LockSummary {
+        LockBS mayRelease;  ///< locks which may be released by the function or its callees
+        LockBS mustHold;    ///< locks acquired by the function and held on every return
+    };
+
+    using Lock2IDMap = map<const Value *, LockID>;
+    using FuncSummaryMap = map<const Function *, LockSummary>;
+    using FuncLockSetMap = map<const Function *, LockBS>;
+    using BBLockSetMap = map<const BasicBlock *, LockBS>;
+    using StmtLockSetMap = DenseMap<const Instruction *, LockBS>;
+    using Func2CallSites = map<const Function *, set<Instruction *>>;
+
+    Lock2IDMap lock2IDMap;          ///< lock pointer -> alias class of the lock objects
+    vector<const Value *> id2LockMap;   ///< alias class -> first lock pointer of the class
+    FuncSummaryMap summaryMap;
+    FuncLockSetMap entryLockSetMap;
+    StmtLockSetMap stmtLockSetMap;  ///< locksets of the reads and writes holding at least one lock
+    Func2CallSites func2CallSitesMap;
 
     PointerAnalysis *PTA;
+
+    void internLocks(Module *module);
+    LockID getLockID(const Value *lock);
+
+    void getCallees(Instruction *inst, FuncSet &callees);
+    void buildSummaries(Module *module);
+    void computeEntryLockSets(Module *module);
+
+    /// Lockset transfer of one instruction, call sites apply the callee summaries
+    void transfer(Instruction *inst, LockBS &ls);
+    /// Must-lockset at the entry of every reachable block of func, given the lockset at the function entry
+    void solveFunction(Function *func, const LockBS &entry, BBLockSetMap &inMap);
+
 public:
     // TODO: better place into different file
     static bool isThreadCreate(Instruction *inst);
@@ -47,8 +83,18 @@ public:
     static bool isReadORWrite(Instruction *);
     static bool isExtFunction(Function *);
 
+    /// Whether both reads/writes surely hold a lock of the same alias class
     bool protectedByCommonLock(const Instruction *i1, const Instruction *i2);
 
+    /// Alias classes of the locks surely held at a read/write
+    const NodeBS &getLockSet(const Instruction *inst) const;
+
+    /// A lock pointer of the alias class
+    inline const Value *getLock(u32_t id) const {
+        assert(id < id2LockMap.size() && "unknown lock");
+        return id2LockMap[id];
+    }
+
     InsensitiveLockSet(PointerAnalysis *PTA) : PTA(PTA) {}
 public:
     void analyze(Module *module);
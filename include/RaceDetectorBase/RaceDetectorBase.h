@@ -24,37 +24,92 @@
 #include <llvm/Support/SourceMgr.h> // for SMDiagnostic
 #include <llvm/Bitcode/BitcodeWriterPass.h>		// for createBitcodeWriterPass
 #include "RaceDetectorBase/InsensitiveLockSet.h"
+#include "RaceDetectorBase/TSAState.h"
+#include "RaceDetectorBase/TSAReport.h"
 
 using namespace llvm;
 using namespace std;
 
+class OriginID;
+class OriginSensitive;
+
 class RaceDetectorBase {
+public:
+    /// Pointer analysis the detector runs on, the context-sensitive ones are queried through their projection
+    enum PTAKind {AndersenPTA, OriginPTA, CallSitePTA};
+
 private:
     using AccessSet = set<SHBNode *>;
     using ThreadAccessSetMap = map<Value *, AccessSet>;
+    using FuncThreadsMap = map<const Function *, TSAState::ThreadNameSet>;
+    using FuncSet = set<const Function *>;
+    using NodeLocMap = map<SHBNode *, string>;
+    using SharingMap = map<string, bool>;
+
+    struct VarSharing {
+        string file;
+        bool shared;
+        VarSharing() : shared(false) {}
+    };
+    using VarSharingMap = map<string, VarSharing>;
 
     SHBGraph *shbGraph;
     Module *module;
     PointerAnalysis *PTA;
+    OriginSensitive *originPTA;     ///< PTA if it is origin-sensitive, accesses are then queried in their thread's origin
     InsensitiveLockSet *LS;
     ThreadAccessSetMap threadAccessSetMap;
+    bool debug;
+
+    /// Incremental state
+    //@{
+    bool incremental;
+    TSAState prevState;         ///< state recorded by the previous run
+    TSAState curState;          ///< state of this run, saved for the next one
+    FuncThreadsMap funcThreads; ///< thread start routines a function's accesses are reachable from
+    FuncSet dirtyFuncs;         ///< functions whose accesses need to be re-analyzed
+    NodeLocMap accessLocs;      ///< source location of each access
+    //@}
+
+    /// Results, aggregated per file/function/variable and streamed to the report
+    //@{
+    TSAReport report;
+    SharingMap fileSharing;
+    SharingMap funcSharing;
+    VarSharingMap varSharingMap;
+    //@}
 private:
     void collectAccess();
-    void intraThreadDFS(SHBNode *entry, Value *thread);
+    void collectThreadAccess(const Function *startRoutine, Value *thread);
+    string getThreadName(Value *thread);
+
+    void inputExistingLogs(vector<string> &loggedUnshared, vector<string> &loggedShared);
 
-    void inputExistingLogs();
-    vector<string> split(string s, string splitStr);
+    void computeDirtyFunctions();
+    bool isDirtyAccess(SHBNode *node);
+    const TSAState::AccessRecord *getPrevRecord(SHBNode *node, const string &loc);
+    string getPtsDigest(SHBNode *node);
+    void recordVerdict(SHBNode *node, const string &loc, bool shared);
 
     void detectShared();
 
-    bool checkNodes(SHBNode *n1, SHBNode *n2);
+    bool checkNodes(SHBNode *n1, Value *t1, SHBNode *n2, Value *t2);
+    OriginID getThreadOrigin(Value *thread);
+
+    void recordSharing(SHBNode *node, const string &loc, bool shared);
+    void reportCandidate(SHBNode *n1, Value *t1, SHBNode *n2, Value *t2);
+    TSAReport::Access getReportAccess(SHBNode *node, Value *thread);
+    vector<string> getCommonObjects(SHBNode *n1, Value *t1, SHBNode *n2, Value *t2);
 
     void checkFiles();
     void checkMethods();
     void checkVariables();
 
-    int output(bool sharedOutput,bool outputFiles, bool outputMethods,bool outputVariables);
+    int output(bool outputFiles, bool outputMethods,bool outputVariables);
 public:
-    int runOnModule(SVFModule module, bool sharedOutput,bool outputFiles, bool outputMethods,bool outputVariables);
+    RaceDetectorBase() : shbGraph(nullptr), module(nullptr), PTA(nullptr), originPTA(nullptr), LS(nullptr), debug(false), incremental(false) {}
+
+    int runOnModule(SVFModule module, bool sharedOutput,bool outputFiles, bool outputMethods,bool outputVariables,bool debug,bool incremental,
+                    TSAReport::Format candidates, PTAKind ptaKind, bool dumpGraphs);
 };
 #endif //SVF_ORIGIN_RACEDETECTORBASE_H
@@ -41,33 +41,40 @@ private:
     NodeType nodeTy;
     static u64_t CURRENT_NODE_ID;
     llvm::Instruction *inst;
+    const llvm::Function *func;
 
 private:
-    SHBNode(NodeType ty, NodeID id, llvm::Instruction *inst) : GenericNode<SHBNode, SHBEdge>(id, 0), nodeTy(ty), inst(inst) {}
+    SHBNode(NodeType ty, NodeID id, llvm::Instruction *inst, const llvm::Function *func)
+            : GenericNode<SHBNode, SHBEdge>(id, 0), nodeTy(ty), inst(inst), func(func) {}
 
 public:
     SHBNode() = delete;
 
     static SHBNode * createWriteNode(llvm::Instruction * inst) {
-        return new SHBNode(NodeType::Write, CURRENT_NODE_ID++, inst);
+        return new SHBNode(NodeType::Write, CURRENT_NODE_ID++, inst, inst->getFunction());
     }
 
     static SHBNode * createReadNode(llvm::Instruction * inst) {
-        return new SHBNode(NodeType::Read, CURRENT_NODE_ID++, inst);
+        return new SHBNode(NodeType::Read, CURRENT_NODE_ID++, inst, inst->getFunction());
     }
 
-    static SHBNode * createEnterNode(llvm::Instruction * inst) {
-        return new SHBNode(NodeType::Enter, CURRENT_NODE_ID++, inst);
+    static SHBNode * createEnterNode(const llvm::Function *func) {
+        return new SHBNode(NodeType::Enter, CURRENT_NODE_ID++, nullptr, func);
     }
 
-    static SHBNode * createRetNode(llvm::Instruction * inst) {
-        return new SHBNode(NodeType::Ret, CURRENT_NODE_ID++, inst);
+    static SHBNode * createRetNode(const llvm::Function *func) {
+        return new SHBNode(NodeType::Ret, CURRENT_NODE_ID++, nullptr, func);
     }
 
     const llvm::Instruction *getInst() {
         return this->inst;
     }
 
+    // the function the node belongs to
+    const llvm::Function *getFunction() const {
+        return this->func;
+    }
+
     const llvm::Value *getPointerOperand() {
         if (nodeTy == Write) {
             auto store = llvm::dyn_cast<llvm::StoreInst>(this->getInst());
@@ -87,11 +94,23 @@ public:
     }
 };
 
+/*
+ * Static happens-before graph.
+ * Every function is built once: its read/write nodes are chained by PO edges between its Enter and Ret node.
+ * Call and fork sites are not walked through when querying the graph, they are composed with a bottom-up
+ * summary of the callee instead (see buildSummaries), so a path entering a callee can only leave it through
+ * the call site it entered from, and functions shared by several threads are summarized only once.
+ */
 class SHBGraph : public GenericGraph<SHBNode, SHBEdge> {
+public:
+    using FuncNodesMap = std::map<const llvm::Function *, NodeBS>;
+    using FuncSet = std::set<const llvm::Function *>;
+    using FuncDepMap = std::map<const llvm::Function *, FuncSet>;
+
 private:
     using Inst2NodeMap = std::map<llvm::Instruction *, SHBNode *>;
-    using Func2RetMap = std::map<llvm::Function *, SHBNode *>;
-    using Func2EnterMap = std::map<llvm::Function *, SHBNode *>;
+    using Func2RetMap = std::map<const llvm::Function *, SHBNode *>;
+    using Func2EnterMap = std::map<const llvm::Function *, SHBNode *>;
     using NodeSet = std::set<SHBNode *>;
 
 private:
@@ -102,6 +121,20 @@ private:
     NodeSet writeNodeSet;
     NodeSet readNodeSet;
 
+    /// Intra-procedural part of the summaries
+    //@{
+    FuncNodesMap func2LocalNodesMap;     ///< nodes of the function itself
+    FuncNodesMap func2LocalAccessesMap;  ///< read/write nodes of the function itself
+    FuncDepMap calleeMap;                ///< functions called by a function (direct and resolved indirect calls)
+    FuncDepMap forkMap;                  ///< start routines of the threads forked by a function
+    //@}
+
+    /// Bottom-up summaries, functions in the same call graph SCC share the same sets
+    //@{
+    FuncNodesMap func2AccessesMap;       ///< read/write nodes executed by the same thread when calling the function
+    FuncNodesMap func2ReachMap;          ///< nodes which happen after the function entry, including forked threads
+    //@}
+
     PointerAnalysis *PTA;
 
 private:
@@ -117,6 +150,11 @@ private:
     static void connectForkEdges(llvm::Module *, SHBGraph *, std::set<llvm::Instruction *> *, std::map<llvm::Instruction *, NodeID> *);
     static void connectJoinEdges(llvm::Module *, SHBGraph *, std::set<llvm::Instruction *> *, std::map<llvm::Instruction *, NodeID> *);
 
+    void buildSummaries();
+    static void summarizeBottomUp(const FuncDepMap &deps, const FuncNodesMap &local, FuncNodesMap &summary);
+
+    void getCallees(llvm::Instruction *inst, FuncSet &callees);
+
 public:
     SHBGraph() = delete;
 
@@ -146,18 +184,36 @@ public:
         return iter->second;
     }
 
-    inline SHBNode *getFunctionEnterNode(llvm::Function *func) {
+    inline bool hasFunctionNodes(const llvm::Function *func) const {
+        return func2EnterMap.find(func) != func2EnterMap.end();
+    }
+
+    inline SHBNode *getFunctionEnterNode(const llvm::Function *func) {
         auto iter = func2EnterMap.find(func);
         assert(iter != func2EnterMap.end());
         return iter->second;
     }
 
-    inline SHBNode *getFunctionRetNode(llvm::Function *func) {
+    inline SHBNode *getFunctionRetNode(const llvm::Function *func) {
         auto iter = func2RetMap.find(func);
         assert(iter != func2RetMap.end());
         return iter->second;
     }
 
+    /// Read/write nodes executed by the calling thread when func is called
+    inline const NodeBS &getFunctionAccesses(const llvm::Function *func) const {
+        auto iter = func2AccessesMap.find(func);
+        assert(iter != func2AccessesMap.end());
+        return iter->second;
+    }
+
+    /// Nodes which may happen after the entry of func, on any thread
+    inline const NodeBS &getFunctionReach(const llvm::Function *func) const {
+        auto iter = func2ReachMap.find(func);
+        assert(iter != func2ReachMap.end());
+        return iter->second;
+    }
+
     void addEdge(NodeID src, NodeID dst, SHBEdge::EdgeType ty) {
         SHBNode *srcNode = getGNode(src);
         SHBNode *dstNode = getGNode(dst);
@@ -180,6 +236,8 @@ public:
 
             inst2NodeMap[inst] = node;
             readNodeSet.insert(node);
+            func2LocalNodesMap[node->getFunction()].set(node->getId());
+            func2LocalAccessesMap[node->getFunction()].set(node->getId());
             return node->getId();
         } else {
             // already in the graph
@@ -195,6 +253,8 @@ public:
 
             inst2NodeMap[inst] = node;
             writeNodeSet.insert(node);
+            func2LocalNodesMap[node->getFunction()].set(node->getId());
+            func2LocalAccessesMap[node->getFunction()].set(node->getId());
             return node->getId();
         } else {
             // already in the graph
@@ -202,13 +262,14 @@ public:
         }
     }
 
-    NodeID addEnterNode(llvm::Function *func) {
+    NodeID addEnterNode(const llvm::Function *func) {
         auto iter = func2EnterMap.find(func);
         if (iter == func2EnterMap.end()) {
-            SHBNode *node = SHBNode::createEnterNode(nullptr);
+            SHBNode *node = SHBNode::createEnterNode(func);
             this->addGNode(node->getId(), node);
 
             func2EnterMap[func] = node;
+            func2LocalNodesMap[func].set(node->getId());
             return node->getId();
         } else {
             // already in the graph
@@ -216,13 +277,14 @@ public:
         }
     }
 
-    NodeID addRetNode(llvm::Function *inst) {
-        auto iter = func2RetMap.find(inst);
+    NodeID addRetNode(const llvm::Function *func) {
+        auto iter = func2RetMap.find(func);
         if (iter == func2RetMap.end()) {
-            SHBNode *node = SHBNode::createRetNode(nullptr);
+            SHBNode *node = SHBNode::createRetNode(func);
             this->addGNode(node->getId(), node);
 
-            func2RetMap[inst] = node;
+            func2RetMap[func] = node;
+            func2LocalNodesMap[func].set(node->getId());
             return node->getId();
         } else {
             // already in the graph
@@ -233,7 +295,40 @@ public:
     void dumpDotGraph();
 };
 
+class FuncDepNode;
+typedef GenericEdge<FuncDepNode> FuncDepEdge;
+
+/// A function summarized by SHBGraph::summarizeBottomUp
+class FuncDepNode : public GenericNode<FuncDepNode, FuncDepEdge> {
+private:
+    const llvm::Function *func;
+
+public:
+    FuncDepNode(NodeID id, const llvm::Function *func) : GenericNode<FuncDepNode, FuncDepEdge>(id, 0), func(func) {}
+
+    inline const llvm::Function *getFunction() const {
+        return func;
+    }
+};
+
+/// The functions to summarize, with an edge to every function (callee or start routine) they depend on
+class FuncDepGraph : public GenericGraph<FuncDepNode, FuncDepEdge> {
+public:
+    FuncDepGraph(const SHBGraph::FuncDepMap &deps, const SHBGraph::FuncNodesMap &local);
+};
+
 namespace llvm {
+    template<>
+    struct GraphTraits<FuncDepNode *> : public GraphTraits<GenericNode<FuncDepNode, FuncDepEdge>*> {};
+
+    template<>
+    struct GraphTraits<Inverse<FuncDepNode *>> : public GraphTraits<Inverse<GenericNode<FuncDepNode, FuncDepEdge>*>> {};
+
+    template<>
+    struct GraphTraits<FuncDepGraph *> : public GraphTraits<GenericGraph<FuncDepNode, FuncDepEdge>*> {
+        typedef FuncDepNode* NodeRef;
+    };
+
     /* !
      * GraphTraits specializations of PAG to be used for the generic graph algorithms.
      * Provide graph traits for tranversing from a PAG node using standard graph traversals.
@@ -0,0 +1,101 @@
+//
+// TSAReport.h -- streaming writer for the TSA ignore list and race candidates
+//
+
+#ifndef SVF_ORIGIN_TSAREPORT_H
+#define SVF_ORIGIN_TSAREPORT_H
+
+#include <fstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * Writes results while they are determined instead of collecting them first.
+ *  - Ignore-list entries ("src:", "fun:", "var:") go to one file: the unshared or the potentially shared list.
+ *    Entries of the other kind are only remembered, so that an entry is never reported as both.
+ *  - Race candidates (two accesses of different threads which may touch the same object) can be written
+ *    as JSON lines or CSV for other tools.
+ * Both streams are buffered, only the entries already written are kept in memory (for de-duplication).
+ * They are written to "<path>.tmp" and only replace the files of the previous run once the analysis
+ * finished (commit), so a crashed run leaves the old results in place.
+ */
+class TSAReport {
+public:
+    enum Format {NoCandidates, JSON, CSV};
+
+    struct Access {
+        std::string thread;
+        std::string loc;
+        bool write;
+        std::vector<std::string> locks;
+    };
+
+    struct RaceCandidate {
+        Access first;
+        Access second;
+        std::vector<std::string> objects;   ///< objects both accesses may touch
+    };
+
+private:
+    static const size_t BUFFER_SIZE = 1 << 16;
+
+    std::ofstream ignoreList;
+    std::ofstream candidates;
+    std::string ignoreListPath;
+    std::string candidatesPath;
+    std::vector<char> ignoreListBuf;
+    std::vector<char> candidatesBuf;
+
+    bool sharedOutput;
+    Format format;
+    std::unordered_set<std::string> sharedEntries;
+    std::unordered_set<std::string> unsharedEntries;
+    unsigned numOfNewEntries;
+    unsigned numOfCandidates;
+
+    void writeCandidateJSON(const RaceCandidate &candidate);
+    void writeCandidateCSV(const RaceCandidate &candidate);
+
+public:
+    TSAReport() : sharedOutput(false), format(NoCandidates), numOfNewEntries(0), numOfCandidates(0) {}
+    ~TSAReport() {
+        discard();
+    }
+
+    /// Open the ignore list (and the candidate file unless format is NoCandidates), return false on failure
+    bool open(const std::string &ignoreListPath, bool sharedOutput, Format format, const std::string &candidatesPath);
+    /// Close the files and move them over the given paths, return false on failure
+    bool commit();
+    /// Close the files and remove them, the files of the previous run are kept
+    void discard();
+
+    /// Entries logged by a previous run, they are kept in the new list
+    void addLoggedEntry(const std::string &entry, bool shared);
+
+    /// Whether an entry of either kind was reported already
+    inline bool hasEntry(const std::string &entry) const {
+        return sharedEntries.count(entry) || unsharedEntries.count(entry);
+    }
+    inline bool hasEntry(const std::string &entry, bool shared) const {
+        return shared ? sharedEntries.count(entry) != 0 : unsharedEntries.count(entry) != 0;
+    }
+
+    /// Report an ignore-list entry, return false if it was reported before
+    bool addEntry(const std::string &entry, bool shared);
+
+    /// Whether race candidates are written at all, building them is not free
+    inline bool writesCandidates() const {
+        return format != NoCandidates;
+    }
+    void addCandidate(const RaceCandidate &candidate);
+
+    inline unsigned getNumOfNewEntries() const {
+        return numOfNewEntries;
+    }
+    inline unsigned getNumOfCandidates() const {
+        return numOfCandidates;
+    }
+};
+
+#endif //SVF_ORIGIN_TSAREPORT_H
@@ -0,0 +1,91 @@
+//
+// TSAState.h -- persisted TSA state for incremental runs
+//
+
+#ifndef SVF_ORIGIN_TSASTATE_H
+#define SVF_ORIGIN_TSASTATE_H
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <llvm/IR/Function.h>
+
+/*
+ * Persisted TSA state, used to regenerate the ignore list incrementally.
+ * One summary is kept per function, keyed by its name:
+ *  - a hash of the function body (see hashFunction),
+ *  - whether it can reach a thread fork/join site,
+ *  - the thread start routines the function is reachable from,
+ *  - the sharing verdict of every access (keyed by its source location),
+ *    together with a digest of the points-to set of the accessed pointer.
+ * A function whose hash or thread set changed since the last run is re-analyzed,
+ * everything else reuses the recorded verdicts.
+ */
+class TSAState {
+public:
+    enum Verdict {Unshared, Shared};
+
+    struct AccessRecord {
+        Verdict verdict;
+        std::string ptsDigest;
+    };
+
+    using AccessRecordMap = std::map<std::string, AccessRecord>;    // source loc -> record
+    using ThreadNameSet = std::set<std::string>;
+
+    struct FunctionSummary {
+        std::string hash;
+        bool reachesFork;   ///< whether the function (transitively) creates or joins threads
+        ThreadNameSet threads;
+        AccessRecordMap accesses;
+
+        FunctionSummary() : reachesFork(false) {}
+    };
+
+    using FunctionSummaryMap = std::map<std::string, FunctionSummary>;
+
+private:
+    FunctionSummaryMap summaries;
+    bool loaded;
+
+public:
+    TSAState() : loaded(false) {}
+
+    /// Read/write the state file, return false if the file can not be opened
+    //@{
+    bool load(const std::string &path);
+    bool save(const std::string &path) const;
+    //@}
+
+    /// Whether a previous state was read in
+    inline bool isLoaded() const {
+        return loaded;
+    }
+
+    inline const FunctionSummary *getSummary(const std::string &func) const {
+        auto iter = summaries.find(func);
+        if (iter == summaries.end()) {
+            return nullptr;
+        }
+        return &iter->second;
+    }
+
+    inline FunctionSummary &getOrAddSummary(const std::string &func) {
+        return summaries[func];
+    }
+
+    inline const FunctionSummaryMap &getSummaries() const {
+        return summaries;
+    }
+
+    /// Hash of the function body which is stable across builds:
+    /// instruction opcodes, types, referenced globals/constants and source lines,
+    /// but not value names or metadata numbering.
+    static std::string hashFunction(const llvm::Function *func);
+
+    /// MD5 digest of an arbitrary (already canonicalized) string
+    static std::string digest(const std::string &str);
+};
+
+#endif //SVF_ORIGIN_TSASTATE_H
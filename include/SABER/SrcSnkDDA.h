@@ -61,10 +61,11 @@ private:
     SaberSVFGBuilder memSSA;
     SVFG* svfg;
     PTACallGraph* ptaCallGraph;
+    SrcSnkDDA* svfgProvider;	///< checker whose SVFG is reused, NULL if this checker builds its own
 public:
 
     /// Constructor
-    SrcSnkDDA() : _curSlice(NULL), svfg(NULL), ptaCallGraph(NULL) {
+    SrcSnkDDA() : _curSlice(NULL), svfg(NULL), ptaCallGraph(NULL), svfgProvider(NULL) {
         pathCondAllocator = new PathCondAllocator();
     }
     /// Destructor
@@ -87,10 +88,16 @@ public:
 
     /// Initialize analysis
     virtual void initialize(SVFModule module) {
-        ptaCallGraph = new PTACallGraph(module);
-        AndersenWaveDiff* ander = AndersenWaveDiff::createAndersenWaveDiff(module);
-        svfg =  memSSA.buildSVFG(ander);
-        setGraph(memSSA.getSVFG());
+        if (svfgProvider != NULL) {
+            /// the SVFG does not depend on the checker, reuse the one already built for this module
+            setGraph(svfgProvider->graph());
+        }
+        else {
+            ptaCallGraph = new PTACallGraph(module);
+            AndersenWaveDiff* ander = AndersenWaveDiff::createAndersenWaveDiff(module);
+            svfg =  memSSA.buildSVFG(ander);
+            setGraph(memSSA.getSVFG());
+        }
         //AndersenWaveDiff::releaseAndersenWaveDiff();
         /// allocate control-flow graph branch conditions
         getPathAllocator()->allocate(module);
@@ -109,8 +116,18 @@ public:
         return graph();
     }
 
+    /// Reuse the SVFG built by checker, which has analysed (or is analysing) the same module and outlives this one,
+    /// instead of building the SVFG again.
+    /// The SVFG is only shared within this process, there is no on-disk SVFG other processes can load:
+    /// its nodes refer to PAG edges and memory SSA versions, which would need to be rebuilt anyway.
+    inline void reuseSVFGOf(SrcSnkDDA* checker) {
+        svfgProvider = checker;
+    }
+
     /// Whether this svfg node may access global variable
     inline bool isGlobalSVFGNode(const SVFGNode* node) const {
+        if (svfgProvider != NULL)
+            return svfgProvider->isGlobalSVFGNode(node);
         return memSSA.isGlobalSVFGNode(node);
     }
     /// Slice operations
@@ -560,6 +560,9 @@ std::string  bugMsg3(std::string msg);
 /// Print each pass/phase message by converting a string into blue string output
 std::string  pasMsg(std::string msg);
 
+/// Return str as a quoted JSON string, escaping quotes, backslashes and control characters
+std::string getJSONString(const std::string& str);
+
 /// Print memory usage in KB.
 void reportMemoryUsageKB(const std::string& infor, llvm::raw_ostream & O = llvm::outs());
 
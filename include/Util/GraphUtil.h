@@ -30,39 +30,95 @@
 #ifndef GRAPHUTIL_H_
 #define GRAPHUTIL_H_
 
+#include "Util/AnalysisUtil.h"		// for getJSONString
 #include <llvm/Support/Debug.h> 		// for debug
 #include <llvm/ADT/GraphTraits.h>		// for Graphtraits
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Support/CommandLine.h>           // for tool output file
 #include <llvm/Support/GraphWriter.h>		// for graph write
 #include <llvm/Support/FileSystem.h>		// for file open flag
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Argument.h>
+#include <string>
 
 namespace llvm {
 
+/*!
+ * Node information used to filter graph exports (-graph-func, -graph-kind).
+ * Graphs whose nodes belong to functions or have kinds specialise it next to their DOTGraphTraits,
+ * the nodes of the other graphs have neither and are filtered out by any filter.
+ */
+template<class GraphType>
+struct GraphExportTraits {
+    template<class NodeRef>
+    static const Function* getFunction(NodeRef node) {
+        return NULL;
+    }
+    template<class NodeRef>
+    static std::string getNodeKind(NodeRef node) {
+        return "";
+    }
+};
+
 /*
  * Dump and print the graph for debugging
  */
 class GraphPrinter {
 
 public:
+    /// Format of the written graphs
+    enum Format {
+        DOT,	///< dot file, as written by llvm::WriteGraph
+        EdgeList	///< one JSON object per line, the nodes followed by their outgoing edges
+    };
+
     GraphPrinter() {
     }
 
+    /// Options shared by all graph exports
+    //@{
+    static Format getFormat();
+    /// Whether -graph-func or -graph-kind is given
+    static bool hasNodeFilter();
+    /// Whether a node of fun with kind is written
+    static bool isNodeExported(const Function* fun, const std::string& kind);
+    //@}
+
+    /// Function of a value, NULL for globals and constants
+    static inline const Function* getFunctionOf(const Value* val) {
+        if (val == NULL)
+            return NULL;
+        if (const Instruction* inst = dyn_cast<Instruction>(val))
+            return inst->getParent() ? inst->getParent()->getParent() : NULL;
+        if (const Argument* arg = dyn_cast<Argument>(val))
+            return arg->getParent();
+        return dyn_cast<Function>(val);
+    }
+
     /*!
      *  Write the graph into dot file for debugging purpose
+     *  Nodes are streamed into the buffered file one after the other, in the format and with the filters
+     *  given on the command line.
      */
     template<class GraphType>
     static void WriteGraphToFile(llvm::raw_ostream &O,
                                  const std::string &GraphName, const GraphType &GT, bool simple = false) {
         // Filename of the output dot file
-        std::string Filename = GraphName + ".dot";
+        std::string Filename = GraphName + (getFormat() == EdgeList ? ".jsonl" : ".dot");
         O << "Writing '" << Filename << "'...";
         std::error_code ErrInfo;
         ToolOutputFile F(Filename.c_str(), ErrInfo, sys::fs::F_None);
 
         if (!ErrInfo) {
+            F.os().SetBufferSize(OutputBufferSize);
             // dump the ValueFlowGraph here
-            WriteGraph(F.os(), GT, simple);
+            if (getFormat() == EdgeList)
+                WriteEdgeList(F.os(), GT);
+            else if (hasNodeFilter())
+                WriteFilteredGraph(F.os(), GraphName, GT, simple);
+            else
+                WriteGraph(F.os(), GT, simple);
             F.os().close();
             if (!F.os().has_error()) {
                 O << "\n";
@@ -74,6 +130,75 @@ public:
         F.os().clear_error();
     }
 
+    /*!
+     * Write the exported nodes of the graph and the edges between them into a dot file,
+     * labels and attributes are taken from DOTGraphTraits
+     */
+    template<class GraphType>
+    static void WriteFilteredGraph(raw_ostream &OS, const std::string &GraphName, const GraphType &GT, bool simple) {
+        typedef GraphTraits<GraphType> GTraits;
+        typedef typename GTraits::nodes_iterator node_iterator;
+        typedef typename GTraits::ChildIteratorType child_iterator;
+
+        DOTGraphTraits<GraphType> DTraits(simple);
+        OS << "digraph \"" << DOT::EscapeString(GraphName) << "\" {\n";
+        for (node_iterator I = GTraits::nodes_begin(GT), E = GTraits::nodes_end(GT); I != E; ++I) {
+            if (!isNodeExported<GraphType>(*I))
+                continue;
+            OS << "\tNode" << static_cast<const void*>(*I) << " [shape=record,";
+            std::string NodeAttributes = DTraits.getNodeAttributes(*I, GT);
+            if (!NodeAttributes.empty())
+                OS << NodeAttributes << ",";
+            OS << "label=\"{" << DOT::EscapeString(DTraits.getNodeLabel(*I, GT)) << "}\"];\n";
+            for (child_iterator EI = GTraits::child_begin(*I), EE = GTraits::child_end(*I); EI != EE; ++EI) {
+                if (!isNodeExported<GraphType>(*EI))
+                    continue;
+                OS << "\tNode" << static_cast<const void*>(*I) << " -> Node" << static_cast<const void*>(*EI);
+                std::string EdgeAttributes = DTraits.getEdgeAttributes(*I, EI, GT);
+                if (!EdgeAttributes.empty())
+                    OS << "[" << EdgeAttributes << "]";
+                OS << ";\n";
+            }
+        }
+        OS << "}\n";
+    }
+
+    /*!
+     * Write the exported nodes of the graph and the edges between them as JSON lines:
+     *  {"node":id,"kind":"...","func":"..."} for a node, followed by {"src":id,"dst":id} for its outgoing edges
+     */
+    template<class GraphType>
+    static void WriteEdgeList(raw_ostream &OS, const GraphType &GT) {
+        typedef GraphTraits<GraphType> GTraits;
+        typedef typename GTraits::nodes_iterator node_iterator;
+        typedef typename GTraits::ChildIteratorType child_iterator;
+
+        for (node_iterator I = GTraits::nodes_begin(GT), E = GTraits::nodes_end(GT); I != E; ++I) {
+            if (!isNodeExported<GraphType>(*I))
+                continue;
+            OS << "{\"node\":" << (*I)->getId();
+            std::string kind = GraphExportTraits<GraphType>::getNodeKind(*I);
+            if (!kind.empty())
+                OS << ",\"kind\":\"" << kind << "\"";
+            if (const Function* fun = GraphExportTraits<GraphType>::getFunction(*I))
+                OS << ",\"func\":" << analysisUtil::getJSONString(fun->getName().str());
+            OS << "}\n";
+            for (child_iterator EI = GTraits::child_begin(*I), EE = GTraits::child_end(*I); EI != EE; ++EI) {
+                if (isNodeExported<GraphType>(*EI))
+                    OS << "{\"src\":" << (*I)->getId() << ",\"dst\":" << (*EI)->getId() << "}\n";
+            }
+        }
+    }
+
+    /// Whether a node passes the filters given on the command line
+    template<class GraphType, class NodeRef>
+    static inline bool isNodeExported(NodeRef node) {
+        if (!hasNodeFilter())
+            return true;
+        return isNodeExported(GraphExportTraits<GraphType>::getFunction(node),
+                              GraphExportTraits<GraphType>::getNodeKind(node));
+    }
+
     /*!
      * Print the graph to command line
      */
@@ -101,6 +226,9 @@ public:
             }
         }
     }
+
+private:
+    static const size_t OutputBufferSize = 1 << 20;
 };
 
 }
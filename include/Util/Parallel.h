@@ -0,0 +1,78 @@
+//===- Parallel.h -- Simple parallel loop used in SVF-------------------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * Parallel.h
+ *
+ * A minimal parallel-for over an index range. Iterations are handed out one at a
+ * time from a shared counter, so uneven work (e.g. functions of very different
+ * sizes) is balanced between the workers. The body must only write to data owned
+ * by its own iteration.
+ */
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+/// Number of worker threads to use when none is given
+inline unsigned getNumOfWorkers() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/// Run body(i) for every i in [0, size), using at most numOfWorkers threads.
+/// Small ranges and numOfWorkers == 1 run on the calling thread.
+template<typename Body>
+void parallelFor(size_t size, Body body, unsigned numOfWorkers = 0) {
+    if (numOfWorkers == 0)
+        numOfWorkers = getNumOfWorkers();
+    if (numOfWorkers > size)
+        numOfWorkers = size;
+
+    if (numOfWorkers <= 1) {
+        for (size_t i = 0; i < size; i++)
+            body(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < size; i = next++)
+            body(i);
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned w = 1; w < numOfWorkers; w++)
+        workers.push_back(std::thread(worker));
+    worker();
+    for (std::thread &t : workers)
+        t.join();
+}
+
+} // End namespace parallel
+
+#endif /* PARALLEL_H_ */
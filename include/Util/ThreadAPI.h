@@ -33,6 +33,7 @@
 #include "Util/BasicTypes.h"
 #include "Util/SVFModule.h"
 #include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/CallSite.h>
 
@@ -65,11 +66,15 @@ public:
     };
 
     typedef llvm::StringMap<TD_TYPE> TDAPIMap;
+    typedef llvm::DenseMap<const llvm::Function*, TD_TYPE> FunToTDTypeMap;
 
 private:
     /// API map, from a string to threadAPI type
     TDAPIMap tdAPIMap;
 
+    /// Functions of the resolved module, from a function to threadAPI type
+    FunToTDTypeMap funToTDTypeMap;
+
     /// Constructor
     ThreadAPI () {
         init();
@@ -82,9 +87,13 @@ private:
     static ThreadAPI* tdAPI;
 
     /// Get the function type if it is a threadAPI function
+    /// Functions of a resolved module are looked up by pointer, the others by name
     inline TD_TYPE getType(const llvm::Function* F) const {
         if(F) {
-            TDAPIMap::const_iterator it= tdAPIMap.find(F->getName().str());
+            FunToTDTypeMap::const_iterator fit = funToTDTypeMap.find(F);
+            if(fit != funToTDTypeMap.end())
+                return fit->second;
+            TDAPIMap::const_iterator it= tdAPIMap.find(F->getName());
             if(it != tdAPIMap.end())
                 return it->second;
         }
@@ -100,6 +109,24 @@ public:
         return tdAPI;
     }
 
+    /// Read additional APIs (e.g. in-house lock wrappers) from a file, one "<function name> <kind>" per line.
+    /// Return false if the file can not be opened.
+    bool loadAPIFile(const std::string& file);
+
+    /// Resolve the type of every function of a module once, later queries do not compare names.
+    /// It has to be done again after loading more APIs.
+    void resolveModule(const llvm::Module& module);
+
+    /// Return the threadAPI type of a function, TD_DUMMY if it is not a threadAPI function
+    inline TD_TYPE getTDType(const llvm::Function* F) const {
+        return getType(F);
+    }
+
+    /// Return true if this function is a modelled threadAPI function
+    inline bool isTDAPI(const llvm::Function* F) const {
+        return getType(F) != TD_DUMMY;
+    }
+
     /// Return the callee/callsite/func
     //@{
     const llvm::Function* getCallee(const llvm::Instruction *inst) const;
@@ -250,6 +277,17 @@ public:
     }
     //@}
 
+    /// Return true if this call may acquire a lock (e.g. pthread_mutex_trylock)
+    //@{
+    inline bool isTDTryAcquire(const llvm::Instruction *inst) const {
+        return getType(getCallee(inst)) == TD_TRY_ACQUIRE;
+    }
+
+    inline bool isTDTryAcquire(llvm::CallSite cs) const {
+        return getType(getCallee(cs)) == TD_TRY_ACQUIRE;
+    }
+    //@}
+
     /// Return true if this call release a lock
     //@{
     inline bool isTDRelease(const llvm::Instruction *inst) const {
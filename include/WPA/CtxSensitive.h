@@ -14,13 +14,43 @@
 #include "WPA/WPASolver.h"
 #include "MemoryModel/ConsG.h"
 #include "MemoryModel/CtxConsG.h"
+#include "Util/CPPUtil.h"
+#include "Util/Parallel.h"
+#include "Util/ThreadCallGraph.h"
 
+#include <chrono>
+#include <unordered_map>
 #include <llvm/PassAnalysisSupport.h>	// analysis usage
 #include <llvm/Support/Debug.h>		// DEBUG TYPE
 
 
 #include "OriginGTraits.h"
 
+/*!
+ * Options of the context-sensitive solvers (CtxSensitive.cpp)
+ */
+class CtxSensitiveOptions {
+public:
+    /// Call graph the contexts are built from before solving
+    enum CallGraphKind {
+        DirectCallGraph,    ///< direct calls only, indirect calls are resolved while solving
+        TypeCallGraph,      ///< plus calls from every indirect call site to the address-taken functions with matching arguments
+        AndersenCallGraph   ///< resolved by a whole-program Andersen analysis first
+    };
+
+    static CallGraphKind getCallGraphKind();
+    /// Whether functions are cloned only for the contexts they are reachable in over the call graph (call site sensitivity)
+    static bool cloneReachableOnly();
+    /// Whether a cost model over an Andersen pre-analysis selects the functions and objects with contexts
+    static bool selectContexts();
+    /// Whether the partitions of the constraint graph (the origins for origin sensitivity) are solved on parallel threads
+    static bool solveInParallel();
+    /// Worker threads for parallel solving, 0 for one per hardware thread
+    static unsigned getNumOfThreads();
+    /// Whether the solved constraint graph is dumped
+    static bool dumpConstraintGraph();
+};
+
 // TODO : better use CondPTAImpl, use BVDataPTAImpl for simplicity now.
 template <typename Ctx>
 class CtxSensitive : public BVDataPTAImpl, public WPASolver<CtxConstraintGraph<Ctx> *>{
@@ -39,15 +69,154 @@ public:
     double timeOfProcessCopyGep = 0;
     double timeOfProcessLoadStore = 0;
     double timeOfUpdateCallGraph = 0;
+    double timeOfPreAnalysis = 0;
+    double timeOfBuildCtxPAG = 0;
+    double timeOfSolving = 0;
+    double timeOfProjection = 0;
+    std::vector<double> timeOfPartitions;	/// Wall time spent solving each partition
+    Size_t numOfPartitionRounds = 0;	/// Number of rounds between the exchanges of the partitions
 
 private:
     CtxPAG<Ctx> *ctxPAG;
+    typedef llvm::DenseMap<NodeID, PointsTo> FunPtrToTargetsMap;
+    FunPtrToTargetsMap resolvedTargets;  ///< function pointer clone -> targets resolved so far
+
+    /// Projection of the results onto the context-insensitive PAG
+    //@{
+    std::vector<NodeID> ctxToInsensID;   ///< clone -> its context-insensitive node, filled in on demand
+    /// context-insensitive node -> union over its clones, on demand. Node-based, so a reference returned by getPts
+    /// stays valid while later queries insert (alias() holds two at once)
+    std::unordered_map<NodeID, PointsTo> projectedPtsMap;
+    /// Drop the unions projected so far, they are out of date once the points-to sets change
+    inline void resetProjection() {
+        projectedPtsMap.clear();
+    }
+    NodeID getInsensID(NodeID ctxId);
+    void projectPts(const PointsTo &ctxPts, PointsTo &pts);
+    //@}
+    AndersenWaveDiff *preAnalysis;      ///< context-insensitive pre-analysis, if one was run
 
     void mergeSccCycle();
 
+    /// Fill in the statistics only the analysis can compute
+    void collectStat(CtxSensitiveStat *ctxStat);
+
+    void buildCallGraph(SVFModule svfModule);
+    void addTypeBasedCallEdges(SVFModule svfModule);
+    void addPreAnalysisCallEdges();
+
 
 protected:
-    explicit CtxSensitive(PointerAnalysis::PTATY ptaTy) : BVDataPTAImpl(ptaTy) {}
+    CtxSelection *selection;            ///< nullptr unless contexts are selective
+
+    /// Clones of a variable often have equal points-to sets, which are shared instead of copied
+    typedef SharedDiffPTData<NodeID, PointsTo, EdgeID> SharedPTDataTy;
+    typedef std::vector<std::pair<const CtxGepCGEdge<Ctx> *, PointsTo>> GepPtsList;
+
+    /// Solving by partitions: the constraint graph is split into partitions, each partition has its own
+    /// points-to data and is solved by one thread (in parallel with -ctx-parallel). Points-to flowing into
+    /// another partition and the gep edges (which add nodes and edges) are kept until all partitions are
+    /// done, and then exchanged. SCCs are only collapsed within a partition.
+    //@{
+    u32_t numOfPartitions;
+    std::vector<SharedPTDataTy> ptData;             ///< partition -> points-to data of its nodes
+    std::vector<u32_t> nodePartitions;              ///< node -> partition, extended as nodes are added
+    bool inParallel;                                ///< whether the partitions are being solved
+    std::vector<llvm::DenseMap<NodeID, PointsTo>> outboxes;    ///< partition -> points-to for the other partitions
+    std::vector<GepPtsList> deferredGeps;           ///< partition -> gep edges with the points-to to process
+    std::vector<std::vector<NodeID>> partitionWorklists;       ///< partition -> nodes for the load/store phase
+    bool atInterface;                               ///< whether the partitions are being exchanged
+    NodeBS changedAtInterface;                      ///< nodes changed by the exchange
+
+    /// Number of partitions and the partition of a node, a single partition by default
+    virtual u32_t getNumOfPartitions() {
+        return 1;
+    }
+    virtual u32_t partitionOf(CtxPAGNode<Ctx> *node) {
+        return 0;
+    }
+    virtual std::string getPartitionName(u32_t partition) {
+        return std::to_string(partition);
+    }
+
+    void initPartitions();
+    void extendPartitions(NodeID id);
+    /// Solve the nodes of each partition in topological order in parallel, until no partition
+    /// receives anything new. processNode() may only propagate along copy/gep edges.
+    void solvePartitions(NodeStack &topoOrder);
+
+    /// The partition solved by the calling thread
+    static inline u32_t &curPartition() {
+        static thread_local u32_t partition = 0;
+        return partition;
+    }
+    inline u32_t getPartition(NodeID id) {
+        if (numOfPartitions == 1)
+            return 0;
+        if (id >= nodePartitions.size())
+            extendPartitions(id);
+        return nodePartitions[id];
+    }
+    //@}
+
+    inline SharedPTDataTy &getSharedPTData(NodeID id) {
+        return ptData[getPartition(id)];
+    }
+    /// Free the points-to sets no longer used, no reference to a points-to set may be held across it
+    inline void collectGarbage() {
+        if (inParallel) {
+            ptData[curPartition()].collectGarbage();
+            return;
+        }
+        for (SharedPTDataTy &data : ptData)
+            data.collectGarbage();
+    }
+
+    /// Union/add points-to, in the shared points-to data
+    //@{
+    inline bool unionPts(NodeID id, const PointsTo& target) override {
+        if (inParallel && getPartition(id) != curPartition()) {
+            outboxes[curPartition()][id] |= target;
+            return false;
+        }
+        return getSharedPTData(id).unionPts(id, target);
+    }
+    inline bool unionPts(NodeID id, NodeID ptd) override {
+        if (getPartition(id) != getPartition(ptd))
+            return unionPts(id, getCtxPts(ptd));
+        return getSharedPTData(id).unionPts(id, ptd);
+    }
+    inline bool addPts(NodeID id, NodeID ptd) override {
+        if (inParallel && getPartition(id) != curPartition()) {
+            outboxes[curPartition()][id].set(ptd);
+            return false;
+        }
+        return getSharedPTData(id).addPts(id, ptd);
+    }
+    inline void clearPts() override {
+        for (SharedPTDataTy &data : ptData)
+            data.clear();
+    }
+    //@}
+
+    /// While the partitions are solved, the nodes for the load/store phase are queued by partition
+    inline void pushIntoWorklist(NodeID id) {
+        NodeID rep = sccRepNode(id);
+        if (inParallel) {
+            partitionWorklists[curPartition()].push_back(rep);
+            return;
+        }
+        if (atInterface)
+            changedAtInterface.set(rep);
+        WPASolver<CtxConstraintGraph<Ctx> *>::pushIntoWorklist(rep);
+    }
+
+    explicit CtxSensitive(PointerAnalysis::PTATY ptaTy) : BVDataPTAImpl(ptaTy), preAnalysis(nullptr),
+            selection(nullptr), numOfPartitions(1), ptData(1), inParallel(false), atInterface(false) {}
+    ~CtxSensitive() override {
+        delete selection;
+        delete preAnalysis;
+    }
     virtual CtxPAG<Ctx>* buildCtxPAG(SVFModule module, PTACallGraph *callGraph) = 0;
 
     void processNode(NodeID id) override;
@@ -57,14 +226,14 @@ protected:
     virtual bool processStore(NodeID node, const CtxConstraintEdge<Ctx>* store);
     virtual bool processCopy(NodeID node, const CtxConstraintEdge<Ctx>* edge);
     virtual void processGep(NodeID node, const CtxGepCGEdge<Ctx>* edge);
-    virtual void processGepPts(PointsTo& pts, const CtxGepCGEdge<Ctx>* edge);
+    virtual void processGepPts(const PointsTo& pts, const CtxGepCGEdge<Ctx>* edge);
 
     /// Add copy edge on constraint graph
     virtual inline bool addCopyEdge(NodeID src, NodeID dst) {
         return this->graph()->addCopyCGEdge(src, dst);
     }
 
-    void mergeSccNodes(NodeID repNodeId, NodeBS & chanegdRepNodes);
+    void mergeSccNodes(NodeID repNodeId, NodeBS & chanegdRepNodes, NodeStack & partitionReps);
     virtual void mergeNodeToRep(NodeID nodeId,NodeID newRepId);
 
     /// SCC methods
@@ -77,32 +246,94 @@ protected:
 
     NodeStack& SCCDetect() override;
 
+    /// Resolve the indirect calls in the context of every function pointer clone
+    bool updateCallGraph(const CallSiteToFunPtrMap& callsites) override;
+    /// Mirror the clones added since the last round and let the existing points-to flow into them
+    bool updateConstraintGraph();
+    /// The whole points-to set of id has to flow along its new outgoing copy/gep edges
+    virtual void repropagate(NodeID id) {
+        this->pushIntoWorklist(id);
+    }
+
 protected:
     bool reanalyze = false;
 public:
+    /// Points-to of a clone (a node of the context-sensitive PAG), objects with their contexts.
+    /// It may be shared with other clones, it is changed by unionPts/addPts only.
+    inline const PointsTo& getCtxPts(NodeID ctxId) {
+        return getSharedPTData(ctxId).getPts(ctxId);
+    }
+
+    /// Queries in terms of the context-insensitive PAG (what clients of PointerAnalysis use),
+    /// the objects are projected to the context-insensitive objects.
+    //@{
+    /// Union over the contexts of pagId
+    PointsTo& getPts(NodeID pagId) override;
+    /// In one context of pagId, or without context if pagId has no clone in ctx
+    PointsTo getPts(NodeID pagId, const Ctx &ctx);
+    //@}
+
+    /// The clone of pagId in ctx, or the one without context if pagId has no clone in ctx (UINT_MAX if none)
+    NodeID getCtxNode(NodeID pagId, const Ctx &ctx) const;
+
+    /// Alias of two values in given contexts, objects of different contexts do not alias
+    //@{
+    llvm::AliasResult alias(NodeID pagId1, const Ctx &ctx1, NodeID pagId2, const Ctx &ctx2);
+    llvm::AliasResult alias(const llvm::Value *v1, const Ctx &ctx1, const llvm::Value *v2, const Ctx &ctx2) {
+        return alias(pag->getValueNode(v1), ctx1, pag->getValueNode(v2), ctx2);
+    }
+    using BVDataPTAImpl::alias;
+    //@}
+
     void analyze(SVFModule svfModule) override {
-        auto andersen = new AndersenWaveDiff();
-        andersen->analyze(svfModule);
+        auto *ctxStat = new CtxSensitiveStat(this);
+        stat = ctxStat;
+
+        double preStart = PTAStat::getClk();
+        buildCallGraph(svfModule);
+        if (CtxSensitiveOptions::selectContexts()) {
+            selection = new CtxSelection(preAnalysis);
+            selection->select();
+        }
+        timeOfPreAnalysis = (PTAStat::getClk() - preStart) / TIMEINTERVAL;
 
-        double timeStart = CLOCK_IN_MS();
-        ctxPAG = buildCtxPAG(svfModule, andersen->getPTACallGraph());
+        double buildStart = PTAStat::getClk();
+        ctxPAG = buildCtxPAG(svfModule, getPTACallGraph());
+        initPartitions();
+        timeOfBuildCtxPAG = (PTAStat::getClk() - buildStart) / TIMEINTERVAL;
 
+        double solveStart = PTAStat::getClk();
         auto *consG = new CtxConstraintGraph<Ctx> (ctxPAG);
         this->setGraph(consG);
             // the initial pts can be computed
         processAllAddr();
         do {
-            // we do not update Call graph on the fly.
-            // so we do not need re-analyze
             reanalyze = false;
             this->solve();
 
+            // the call graph is updated on the fly
+            double cgUpdateStart = PTAStat::getClk();
+            if (updateCallGraph(getIndirectCallsites()))
+                reanalyze = true;
+            if (updateConstraintGraph())
+                reanalyze = true;
+            timeOfUpdateCallGraph += (PTAStat::getClk() - cgUpdateStart) / TIMEINTERVAL;
         } while(reanalyze);
-
-        double timeEnd = CLOCK_IN_MS();
-
-        printf("solving time: %f\n", (timeEnd - timeStart) / 1000.0f);
-        this->graph()->dump();
+        timeOfSolving = (PTAStat::getClk() - solveStart) / TIMEINTERVAL;
+        DBOUT(DGENERAL, llvm::outs() << "solving time: " << timeOfSolving << "\n");
+        if (numOfPartitions > 1)
+            DBOUT(DGENERAL, llvm::outs() << "partitions: " << numOfPartitions << ", rounds: " << numOfPartitionRounds << "\n");
+
+        double projectionStart = PTAStat::getClk();
+        resetProjection();
+        timeOfProjection = (PTAStat::getClk() - projectionStart) / TIMEINTERVAL;
+
+        if (printStat()) {
+            collectStat(ctxStat);
+            ctxStat->performStat();
+        }
+        if (CtxSensitiveOptions::dumpConstraintGraph())
+            this->graph()->dump();
     }
 
     inline NodeID getBaseObjNode(NodeID id) {
@@ -138,8 +369,8 @@ void CtxSensitive<Ctx>::mergeSccCycle() {
         topoOrder.pop();
         revTopoOrder.push(repNodeId);
 
-        // merge sub nodes to rep node
-        mergeSccNodes(repNodeId, changedRepNodes);
+        // merge sub nodes to rep node, the reps of the other partitions in the SCC are solved after it
+        mergeSccNodes(repNodeId, changedRepNodes, revTopoOrder);
     }
 
     // update rep/sub relation in the constraint graph.
@@ -185,12 +416,26 @@ void CtxSensitive<Ctx>::mergeNodeToRep(NodeID nodeId,NodeID newRepId) {
     newSubs.set(node->getId());
 }
 
+/*!
+ * Nodes are only merged with the nodes of the same partition (origin), every partition in the SCC has its own rep.
+ * The cycle through the reps of different partitions is closed by the exchanges between the partitions.
+ */
 template <typename Ctx>
-void CtxSensitive<Ctx>::mergeSccNodes(NodeID repNodeId, NodeBS& chanegdRepNodes) {
+void CtxSensitive<Ctx>::mergeSccNodes(NodeID repNodeId, NodeBS& chanegdRepNodes, NodeStack& partitionReps) {
+    llvm::DenseMap<u32_t, NodeID> partitionToRep;
+    partitionToRep[getPartition(repNodeId)] = repNodeId;
+
     const NodeBS& subNodes = this->getSCCDetector()->subNodes(repNodeId);
     for (unsigned int subNodeId : subNodes) {
-        if (subNodeId != repNodeId) {
-            mergeNodeToRep(subNodeId, repNodeId);
+        auto inserted = partitionToRep.insert(std::make_pair(getPartition(subNodeId), subNodeId));
+        if (inserted.second) {
+            partitionReps.push(subNodeId);
+            continue;
+        }
+
+        NodeID rep = inserted.first->second;
+        if (subNodeId != rep) {
+            mergeNodeToRep(subNodeId, rep);
             chanegdRepNodes.set(subNodeId);
         }
     }
@@ -199,20 +444,167 @@ void CtxSensitive<Ctx>::mergeSccNodes(NodeID repNodeId, NodeBS& chanegdRepNodes)
 template <typename Ctx>
 NodeStack& CtxSensitive<Ctx>::SCCDetect() {
     numOfSCCDetection++;
-    //double sccStart = stat->getClk();
+    double sccStart = stat->getClk();
     WPASolver<CtxConstraintGraph<Ctx> *>::SCCDetect();
-    //double sccEnd = stat->getClk();
-    //timeOfSCCDetection +=  (sccEnd - sccStart)/TIMEINTERVAL;
+    double sccEnd = stat->getClk();
+    timeOfSCCDetection +=  (sccEnd - sccStart)/TIMEINTERVAL;
 
-    //double mergeStart = stat->getClk();
+    double mergeStart = stat->getClk();
     //merge SCC in constraint Graph
     mergeSccCycle();
-    //double mergeEnd = stat->getClk();
-    //timeOfSCCMerges +=  (mergeEnd - mergeStart)/TIMEINTERVAL;
+    double mergeEnd = stat->getClk();
+    timeOfSCCMerges +=  (mergeEnd - mergeStart)/TIMEINTERVAL;
 
     return this->getSCCDetector()->topoNodeStack();
 }
 
+/*!
+ * The call graph of the direct calls, plus the indirect calls resolved by the Andersen pre-analysis or by types.
+ * Without them only the direct calls are known before solving.
+ */
+template <typename Ctx>
+void CtxSensitive<Ctx>::buildCallGraph(SVFModule svfModule) {
+    if (CtxSensitiveOptions::getCallGraphKind() == CtxSensitiveOptions::AndersenCallGraph ||
+        CtxSensitiveOptions::selectContexts()) {
+        preAnalysis = new AndersenWaveDiff();
+        preAnalysis->analyze(svfModule);
+    }
+
+    initialize(svfModule);
+    if (CtxSensitiveOptions::getCallGraphKind() == CtxSensitiveOptions::AndersenCallGraph)
+        addPreAnalysisCallEdges();
+    else if (CtxSensitiveOptions::getCallGraphKind() == CtxSensitiveOptions::TypeCallGraph)
+        addTypeBasedCallEdges(svfModule);
+    callGraphSCCDetection();
+}
+
+/*!
+ * The indirect calls (and forks) resolved by the pre-analysis, added to the call graph of this analysis
+ */
+template <typename Ctx>
+void CtxSensitive<Ctx>::addPreAnalysisCallEdges() {
+    for (const auto &entry : preAnalysis->getIndCallMap()) {
+        for (const llvm::Function *callee : entry.second) {
+            if (getIndCallMap()[entry.first].insert(callee).second)
+                ptaCallGraph->addIndirectCallGraphEdge(entry.first.getInstruction(), callee);
+        }
+    }
+    if (ThreadCallGraph *tcg = llvm::dyn_cast<ThreadCallGraph>(ptaCallGraph))
+        tcg->updateCallGraph(preAnalysis);
+}
+
+template <typename Ctx>
+void CtxSensitive<Ctx>::addTypeBasedCallEdges(SVFModule svfModule) {
+    std::vector<const llvm::Function *> addrTakenFuncs;
+    for (const llvm::Function *func : svfModule) {
+        if (!func->isDeclaration() && func->hasAddressTaken())
+            addrTakenFuncs.push_back(func);
+    }
+
+    for (const auto &callsite : getIndirectCallsites()) {
+        llvm::CallSite cs = callsite.first;
+        VFunSet callees;
+        if (cppUtil::isVirtualCallSite(cs)) {
+            getVFnsFromCHA(cs, callees);
+        } else {
+            for (const llvm::Function *func : addrTakenFuncs) {
+                if (matchArgs(cs, func))
+                    callees.insert(func);
+            }
+        }
+
+        for (const llvm::Function *callee : callees) {
+            if (getIndCallMap()[cs].insert(callee).second)
+                ptaCallGraph->addIndirectCallGraphEdge(cs.getInstruction(), callee);
+        }
+    }
+}
+
+/*!
+ * Only the targets added to a function pointer clone since the last round are resolved,
+ * the callee is connected in the context of that clone.
+ */
+template <typename Ctx>
+bool CtxSensitive<Ctx>::updateCallGraph(const CallSiteToFunPtrMap& callsites) {
+    bool connected = false;
+    for (const auto &callsite : callsites) {
+        llvm::CallSite cs = callsite.first;
+        // connecting a callee may clone it, which adds entries to the clone map
+        const auto funPtrs = ctxPAG->getCtxSenIDs(callsite.second);
+        for (NodeID funPtr : funPtrs) {
+            PointsTo &resolved = resolvedTargets[funPtr];
+            PointsTo newTargets;
+            newTargets.intersectWithComplement(getCtxPts(sccRepNode(funPtr)), resolved);
+            if (newTargets.empty())
+                continue;
+            resolved |= newTargets;
+
+            const Ctx &callerCtx = ctxPAG->getCtxPAGNode(funPtr)->getContext();
+            for (NodeID target : newTargets) {
+                if (ctxPAG->isBlkObjOrConstantObj(target))
+                    continue;
+                auto *obj = llvm::dyn_cast<CtxObjPN<Ctx>>(ctxPAG->getCtxPAGNode(target));
+                if (obj == nullptr || obj->getMemObj() == nullptr || !obj->getMemObj()->isFunction())
+                    continue;
+
+                const auto *callee = llvm::cast<llvm::Function>(obj->getMemObj()->getRefVal());
+                callee = analysisUtil::getDefFunForMultipleModule(callee);
+                if (callee->isDeclaration() || !matchArgs(cs, callee))
+                    continue;
+
+                if (getIndCallMap()[cs].insert(callee).second)
+                    ptaCallGraph->addIndirectCallGraphEdge(cs.getInstruction(), callee);
+                if (ctxPAG->connectIndirectCall(cs, callee, callerCtx))
+                    connected = true;
+            }
+        }
+    }
+    return connected;
+}
+
+template <typename Ctx>
+bool CtxSensitive<Ctx>::updateConstraintGraph() {
+    ctxPAG->cloneReachedInstances();
+
+    std::vector<NodeID> newNodes;
+    std::vector<CtxPAGEdge<Ctx> *> newEdges;
+    ctxPAG->takeNewElements(newNodes, newEdges);
+    if (newNodes.empty() && newEdges.empty())
+        return false;
+
+    for (NodeID id : newNodes) {
+        // fields may have been added to the graph when they were created
+        if (sccRepNode(id) == id && !this->graph()->hasConstraintNode(id))
+            this->graph()->addConstraintNode(new CtxConstraintNode<Ctx>(id), id);
+    }
+
+    for (CtxPAGEdge<Ctx> *edge : newEdges) {
+        if (!this->graph()->addCGEdge(edge))
+            continue;
+
+        NodeID src = sccRepNode(edge->getSrcID());
+        NodeID dst = sccRepNode(edge->getDstID());
+        switch (edge->getEdgeKind()) {
+            case PAGEdge::Addr:
+                if (addPts(dst, edge->getSrcID()))
+                    this->pushIntoWorklist(dst);
+                break;
+            case PAGEdge::Load:
+                // the pointer is dereferenced by the loads when it is processed
+                this->pushIntoWorklist(src);
+                break;
+            case PAGEdge::Store:
+                this->pushIntoWorklist(dst);
+                break;
+            default:
+                // copy, call, ret and gep: the source may have been solved in an earlier round
+                repropagate(src);
+                break;
+        }
+    }
+    return true;
+}
+
 template <typename Ctx>
 void CtxSensitive<Ctx>::processAllAddr()  {
     for (auto nodeIt = this->graph()->begin(); nodeIt != this->graph()->end(); nodeIt++) {
@@ -262,7 +654,7 @@ bool CtxSensitive<Ctx>::processCopy(NodeID node, const CtxConstraintEdge<Ctx>* e
 
     assert((isa<CtxCopyCGEdge<Ctx>>(edge)) && "not copy/call/ret ??");
     NodeID dst = edge->getDstID();
-    PointsTo& srcPts = getPts(node);
+    const PointsTo& srcPts = getCtxPts(node);
     bool changed = unionPts(dst,srcPts);
     if (changed)
         this->pushIntoWorklist(dst);
@@ -272,12 +664,18 @@ bool CtxSensitive<Ctx>::processCopy(NodeID node, const CtxConstraintEdge<Ctx>* e
 
 template <typename Ctx>
 void CtxSensitive<Ctx>::processGep(NodeID node, const CtxGepCGEdge<Ctx> *edge) {
-    PointsTo& srcPts = this->getPts(edge->getSrcID());
+    const PointsTo& srcPts = this->getCtxPts(edge->getSrcID());
     processGepPts(srcPts, edge);
 }
 
 template <typename Ctx>
-void CtxSensitive<Ctx>::processGepPts(PointsTo &pts, const CtxGepCGEdge<Ctx> *edge) {
+void CtxSensitive<Ctx>::processGepPts(const PointsTo &pts, const CtxGepCGEdge<Ctx> *edge) {
+
+    if (inParallel) {
+        // field objects and copy edges may be added, which is left to the exchange of the partitions
+        deferredGeps[curPartition()].emplace_back(edge, pts);
+        return;
+    }
 
     numOfProcessedGep++;
     PointsTo tmpDstPts;
@@ -326,9 +724,244 @@ void CtxSensitive<Ctx>::processGepPts(PointsTo &pts, const CtxGepCGEdge<Ctx> *ed
         this->pushIntoWorklist(dstId);
 }
 
+template <typename Ctx>
+void CtxSensitive<Ctx>::initPartitions() {
+    numOfPartitions = getNumOfPartitions();
+    ptData.resize(numOfPartitions);
+    outboxes.resize(numOfPartitions);
+    deferredGeps.resize(numOfPartitions);
+    partitionWorklists.resize(numOfPartitions);
+    timeOfPartitions.assign(numOfPartitions, 0);
+}
+
+/*!
+ * The partition of a node is fixed once it is known, so its points-to data never moves
+ */
+template <typename Ctx>
+void CtxSensitive<Ctx>::extendPartitions(NodeID id) {
+    assert(!inParallel && "node added while solving the partitions");
+    for (NodeID i = nodePartitions.size(); i <= id; i++)
+        nodePartitions.push_back(ctxPAG->hasGNode(i) ? partitionOf(ctxPAG->getCtxPAGNode(i)) % numOfPartitions : 0);
+}
+
+/*!
+ * One round solves every partition with something new on its own thread, the threads only write to
+ * the data of their partition. Between the rounds the points-to sent to other partitions and the gep
+ * edges are processed sequentially, the partitions of the nodes changed by them are solved again.
+ * The nodes queued for loads and stores are handled afterwards by postProcessNode().
+ */
+template <typename Ctx>
+void CtxSensitive<Ctx>::solvePartitions(NodeStack &topoOrder) {
+    // the partitions of all nodes are known before the threads start
+    for (auto it = this->graph()->begin(), eit = this->graph()->end(); it != eit; ++it)
+        getPartition(it->first);
+
+    std::vector<std::vector<NodeID>> partitionNodes(numOfPartitions);
+    NodeBS ordered;
+    while (!topoOrder.empty()) {
+        NodeID id = topoOrder.top();
+        topoOrder.pop();
+        partitionNodes[getPartition(id)].push_back(id);
+        ordered.set(id);
+    }
+
+    std::vector<bool> active(numOfPartitions, true);
+    std::vector<std::vector<NodeID>> newNodes(numOfPartitions);    ///< changed nodes without a topological order
+    while (true) {
+        numOfPartitionRounds++;
+        inParallel = true;
+        parallel::parallelFor(numOfPartitions, [&](size_t p) {
+            if (!active[p])
+                return;
+            curPartition() = p;
+            // clock() would count the other threads as well
+            auto partitionStart = std::chrono::steady_clock::now();
+            for (NodeID id : newNodes[p])
+                this->processNode(id);
+            for (NodeID id : partitionNodes[p])
+                this->processNode(id);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - partitionStart;
+            timeOfPartitions[p] += elapsed.count();
+        }, CtxSensitiveOptions::solveInParallel() ? CtxSensitiveOptions::getNumOfThreads() : 1);
+        inParallel = false;
+
+        atInterface = true;
+        changedAtInterface.clear();
+        for (u32_t p = 0; p < numOfPartitions; p++) {
+            for (NodeID id : partitionWorklists[p])
+                WPASolver<CtxConstraintGraph<Ctx> *>::pushIntoWorklist(id);
+            partitionWorklists[p].clear();
+
+            for (auto &sent : outboxes[p]) {
+                if (unionPts(sent.first, sent.second))
+                    pushIntoWorklist(sent.first);
+            }
+            outboxes[p].clear();
+
+            for (auto &gep : deferredGeps[p])
+                processGepPts(gep.second, gep.first);
+            deferredGeps[p].clear();
+        }
+        atInterface = false;
+
+        if (changedAtInterface.empty())
+            break;
+
+        active.assign(numOfPartitions, false);
+        for (std::vector<NodeID> &nodes : newNodes)
+            nodes.clear();
+        for (NodeID id : changedAtInterface) {
+            u32_t p = getPartition(id);
+            active[p] = true;
+            if (!ordered.test(id))
+                newNodes[p].push_back(id);
+        }
+    }
+}
+
+template <typename Ctx>
+void CtxSensitive<Ctx>::collectStat(CtxSensitiveStat *ctxStat) {
+    // contexts of the nodes, a function has as many contexts as its most cloned node
+    u32_t maxCloneFactor = 0;
+    for (auto it = pag->begin(), eit = pag->end(); it != eit; ++it) {
+        u32_t numOfClones = ctxPAG->getCtxSenIDs(it->first).size();
+        ctxStat->ctxPerNode[numOfClones]++;
+        if (const llvm::Function *func = CallSitePAG::getOwnerFunction(it->second)) {
+            u32_t &funcClones = ctxStat->funcClones[func->getName().str()];
+            funcClones = std::max(funcClones, numOfClones);
+            maxCloneFactor = std::max(maxCloneFactor, numOfClones);
+        }
+    }
+
+    u64_t totalPtsSize = 0;
+    u32_t maxPtsSize = 0;
+    for (auto it = ctxPAG->begin(), eit = ctxPAG->end(); it != eit; ++it) {
+        u32_t size = getCtxPts(sccRepNode(it->first)).count();
+        ctxStat->ptsSizes[CtxSensitiveStat::getPtsSizeBucket(size)]++;
+        totalPtsSize += size;
+        maxPtsSize = std::max(maxPtsSize, size);
+    }
+
+    u32_t numOfSharedSets = 0;
+    for (SharedPTDataTy &data : ptData)
+        numOfSharedSets += data.getNumOfSharedSets();
+
+    for (u32_t p = 0; p < timeOfPartitions.size(); p++)
+        ctxStat->partitionTimes.push_back(std::make_pair(getPartitionName(p), timeOfPartitions[p]));
+
+    PTAStat::TIMEStatMap &timeStatMap = ctxStat->ctxTimeStatMap;
+    timeStatMap[CtxSensitiveStat::PreAnalysisTime] = timeOfPreAnalysis;
+    timeStatMap[CtxSensitiveStat::BuildCtxPAGTime] = timeOfBuildCtxPAG;
+    timeStatMap[CtxSensitiveStat::SolvingTime] = timeOfSolving;
+    timeStatMap[PTAStat::SCCDetectionTime] = timeOfSCCDetection;
+    timeStatMap[PTAStat::SCCMergeTime] = timeOfSCCMerges;
+    timeStatMap[PTAStat::ProcessCopyGepTime] = timeOfProcessCopyGep;
+    timeStatMap[PTAStat::ProcessLoadStoreTime] = timeOfProcessLoadStore;
+    timeStatMap[PTAStat::UpdateCallGraphTime] = timeOfUpdateCallGraph;
+    timeStatMap[CtxSensitiveStat::ProjectionTime] = timeOfProjection;
+    timeStatMap[PTAStat::AveragePointsToSetSize] = ctxPAG->getTotalNodeNum() == 0 ? 0 :
+            (double)totalPtsSize / ctxPAG->getTotalNodeNum();
+    timeStatMap[CtxSensitiveStat::AverageCloneFactor] = pag->getTotalNodeNum() == 0 ? 0 :
+            (double)ctxPAG->getTotalNodeNum() / pag->getTotalNodeNum();
+
+    PTAStat::NUMStatMap &numStatMap = ctxStat->ctxNumStatMap;
+    numStatMap[CtxSensitiveStat::NumOfCtxPAGNodes] = ctxPAG->getTotalNodeNum();
+    numStatMap[CtxSensitiveStat::NumOfCtxPAGObjNodes] = ctxPAG->getObjNodeNum();
+    numStatMap[CtxSensitiveStat::NumOfCtxPAGPtrNodes] = ctxPAG->getPtrNodeNum();
+    numStatMap[CtxSensitiveStat::NumOfCtxPAGEdges] = ctxPAG->getTotalEdgeNum();
+    numStatMap[CtxSensitiveStat::NumOfCtxCGNodes] = this->graph()->getTotalNodeNum();
+    numStatMap[CtxSensitiveStat::MaxCloneFactor] = maxCloneFactor;
+    numStatMap[PTAStat::MaxPointsToSetSize] = maxPtsSize;
+    numStatMap[CtxSensitiveStat::NumOfSharedPtsSets] = numOfSharedSets;
+    numStatMap[PTAStat::NumOfProcessedAddrs] = numOfProcessedAddr;
+    numStatMap[PTAStat::NumOfProcessedCopys] = numOfProcessedCopy;
+    numStatMap[PTAStat::NumOfProcessedGeps] = numOfProcessedGep;
+    numStatMap[PTAStat::NumOfProcessedLoads] = numOfProcessedLoad;
+    numStatMap[PTAStat::NumOfProcessedStores] = numOfProcessedStore;
+    numStatMap[PTAStat::NumOfIterations] = numOfIteration;
+    numStatMap[PTAStat::NumOfSCCDetection] = numOfSCCDetection;
+    numStatMap[PTAStat::NumOfIndirectEdgeSolved] = getNumOfResolvedIndCallEdge();
+    numStatMap[CtxSensitiveStat::NumOfPartitions] = numOfPartitions;
+    numStatMap[CtxSensitiveStat::NumOfPartitionRounds] = numOfPartitionRounds;
+    if (selection != nullptr) {
+        numStatMap[CtxSensitiveStat::NumOfInsensitiveFuncs] = selection->getNumOfInsensitiveFuncs();
+        numStatMap[CtxSensitiveStat::NumOfInsensitiveObjs] = selection->getNumOfInsensitiveObjs();
+    }
+}
+
+/*!
+ * Clones keep their context-insensitive node, so the mapping is looked up once and never invalidated,
+ * also for the clones added while solving
+ */
+template <typename Ctx>
+NodeID CtxSensitive<Ctx>::getInsensID(NodeID ctxId) {
+    if (ctxId >= ctxToInsensID.size())
+        ctxToInsensID.resize(std::max<size_t>(ctxId + 1, ctxPAG->getTotalNodeNum()), UINT_MAX);
+    NodeID &insensId = ctxToInsensID[ctxId];
+    if (insensId == UINT_MAX)
+        insensId = ctxPAG->getGNode(ctxId)->getInnerNode()->getId();
+    return insensId;
+}
+
+template <typename Ctx>
+void CtxSensitive<Ctx>::projectPts(const PointsTo &ctxPts, PointsTo &pts) {
+    for (NodeID obj : ctxPts) {
+        pts.set(getInsensID(obj));
+    }
+}
+
+/*!
+ * O(number of contexts of pagId) on the first query, cached afterwards
+ */
+template <typename Ctx>
+PointsTo& CtxSensitive<Ctx>::getPts(NodeID pagId) {
+    auto it = projectedPtsMap.find(pagId);
+    if (it != projectedPtsMap.end())
+        return it->second;
+
+    PointsTo &pts = projectedPtsMap[pagId];
+    for (NodeID clone : ctxPAG->getCtxSenIDs(pagId)) {
+        projectPts(getCtxPts(sccRepNode(clone)), pts);
+    }
+    return pts;
+}
+
+template <typename Ctx>
+NodeID CtxSensitive<Ctx>::getCtxNode(NodeID pagId, const Ctx &ctx) const {
+    if (ctxPAG->hasCtxNode(pagId, ctx))
+        return ctxPAG->getCtxNode(pagId, ctx)->getId();
+    if (ctxPAG->hasCtxNode(pagId, Ctx::emptyCtx()))
+        return ctxPAG->getCtxNode(pagId, Ctx::emptyCtx())->getId();
+    return UINT_MAX;
+}
+
+template <typename Ctx>
+PointsTo CtxSensitive<Ctx>::getPts(NodeID pagId, const Ctx &ctx) {
+    PointsTo pts;
+    NodeID clone = getCtxNode(pagId, ctx);
+    if (clone != UINT_MAX)
+        projectPts(getCtxPts(sccRepNode(clone)), pts);
+    return pts;
+}
+
+template <typename Ctx>
+llvm::AliasResult CtxSensitive<Ctx>::alias(NodeID pagId1, const Ctx &ctx1, NodeID pagId2, const Ctx &ctx2) {
+    NodeID clone1 = getCtxNode(pagId1, ctx1);
+    NodeID clone2 = getCtxNode(pagId2, ctx2);
+    if (clone1 == UINT_MAX || clone2 == UINT_MAX)
+        return llvm::NoAlias;
+
+    const PointsTo& pts1 = getCtxPts(sccRepNode(clone1));
+    const PointsTo& pts2 = getCtxPts(sccRepNode(clone2));
+    if (containBlackHoleNode(pts1) || containBlackHoleNode(pts2) || pts1.intersects(pts2))
+        return llvm::MayAlias;
+    return llvm::NoAlias;
+}
+
 template <typename Ctx>
 void CtxSensitive<Ctx>::processNode(NodeID nodeId) {
     numOfIteration++;
+    collectGarbage();
 
     CtxConstraintNode<Ctx>* node = this->graph()->getConstraintNode(nodeId);
 
@@ -336,7 +969,7 @@ void CtxSensitive<Ctx>::processNode(NodeID nodeId) {
         processAddr(cast<CtxAddrCGEdge<Ctx>>(*it));
     }
 
-    for (PointsTo::iterator piter = getPts(nodeId).begin(); piter != getPts(nodeId).end(); ++piter) {
+    for (PointsTo::iterator piter = getCtxPts(nodeId).begin(); piter != getCtxPts(nodeId).end(); ++piter) {
         NodeID ptd = *piter;
         // handle load
         for (auto it = node->outgoingLoadsBegin(); it != node->outgoingLoadsEnd(); ++it) {
@@ -371,9 +1004,34 @@ private:
 public:
     CtxSensitiveWave() : CtxSensitive<Ctx>(PointerAnalysis::ORIGIN_PTA) {}
 
+    /// Copy/gep propagation is split by partition if there is more than one, load/store is sequential
+    void solve() override {
+        NodeStack &nodeStack = this->SCCDetect();
+
+        double copyGepStart = PTAStat::getClk();
+        if (this->numOfPartitions == 1) {
+            while (!nodeStack.empty()) {
+                NodeID nodeId = nodeStack.top();
+                nodeStack.pop();
+                processNode(nodeId);
+            }
+        } else {
+            this->solvePartitions(nodeStack);
+        }
+        double copyGepEnd = PTAStat::getClk();
+        this->timeOfProcessCopyGep += (copyGepEnd - copyGepStart) / TIMEINTERVAL;
+
+        while (!this->isWorklistEmpty()) {
+            NodeID nodeId = this->popFromWorklist();
+            postProcessNode(nodeId);
+        }
+        this->timeOfProcessLoadStore += (PTAStat::getClk() - copyGepEnd) / TIMEINTERVAL;
+    }
+
     void processNode(NodeID nodeId) override {
         if (this->sccRepNode(nodeId) != nodeId)
             return;
+        this->collectGarbage();
 
         CtxConstraintNode<Ctx> *node = this->graph()->getConstraintNode(nodeId);
 
@@ -381,6 +1039,7 @@ public:
     }
 
     void postProcessNode(NodeID nodeId) override {
+        this->collectGarbage();
         CtxConstraintNode<Ctx> *node = this->graph()->getConstraintNode(nodeId);
         // handle load
         for (auto it = node->outgoingLoadsBegin(), eit = node->outgoingLoadsEnd();
@@ -409,7 +1068,7 @@ public:
 
     virtual bool handleLoad(NodeID id, const CtxConstraintEdge<Ctx>* load) {
         bool changed = false;
-        for (auto piter = this->getPts(id).begin(), epiter = this->getPts(id).end();
+        for (auto piter = this->getCtxPts(id).begin(), epiter = this->getCtxPts(id).end();
              piter != epiter; ++piter) {
             if (this->processLoad(*piter, load)) {
                 changed = true;
@@ -420,7 +1079,7 @@ public:
 
     virtual bool handleStore(NodeID id, const CtxConstraintEdge<Ctx>* store) {
         bool changed = false;
-        for (auto piter = this->getPts(id).begin(), epiter = this->getPts(id).end();
+        for (auto piter = this->getCtxPts(id).begin(), epiter = this->getCtxPts(id).end();
              piter != epiter; ++piter) {
             if (this->processStore(*piter, store)) {
                 changed = true;
@@ -440,19 +1099,18 @@ class CtxSensitiveWaveDiff : public CtxSensitiveWave<Ctx> {
 
 private:
     PointsTo & getCachePts(const CtxConstraintEdge<Ctx>* edge) {
-        EdgeID edgeId = edge->getEdgeID();
-        return this->getDiffPTDataTy()->getCachePts(edgeId);
+        return this->getSharedPTData(edge->getSrcID()).getCachePts(edge->getEdgeID());
     }
 
     /// Handle diff points-to set.
     //@{
     virtual inline void computeDiffPts(NodeID id) {
         NodeID rep = this->sccRepNode(id);
-        this->getDiffPTDataTy()->computeDiffPts(rep, this->getDiffPTDataTy()->getPts(rep));
+        this->getSharedPTData(rep).computeDiffPts(rep);
     }
     virtual inline PointsTo& getDiffPts(NodeID id) {
         NodeID rep = this->sccRepNode(id);
-        return this->getDiffPTDataTy()->getDiffPts(rep);
+        return this->getSharedPTData(rep).getDiffPts(rep);
     }
     //@}
 
@@ -461,11 +1119,15 @@ private:
     inline void updatePropaPts(NodeID dst, NodeID src) {
         NodeID srcRep = this->sccRepNode(src);
         NodeID dstRep = this->sccRepNode(dst);
-        this->getDiffPTDataTy()->updatePropaPtsMap(srcRep, dstRep);
+        if (this->getPartition(srcRep) == this->getPartition(dstRep))
+            this->getSharedPTData(dstRep).updatePropaPtsMap(srcRep, dstRep);
+        else
+            // the propagated points-to of srcRep is in another partition, propagate all of dstRep again
+            this->getSharedPTData(dstRep).clearPropaPts(dstRep);
     }
     inline void clearPropaPts(NodeID src) {
         NodeID rep = this->sccRepNode(src);
-        this->getDiffPTDataTy()->clearPropaPts(rep);
+        this->getSharedPTData(rep).clearPropaPts(rep);
     }
     //@}
 
@@ -503,7 +1165,7 @@ public:
     bool handleLoad(NodeID id, const CtxConstraintEdge<Ctx>* load) override {
         /// calculate diff pts.
         PointsTo & cache = getCachePts(load);
-        PointsTo & pts = this->getPts(id);
+        const PointsTo& pts = this->getCtxPts(id);
         PointsTo newPts;
         newPts.intersectWithComplement(pts, cache);
         cache |= newPts;
@@ -522,7 +1184,7 @@ public:
     bool handleStore(NodeID id, const CtxConstraintEdge<Ctx>* store) override {
         /// calculate diff pts.
         PointsTo & cache = getCachePts(store);
-        PointsTo & pts = this->getPts(id);
+        const PointsTo& pts = this->getCtxPts(id);
         PointsTo newPts;
         newPts.intersectWithComplement(pts, cache);
         cache |= newPts;
@@ -562,18 +1224,52 @@ protected:
     virtual void processCast(const ConstraintEdge *edge) {
         return;
     }
+
+    /// forget what was propagated, so that the whole points-to set is the diff in the next round
+    void repropagate(NodeID id) override {
+        clearPropaPts(id);
+        this->pushIntoWorklist(id);
+    }
 };
 
 
 class OriginSensitive : public CtxSensitiveWaveDiff<OriginID> {
+private:
+    OriginPAG *originPAG = nullptr;
+
 protected:
+    /// One partition per origin, and one for the nodes without origin (globals and the objects shared by the origins)
+    //@{
+    u32_t getNumOfPartitions() override {
+        return originPAG->getNumOfOrigins() + 1;
+    }
+    u32_t partitionOf(CtxPAGNode<OriginID> *node) override {
+        OriginID origin = node->getContext();
+        return origin.isEmptyCtx() ? originPAG->getNumOfOrigins() : origin.getID();
+    }
+    std::string getPartitionName(u32_t partition) override {
+        if (partition == originPAG->getNumOfOrigins())
+            return "no origin";
+        if (partition == 0)
+            return "main";
+        return originPAG->getOriginEntry(partition)->getName().str();
+    }
+    //@}
+
     CtxPAG<OriginID>* buildCtxPAG(SVFModule module, PTACallGraph *callGraph) override {
+        // origins are marked once, before solving
+        assert(CtxSensitiveOptions::getCallGraphKind() == CtxSensitiveOptions::AndersenCallGraph &&
+               "origin sensitivity needs the Andersen call graph (-ctx-callgraph=andersen)");
         auto *oPAG = new OriginPAG(module, callGraph);
+        originPAG = oPAG;
+        oPAG->setSelection(selection);
         oPAG->initFromPAG(Andersen::pag);
 
-        printf("Insensitive:\n Number of Node: %ld\n Number of Edge: %ld\n",Andersen::pag->getTotalNodeNum(), Andersen::pag->getTotalEdgeNum());
-        printf("Origin:\n Number of Node: %ld\n Object Node: %lld\n Pointer Node: %lld\n Number of Edge: %ld\n",
-               oPAG->getTotalNodeNum(), oPAG->getObjNodeNum(), oPAG->getPtrNodeNum(), oPAG->getTotalEdgeNum());
+        DBOUT(DPAGBuild, llvm::outs() << "Insensitive:\n Number of Node: " << Andersen::pag->getTotalNodeNum()
+              << "\n Number of Edge: " << Andersen::pag->getTotalEdgeNum() << "\n");
+        DBOUT(DPAGBuild, llvm::outs() << "Origin:\n Number of Node: " << oPAG->getTotalNodeNum()
+              << "\n Object Node: " << oPAG->getObjNodeNum() << "\n Pointer Node: " << oPAG->getPtrNodeNum()
+              << "\n Number of Edge: " << oPAG->getTotalEdgeNum() << "\n");
 
         //oPAG->dump(oPAG->getGraphName());
         return oPAG;
@@ -581,17 +1277,29 @@ protected:
 
 public:
     OriginSensitive() : CtxSensitiveWaveDiff<OriginID> () {}
+
+    /// Origin of an entry function (e.g. a thread's start routine), the default origin (main) otherwise
+    inline OriginID getOriginOfEntry(const llvm::Function *func) const {
+        return OriginID(originPAG->getOriginOfEntry(func));
+    }
 };
 
 class CallSiteSensitive : public CtxSensitiveWaveDiff<ctx::CallSite> {
 protected:
     CtxPAG<ctx::CallSite>* buildCtxPAG(SVFModule module, PTACallGraph *callGraph) override {
-        auto *csPAG = new CallSitePAG(module, callGraph);
+        // contexts of callees resolved while solving only exist if the reachable instances are cloned
+        // so do the single instances of the functions without contexts
+        bool cloneReachable = CtxSensitiveOptions::cloneReachableOnly() || CtxSensitiveOptions::selectContexts() ||
+                        CtxSensitiveOptions::getCallGraphKind() != CtxSensitiveOptions::AndersenCallGraph;
+        auto *csPAG = new CallSitePAG(module, callGraph, cloneReachable);
+        csPAG->setSelection(selection);
         csPAG->initFromPAG(Andersen::pag);
 
-        printf("Insensitive:\n Number of Node: %ld\n Number of Edge: %ld\n",Andersen::pag->getTotalNodeNum(), Andersen::pag->getTotalEdgeNum());
-        printf("CallSite:\n Number of Node: %ld\n Object Node: %lld\n Pointer Node: %lld\n Number of Edge: %ld\n",
-                csPAG->getTotalNodeNum(), csPAG->getObjNodeNum(), csPAG->getPtrNodeNum(), csPAG->getTotalEdgeNum());
+        DBOUT(DPAGBuild, llvm::outs() << "Insensitive:\n Number of Node: " << Andersen::pag->getTotalNodeNum()
+              << "\n Number of Edge: " << Andersen::pag->getTotalEdgeNum() << "\n");
+        DBOUT(DPAGBuild, llvm::outs() << "CallSite:\n Number of Node: " << csPAG->getTotalNodeNum()
+              << "\n Object Node: " << csPAG->getObjNodeNum() << "\n Pointer Node: " << csPAG->getPtrNodeNum()
+              << "\n Number of Edge: " << csPAG->getTotalEdgeNum() << "\n");
 
         //csPAG->dump(csPAG->getGraphName());
         return csPAG;
@@ -42,12 +42,11 @@ class SVFModule;
 typedef WPAFSSolver<SVFG*> WPASVFGFSSolver;
 class FlowSensitive : public WPASVFGFSSolver, public BVDataPTAImpl {
     friend class FlowSensitiveStat;
-private:
+protected:
     typedef SVFG::SVFGEdgeSetTy SVFGEdgeSetTy;
 
 public:
-    typedef BVDataPTAImpl::IncDFPTDataTy::DFPtsMap DFInOutMap;
-    typedef BVDataPTAImpl::IncDFPTDataTy::PtsMap PtsMap;
+    typedef BVDataPTAImpl::IncDFPTDataTy::VarList DFVarList;
 
     /// Constructor
     FlowSensitive(PTATY type = FSSPARSE_WPA) : WPASVFGFSSolver(), BVDataPTAImpl(type)
@@ -100,6 +99,9 @@ public:
     /// Finalize analysis
     virtual void finalize();
 
+    /// Number the address-taken variables of each SVFG node for the IN/OUT sets
+    void initDFVars();
+
     /// Get PTA name
     virtual const std::string PTAName() const {
         return "FlowSensitive";
@@ -111,7 +113,7 @@ public:
         return true;
     }
     static inline bool classof(const PointerAnalysis *pta) {
-        return pta->getAnalysisTy() == FSSPARSE_WPA;
+        return pta->getAnalysisTy() == FSSPARSE_WPA || pta->getAnalysisTy() == VFS_WPA;
     }
     //@}
 
@@ -124,6 +126,16 @@ protected:
     /// SCC detection
     virtual NodeStack& SCCDetect();
 
+    /// Constraint solving, level by level with -fs-parallel
+    virtual void solve();
+
+    /// Solve the SVFG one SCC level at a time, the level of an SCC being the longest path to it from a root SCC.
+    /// The SCCs of one level do not depend on each other:
+    ///  - single-node SCCs are processed one after the other (top-level points-to and the PAG are shared),
+    ///    then the IN sets of their successors are updated in parallel, one task per successor,
+    ///  - SCCs with more than one node are then solved to a fixed point one after the other.
+    void solveByLevels();
+
     /// Propagation
     //@{
     /// Propagate points-to information from an edge's src node to its dst node.
@@ -195,8 +207,8 @@ protected:
     bool processCopy(const CopySVFGNode* copy);
     bool processPhi(const PHISVFGNode* phi);
     bool processGep(const GepSVFGNode* edge);
-    bool processLoad(const LoadSVFGNode* load);
-    bool processStore(const StoreSVFGNode* store);
+    virtual bool processLoad(const LoadSVFGNode* load);
+    virtual bool processStore(const StoreSVFGNode* store);
     //@}
 
     /// Update call graph
@@ -213,6 +225,7 @@ protected:
     bool isStrongUpdate(const SVFGNode* node, NodeID& singleton);
 
     SVFG* svfg;
+    SVFGBuilder memSSA;
 private:
     ///Get points-to set for a node from data flow IN/OUT set at a statement.
     //@{
@@ -224,19 +237,25 @@ private:
     }
     //@}
 
-    ///Get IN/OUT data flow map;
+    ///Get IN/OUT data flow sets;
     //@{
-    inline const DFInOutMap& getDFInputMap() const {
-        return getDFPTDataTy()->getDFIn();
+    inline NodeID getNumOfDFLocs() const {
+        return getDFPTDataTy()->getNumOfLocs();
+    }
+    inline bool hasDFInSet(NodeID loc) const {
+        return getDFPTDataTy()->hasDFInSet(loc);
+    }
+    inline bool hasDFOutSet(NodeID loc) const {
+        return getDFPTDataTy()->hasDFOutSet(loc);
     }
-    inline const DFInOutMap& getDFOutputMap() const {
-        return getDFPTDataTy()->getDFOut();
+    inline const DFVarList& getDFVars(NodeID loc) const {
+        return getDFPTDataTy()->getDFVars(loc);
     }
     //@}
 
     static FlowSensitive* fspta;
-    SVFGBuilder memSSA;
 
+protected:
     /// Statistics.
     //@{
     Size_t numOfProcessedAddr;	/// Number of processed Addr node
@@ -0,0 +1,156 @@
+//===- VersionedFlowSensitive.h -- Versioned flow-sensitive analysis----------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SVF_ORIGIN_VERSIONEDFLOWSENSITIVE_H
+#define SVF_ORIGIN_VERSIONEDFLOWSENSITIVE_H
+
+#include "WPA/FlowSensitive.h"
+
+#include <llvm/ADT/DenseMap.h>
+
+#include <vector>
+
+/*!
+ * Versioned (staged) flow-sensitive analysis.
+ * Before solving, every (SVFG node, object) is labelled with the version of the object it consumes,
+ * versions are derived from the definitions reaching the node along the indirect edges (MemSSA def-use chains):
+ *  - a store yields a new version of each object it may define,
+ *  - a node whose incoming edges may grow on the fly (formal-in of an address-taken function,
+ *    actual-out of an indirect call site) consumes a new version,
+ *  - every other node consumes the meld of the versions yielded by its predecessors and yields what it consumes.
+ * Nodes reached by the same definitions share one version and one points-to set, points-to is propagated
+ * between versions instead of along every indirect edge, and only loads/stores consuming a changed version are
+ * processed again.
+ */
+class VersionedFlowSensitive : public FlowSensitive {
+public:
+    typedef u32_t Version;
+    typedef llvm::DenseMap<NodeID, Version> ObjToVersionMap;
+
+    static const Version InvalidVersion = ~0U;
+
+    /// Constructor
+    VersionedFlowSensitive() : FlowSensitive(VFS_WPA), numOfPrelabels(0), numOfVersions(0),
+        numOfVersionPropagations(0), prelabelTime(0) {
+    }
+
+    /// Initialize analysis
+    virtual void initialize(SVFModule svfModule);
+
+    /// Finalize analysis
+    virtual void finalize();
+
+    /// Get PTA name
+    virtual const std::string PTAName() const {
+        return "VersionedFlowSensitive";
+    }
+
+    /// Methods for support type inquiry through isa, cast, and dyn_cast
+    //@{
+    static inline bool classof(const VersionedFlowSensitive *) {
+        return true;
+    }
+    static inline bool classof(const PointerAnalysis *pta) {
+        return pta->getAnalysisTy() == VFS_WPA;
+    }
+    //@}
+
+protected:
+    /// Points-to of the objects are propagated between versions, nothing to do per indirect edge
+    virtual bool propAlongIndirectEdge(const IndirectSVFGEdge* edge) {
+        return false;
+    }
+
+    /// Handle load/store over versions
+    //@{
+    virtual bool processLoad(const LoadSVFGNode* load);
+    virtual bool processStore(const StoreSVFGNode* store);
+    //@}
+
+    /// Link the versions along the indirect edges connected on the fly
+    virtual void updateConnectedNodes(const SVFGEdgeSetTy& edges);
+
+private:
+    /// Versions of one object
+    struct ObjVersions {
+        std::vector<PointsTo> pts;                  ///< points-to of each version
+        std::vector<std::vector<Version>> reliance; ///< versions including the points-to of a version
+        std::vector<NodeBS> stmtReliance;           ///< loads/stores consuming a version
+    };
+    typedef llvm::DenseMap<NodeID, ObjVersions> ObjToVersionsMap;
+
+    /// Pre-labelling
+    //@{
+    /// Label the objects of every node, then number the distinct labels of each object as versions
+    void prelabel();
+    /// Whether new incoming indirect edges of node may be connected while solving
+    bool isDeltaNode(const SVFGNode* node) const;
+    /// Objects carried by an indirect edge, including the fields of field-insensitive objects
+    void collectObjects(const IndirectSVFGEdge* edge, PointsTo& objs);
+    /// Objects carried by the incoming or outgoing indirect edges of node
+    void collectObjects(const SVFGNode* node, bool incoming, PointsTo& objs);
+    //@}
+
+    /// Versions consumed/yielded by node for obj
+    //@{
+    inline Version getConsume(NodeID node, NodeID obj) const {
+        if (node >= consume.size())
+            return InvalidVersion;
+        const ObjToVersionMap& versions = consume[node];
+        ObjToVersionMap::const_iterator it = versions.find(obj);
+        return it == versions.end() ? InvalidVersion : it->second;
+    }
+    inline Version getYield(const SVFGNode* node, NodeID obj) const {
+        if (!llvm::isa<StoreSVFGNode>(node))
+            return getConsume(node->getId(), obj);
+        const ObjToVersionMap& versions = yield[node->getId()];
+        ObjToVersionMap::const_iterator it = versions.find(obj);
+        return it == versions.end() ? InvalidVersion : it->second;
+    }
+    //@}
+
+    /// Points-to of versions
+    //@{
+    inline const PointsTo& getVersionPts(NodeID obj, Version version) {
+        return objVersions[obj].pts[version];
+    }
+    /// union (pts(obj:dst), pts(obj:src)), followed by propagating pts(obj:dst) if it changed
+    bool unionVersionPts(NodeID obj, Version dst, Version src);
+    /// union (pts(obj:dst), pts), followed by propagating pts(obj:dst) if it changed
+    bool unionVersionPts(NodeID obj, Version dst, const PointsTo& pts);
+    /// Propagate a changed version to the versions relying on it and schedule the statements consuming them
+    void propagateVersion(NodeID obj, Version version);
+    /// Make dst include src from now on
+    void addReliance(NodeID obj, Version src, Version dst);
+    //@}
+
+    std::vector<ObjToVersionMap> consume;	///< version of each object consumed by a node, indexed by SVFG node
+    std::vector<ObjToVersionMap> yield;	///< version of each object yielded by a store, indexed by SVFG node
+    ObjToVersionsMap objVersions;
+
+    u32_t numOfPrelabels;
+    u32_t numOfVersions;
+    Size_t numOfVersionPropagations;
+    double prelabelTime;	///< time of pre-labelling
+};
+
+#endif //SVF_ORIGIN_VERSIONEDFLOWSENSITIVE_H
@@ -34,6 +34,8 @@
 #include "Util/PTAStat.h"
 #include "WPA/FlowSensitive.h"
 
+#include <vector>
+
 class Andersen;
 class PAG;
 class ConstraintGraph;
@@ -76,13 +78,67 @@ public:
     void statNullPtr();
 };
 
+/*!
+ * Statistics of the context-sensitive analyses (CtxSensitive).
+ * The analysis is a template over its context, so it fills in the numbers itself (CtxSensitive::collectStat)
+ * before performStat(), which prints them and writes them as JSON if asked to (-ctx-stat-json).
+ */
+class CtxSensitiveStat : public PTAStat {
+public:
+    typedef std::map<u32_t, u32_t> Histogram;  ///< value (lower bound of a bucket) -> count
+    typedef std::map<std::string, u32_t> FuncToNumMap;
+    typedef std::vector<std::pair<std::string, double>> PartitionTimes;
+
+    static const char* PreAnalysisTime;
+    static const char* BuildCtxPAGTime;
+    static const char* SolvingTime;
+    static const char* ProjectionTime;
+    static const char* AverageCloneFactor;
+    static const char* NumOfCtxPAGNodes;
+    static const char* NumOfCtxPAGObjNodes;
+    static const char* NumOfCtxPAGPtrNodes;
+    static const char* NumOfCtxPAGEdges;
+    static const char* NumOfCtxCGNodes;
+    static const char* MaxCloneFactor;
+    static const char* NumOfSharedPtsSets;
+    static const char* NumOfPartitions;
+    static const char* NumOfPartitionRounds;
+    static const char* NumOfInsensitiveFuncs;
+    static const char* NumOfInsensitiveObjs;
+    static const char* PeakRSS;
+
+    /// Filled by the analysis
+    //@{
+    NUMStatMap ctxNumStatMap;
+    TIMEStatMap ctxTimeStatMap;
+    FuncToNumMap funcClones;            ///< function -> number of its contexts
+    Histogram ctxPerNode;               ///< number of contexts -> number of PAG nodes with that many clones
+    Histogram ptsSizes;                 ///< points-to size (powers of 2 buckets) -> number of clones
+    PartitionTimes partitionTimes;      ///< partition (origin) -> wall time spent solving it
+    //@}
+
+    CtxSensitiveStat(PointerAnalysis* p) : PTAStat(p) {
+        startClk();
+    }
+
+    virtual ~CtxSensitiveStat() {}
+
+    /// Bucket of a points-to size: 0, 1, 2-3, 4-7, ...
+    static u32_t getPtsSizeBucket(u32_t size);
+
+    virtual void performStat();
+
+    virtual void printStat();
+
+    void writeJSON(const std::string& fileName) const;
+};
+
 /*!
  * Statistics of flow-sensitive analysis
  */
 class FlowSensitiveStat : public PTAStat {
 public:
-    typedef FlowSensitive::DFInOutMap DFInOutMap;
-    typedef FlowSensitive::PtsMap PtsMap;
+    typedef FlowSensitive::DFVarList DFVarList;
 
     FlowSensitive * fspta;
 
@@ -113,7 +169,7 @@ private:
 
     void calculateAddrVarPts(NodeID pointer, const SVFGNode* node);
 
-    void statInOutPtsSize(const DFInOutMap& data, ENUM_INOUT inOrOut);
+    void statInOutPtsSize(ENUM_INOUT inOrOut);
 
     u32_t _NumOfNullPtr;
     u32_t _NumOfConstantPtr;
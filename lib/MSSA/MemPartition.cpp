@@ -33,8 +33,17 @@
  */
 
 #include "MSSA/MemPartition.h"
+
+#include <llvm/Support/CommandLine.h>
+
 using namespace llvm;
 
+static cl::opt<unsigned> MRMaxSize("mr-max-size", cl::init(32),
+                                   cl::desc("Maximum number of objects in a region merged by -mempar=clustered"));
+
+static cl::opt<double> MRCoAccess("mr-coaccess", cl::init(0.5),
+                                  cl::desc("Minimum similarity (shared/all accesses) of objects merged into one region by -mempar=clustered"));
+
 /**
  * Create distinct memory regions.
  */
@@ -278,3 +287,80 @@ void InterDisjointMRG::partitionMRs()
         }
     }
 }
+
+/*-----------------------------------------------------*/
+
+void ClusteredMRG::partitionMRs()
+{
+    for(FunToPointsToMap::iterator it = getFunToPointsToList().begin(),
+            eit = getFunToPointsToList().end(); it!=eit; ++it) {
+        const Function* fun = it->first;
+
+        /// Objects accessed by the same loads/stores/callsites
+        PointsToList disjoints;
+        for(PointsToList::iterator cit = it->second.begin(), ecit = it->second.end();
+                cit!=ecit; ++cit) {
+            computeIntersections(*cit, disjoints);
+        }
+
+        PointsToList clusters;
+        clusterObjects(it->second, disjoints, clusters);
+
+        /// Create memory regions.
+        for (PointsToList::const_iterator clusterIt = clusters.begin(), clusterEit = clusters.end();
+                clusterIt != clusterEit; ++clusterIt) {
+            createDisjointMR(fun, *clusterIt);
+        }
+    }
+}
+
+/**
+ * Greedily merge each disjoint set into the cluster whose accesses are the most similar to its own,
+ * similarity is the number of accesses of both over the number of accesses of either.
+ * A disjoint set is either contained in or disjoint from every access, so its accesses are the ones containing it.
+ */
+void ClusteredMRG::clusterObjects(const PointsToList& accesses, const PointsToList& disjoints, PointsToList& clusters)
+{
+    std::vector<PointsTo> clusterObjs;
+    std::vector<NodeBS> clusterAccesses;
+
+    for (PointsToList::const_iterator it = disjoints.begin(), eit = disjoints.end(); it != eit; ++it) {
+        const PointsTo& disjoint = *it;
+
+        NodeBS disjointAccesses;
+        u32_t accessId = 0;
+        for (PointsToList::const_iterator ait = accesses.begin(), aeit = accesses.end(); ait != aeit; ++ait, ++accessId) {
+            if (ait->contains(disjoint))
+                disjointAccesses.set(accessId);
+        }
+
+        u32_t size = disjoint.count();
+        u32_t numOfAccesses = disjointAccesses.count();
+        s32_t best = -1;
+        double bestSimilarity = 0;
+        for (u32_t i = 0; i < clusterObjs.size() && size < MRMaxSize; i++) {
+            if (clusterObjs[i].count() + size > MRMaxSize)
+                continue;
+            NodeBS shared = disjointAccesses;
+            shared &= clusterAccesses[i];
+            u32_t numOfShared = shared.count();
+            u32_t numOfAll = numOfAccesses + clusterAccesses[i].count() - numOfShared;
+            double similarity = numOfAll == 0 ? 0 : (double)numOfShared / numOfAll;
+            if (similarity >= MRCoAccess && similarity > bestSimilarity) {
+                best = i;
+                bestSimilarity = similarity;
+            }
+        }
+
+        if (best == -1) {
+            clusterObjs.push_back(disjoint);
+            clusterAccesses.push_back(disjointAccesses);
+        }
+        else {
+            clusterObjs[best] |= disjoint;
+            clusterAccesses[best] |= disjointAccesses;
+        }
+    }
+
+    clusters.insert(clusterObjs.begin(), clusterObjs.end());
+}
@@ -39,7 +39,7 @@ using namespace llvm;
 using namespace analysisUtil;
 
 Size_t MemRegion::totalMRNum = 0;
-Size_t MRVer::totalVERNum = 0;
+std::atomic<Size_t> MRVer::totalVERNum(0);
 
 static cl::opt<bool> IgnoreDeadFun("mssa-ignoreDeadFun", cl::init(false),
                                    cl::desc("Don't construct memory SSA for deadfunction"));
@@ -80,6 +80,24 @@ void MRGenerator::createMR(const Function* fun, const PointsTo& cpts) {
     }
 }
 
+/*!
+ * Count the regions and the mus/chis of loads/stores/callsites
+ */
+MRGenerator::MRCost MRGenerator::getCost() const {
+    MRCost cost = {memRegSet.size(), 0, 0, 0, 0, 0};
+    for (MRSet::const_iterator it = memRegSet.begin(), eit = memRegSet.end(); it != eit; ++it)
+        cost.maxMRSize = std::max(cost.maxMRSize, (Size_t)(*it)->getRegionSize());
+    for (LoadsToMRsMap::const_iterator it = loadsToMRsMap.begin(), eit = loadsToMRsMap.end(); it != eit; ++it)
+        cost.numOfLoadMus += it->second.size();
+    for (StoresToMRsMap::const_iterator it = storesToMRsMap.begin(), eit = storesToMRsMap.end(); it != eit; ++it)
+        cost.numOfStoreChis += it->second.size();
+    for (CallSiteToMRsMap::const_iterator it = callsiteToRefMRsMap.begin(), eit = callsiteToRefMRsMap.end(); it != eit; ++it)
+        cost.numOfCallSiteMus += it->second.size();
+    for (CallSiteToMRsMap::const_iterator it = callsiteToModMRsMap.begin(), eit = callsiteToModMRsMap.end(); it != eit; ++it)
+        cost.numOfCallSiteChis += it->second.size();
+    return cost;
+}
+
 /*!
  * Generate a memory region and put in into functions which use it
  */
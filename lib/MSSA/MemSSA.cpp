@@ -39,6 +39,9 @@
 #include <llvm/Support/raw_ostream.h>	// for output
 #include <llvm/Support/CommandLine.h>
 
+#include <iomanip>
+#include <iostream>
+
 using namespace llvm;
 using namespace analysisUtil;
 
@@ -49,10 +52,57 @@ static cl::opt<string> MSSAFun("mssafun",  cl::init(""),
                                cl::desc("Please specify which function needs to be dumped"));
 
 static cl::opt<std::string> MemPar("mempar", cl::value_desc("memory-partition-type"),
-                                   cl::desc("memory partition strategy"));
+                                   cl::desc("memory partition strategy (distinct, intra-disjoint, inter-disjoint, clustered)"));
 static std::string kDistinctMemPar = "distinct";
 static std::string kIntraDisjointMemPar = "intra-disjoint";
 static std::string kInterDisjointMemPar = "inter-disjoint";
+static std::string kClusteredMemPar = "clustered";
+
+static cl::opt<bool> MemParReport("mempar-report", cl::init(false),
+                                  cl::desc("Report the regions and mus/chis of every memory partition strategy"));
+
+/*!
+ * Create the region generator of a memory partition strategy, the default one for an empty strategy
+ */
+static MRGenerator* createMRGenerator(const std::string& strategy, BVDataPTAImpl* pta) {
+    if (strategy.empty())
+        return new IntraDisjointMRG(pta);
+    else if (strategy == kDistinctMemPar)
+        return new DistinctMRG(pta);
+    else if (strategy == kIntraDisjointMemPar)
+        return new IntraDisjointMRG(pta);
+    else if (strategy == kInterDisjointMemPar)
+        return new InterDisjointMRG(pta);
+    else if (strategy == kClusteredMemPar)
+        return new ClusteredMRG(pta);
+    assert(false && "unrecognised memory partition strategy");
+    return NULL;
+}
+
+/*!
+ * Generate the regions of every strategy and print their cost, to pick a partition for the program
+ */
+static void reportMemPartitionCost(BVDataPTAImpl* pta) {
+    const std::string strategies[] = {kDistinctMemPar, kIntraDisjointMemPar, kInterDisjointMemPar, kClusteredMemPar};
+    unsigned field_width = 16;
+    std::cout << "################ (memory partition cost) ###############\n";
+    std::cout.flags(std::ios::left);
+    std::cout << std::setw(field_width) << "Strategy" << std::setw(field_width) << "Regions"
+              << std::setw(field_width) << "MaxRegionSize" << std::setw(field_width) << "LoadMu"
+              << std::setw(field_width) << "StoreChi" << std::setw(field_width) << "CallSiteMu"
+              << std::setw(field_width) << "CallSiteChi" << "\n";
+    for (const std::string& strategy : strategies) {
+        MRGenerator* gen = createMRGenerator(strategy, pta);
+        gen->generateMRs();
+        MRGenerator::MRCost cost = gen->getCost();
+        std::cout << std::setw(field_width) << strategy << std::setw(field_width) << cost.numOfMRs
+                  << std::setw(field_width) << cost.maxMRSize << std::setw(field_width) << cost.numOfLoadMus
+                  << std::setw(field_width) << cost.numOfStoreChis << std::setw(field_width) << cost.numOfCallSiteMus
+                  << std::setw(field_width) << cost.numOfCallSiteChis << "\n";
+        delete gen;
+    }
+    std::cout << "#######################################################" << std::endl;
+}
 
 
 double MemSSA::timeOfGeneratingMemRegions = 0;	///< Time for allocating regions
@@ -63,25 +113,15 @@ double MemSSA::timeOfSSARenaming  = 0;	///< Time for SSA rename
 /*!
  * Constructor
  */
-MemSSA::MemSSA(BVDataPTAImpl* p) : df(NULL),dt(NULL) {
+MemSSA::MemSSA(BVDataPTAImpl* p) {
     pta = p;
     assert((pta->getAnalysisTy()!=PointerAnalysis::Default_PTA)
            && "please specify a pointer analysis");
 
-    if (!MemPar.getValue().empty()) {
-        std::string strategy = MemPar.getValue();
-        if (strategy == kDistinctMemPar)
-            mrGen = new DistinctMRG(pta);
-        else if (strategy == kIntraDisjointMemPar)
-            mrGen = new IntraDisjointMRG(pta);
-        else if (strategy == kInterDisjointMemPar)
-            mrGen = new InterDisjointMRG(pta);
-        else
-            assert(false && "unrecognised memory partition strategy");
-    }
-    else {
-        mrGen = new IntraDisjointMRG(pta);
-    }
+    if (MemParReport)
+        reportMemPartitionCost(pta);
+
+    mrGen = createMRGenerator(MemPar.getValue(), pta);
 
     stat = new MemSSAStat(this);
 
@@ -93,52 +133,82 @@ MemSSA::MemSSA(BVDataPTAImpl* p) : df(NULL),dt(NULL) {
 }
 
 /*!
- * Set DF/DT
+ * Start building memory SSA
  */
-void MemSSA::setCurrentDFDT(DominanceFrontier* f, DominatorTree* t) {
-    df = f;
-    dt = t;
-    usedRegs.clear();
-    reg2BBMap.clear();
+void MemSSA::buildMemSSA(const Function& fun, DominanceFrontier* f, DominatorTree* t) {
+    FunMSSA fm(&fun, f, t);
+    buildFunMSSA(fm);
+    addFunMSSA(fm);
 }
 
 /*!
- * Start building memory SSA
+ * Build memory SSA of a function into its own state
+ * Memory regions are only looked up, so functions can be built in parallel
  */
-void MemSSA::buildMemSSA(const Function& fun, DominanceFrontier* f, DominatorTree* t) {
+void MemSSA::buildFunMSSA(FunMSSA& fm) {
 
+    const Function& fun = *fm.fun;
     assert(!isExtCall(&fun) && "we do not build memory ssa for external functions");
 
     DBOUT(DMSSA, outs() << "Building Memory SSA for function " << fun.getName()
           << " \n");
 
-    setCurrentDFDT(f,t);
-
     /// Create mus/chis for loads/stores/calls for memory regions
     double muchiStart = stat->getClk();
-    createMUCHI(fun);
+    createMUCHI(fm);
     double muchiEnd = stat->getClk();
-    timeOfCreateMUCHI += (muchiEnd - muchiStart)/TIMEINTERVAL;
+    fm.muchiTime += (muchiEnd - muchiStart)/TIMEINTERVAL;
 
     /// Insert PHI for memory regions
     double phiStart = stat->getClk();
-    insertPHI(fun);
+    insertPHI(fm);
     double phiEnd = stat->getClk();
-    timeOfInsertingPHI += (phiEnd - phiStart)/TIMEINTERVAL;
+    fm.phiTime += (phiEnd - phiStart)/TIMEINTERVAL;
 
     /// SSA rename for memory regions
     double renameStart = stat->getClk();
-    SSARename(fun);
+    SSARename(fm);
     double renameEnd = stat->getClk();
-    timeOfSSARenaming += (renameEnd - renameStart)/TIMEINTERVAL;
+    fm.renameTime += (renameEnd - renameStart)/TIMEINTERVAL;
+
+    /// only the mus/chis/phis are needed from now on
+    fm.df = NULL;
+    fm.dt = NULL;
+    fm.usedRegs.clear();
+    fm.reg2BBMap.clear();
+    fm.varKills.clear();
+    fm.mr2VerStackMap.clear();
+    fm.mr2CounterMap.clear();
+}
 
+/*!
+ * Add the mus/chis/phis of a built function
+ */
+void MemSSA::addFunMSSA(FunMSSA& fm) {
+    load2MuSetMap.insert(fm.load2MuSetMap.begin(), fm.load2MuSetMap.end());
+    store2ChiSetMap.insert(fm.store2ChiSetMap.begin(), fm.store2ChiSetMap.end());
+    callsiteToMuSetMap.insert(fm.callsiteToMuSetMap.begin(), fm.callsiteToMuSetMap.end());
+    callsiteToChiSetMap.insert(fm.callsiteToChiSetMap.begin(), fm.callsiteToChiSetMap.end());
+    bb2PhiSetMap.insert(fm.bb2PhiSetMap.begin(), fm.bb2PhiSetMap.end());
+    if (!fm.entryChiSet.empty())
+        funToEntryChiSetMap[fm.fun] = fm.entryChiSet;
+    if (!fm.returnMuSet.empty())
+        funToReturnMuSetMap[fm.fun] = fm.returnMuSet;
+
+    timeOfCreateMUCHI += fm.muchiTime;
+    timeOfInsertingPHI += fm.phiTime;
+    timeOfSSARenaming += fm.renameTime;
 }
 
 /*!
  * Create mu/chi according to memory regions
  * collect used mrs in usedRegs and construction map from region to BB for prune SSA phi insertion
  */
-void MemSSA::createMUCHI(const Function& fun) {
+void MemSSA::createMUCHI(FunMSSA& fm) {
+
+    const Function& fun = *fm.fun;
+    /// regions are only looked up, the maps of mrGen must not change while functions are built in parallel
+    const MRGenerator* mrs = mrGen;
 
     DBOUT(DMSSA,
           outs() << "\t creating mu chi for function " << fun.getName()
@@ -160,12 +230,12 @@ void MemSSA::createMUCHI(const Function& fun) {
     /// get all reachable basic blocks from function entry
     /// ignore dead basic blocks
     BBList reachableBBs;
-    getFunReachableBBs(&fun,getDT(fun),reachableBBs);
+    getFunReachableBBs(&fun,fm.dt,reachableBBs);
 
     for (BBList::const_iterator iter = reachableBBs.begin(), eiter = reachableBBs.end();
             iter != eiter; ++iter) {
         const BasicBlock* bb = *iter;
-        varKills.clear();
+        fm.varKills.clear();
         for (llvm::BasicBlock::const_iterator it = bb->begin(), eit = bb->end();
                 it != eit; ++it) {
             const Instruction* inst = &*it;
@@ -175,40 +245,40 @@ void MemSSA::createMUCHI(const Function& fun) {
                         ebit = pagEdgeList.end(); bit != ebit; ++bit) {
                     const PAGEdge* inst = *bit;
                     if (const LoadPE* load = dyn_cast<LoadPE>(inst))
-                        AddLoadMU(bb, load, mrGen->getLoadMRSet(load));
+                        AddLoadMU(fm, bb, load, mrs->getLoadMRSet(load));
                     else if (const StorePE* store = dyn_cast<StorePE>(inst))
-                        AddStoreCHI(bb, store, mrGen->getStoreMRSet(store));
+                        AddStoreCHI(fm, bb, store, mrs->getStoreMRSet(store));
                 }
             }
             if (isCallSite(inst) && isInstrinsicDbgInst(inst)==false) {
                 CallSite cs = analysisUtil::getLLVMCallSite(inst);
-                if(mrGen->hasRefMRSet(cs))
-                    AddCallSiteMU(cs,mrGen->getCallSiteRefMRSet(cs));
+                if(mrs->hasRefMRSet(cs))
+                    AddCallSiteMU(fm,cs,mrs->getCallSiteRefMRSet(cs));
 
-                if(mrGen->hasModMRSet(cs))
-                    AddCallSiteCHI(cs,mrGen->getCallSiteModMRSet(cs));
+                if(mrs->hasModMRSet(cs))
+                    AddCallSiteCHI(fm,cs,mrs->getCallSiteModMRSet(cs));
             }
         }
     }
 
     // create entry chi for this function including all memory regions
     // initialize them with version 0 and 1 r_1 = chi (r_0)
-    for (MRSet::iterator iter = usedRegs.begin(), eiter = usedRegs.end();
+    for (MRSet::iterator iter = fm.usedRegs.begin(), eiter = fm.usedRegs.end();
             iter != eiter; ++iter) {
         const MemRegion* mr = *iter;
         // initialize mem region version and stack for renaming phase
-        mr2CounterMap[mr] = 0;
-        mr2VerStackMap[mr].clear();
+        fm.mr2CounterMap[mr] = 0;
+        fm.mr2VerStackMap[mr].clear();
         ENTRYCHI* chi = new ENTRYCHI(&fun, mr);
-        chi->setOpVer(newSSAName(mr,chi));
-        chi->setResVer(newSSAName(mr,chi));
-        funToEntryChiSetMap[&fun].insert(chi);
+        chi->setOpVer(newSSAName(fm,mr,chi));
+        chi->setResVer(newSSAName(fm,mr,chi));
+        fm.entryChiSet.insert(chi);
 
         /// if the function does not have a reachable return instruction from function entry
         /// then we won't create return mu for it
         if(functionDoesNotRet(&fun) == false) {
             RETMU* mu = new RETMU(&fun, mr);
-            funToReturnMuSetMap[&fun].insert(mu);
+            fm.returnMuSet.insert(mu);
         }
 
     }
@@ -218,21 +288,21 @@ void MemSSA::createMUCHI(const Function& fun) {
 /*
  * Insert phi node
  */
-void MemSSA::insertPHI(const Function& fun) {
+void MemSSA::insertPHI(FunMSSA& fm) {
 
     DBOUT(DMSSA,
-          outs() << "\t insert phi for function " << fun.getName() << "\n");
+          outs() << "\t insert phi for function " << fm.fun->getName() << "\n");
 
-    const DominanceFrontier* df = getDF(fun);
+    const DominanceFrontier* df = fm.df;
     // record whether a phi of mr has already been inserted into the bb.
     BBToMRSetMap bb2MRSetMap;
 
     // start inserting phi node
-    for (MRSet::iterator iter = usedRegs.begin(), eiter = usedRegs.end();
+    for (MRSet::iterator iter = fm.usedRegs.begin(), eiter = fm.usedRegs.end();
             iter != eiter; ++iter) {
         const MemRegion* mr = *iter;
 
-        BBList bbs = reg2BBMap[mr];
+        BBList bbs = fm.reg2BBMap[mr];
         while (!bbs.empty()) {
             const BasicBlock* bb = bbs.back();
             bbs.pop_back();
@@ -249,7 +319,7 @@ void MemSSA::insertPHI(const Function& fun) {
                 if (0 == bb2MRSetMap[pbb].count(mr)) {
                     bb2MRSetMap[pbb].insert(mr);
                     // insert phi node
-                    AddMSSAPHI(pbb,mr);
+                    AddMSSAPHI(fm,pbb,mr);
                     // continue to insert phi in its iterative dominate frontiers
                     bbs.push_back(pbb);
                 }
@@ -262,19 +332,19 @@ void MemSSA::insertPHI(const Function& fun) {
 /*!
  * SSA construction algorithm
  */
-void MemSSA::SSARename(const Function& fun) {
+void MemSSA::SSARename(FunMSSA& fm) {
 
     DBOUT(DMSSA,
-          outs() << "\t ssa rename for function " << fun.getName() << "\n");
+          outs() << "\t ssa rename for function " << fm.fun->getName() << "\n");
 
-    SSARenameBB(fun.getEntryBlock());
+    SSARenameBB(fm, fm.fun->getEntryBlock());
 }
 
 /*!
  * Renaming for each memory regions
  * See the renaming algorithm in book Engineering A Compiler (Figure 9.12)
  */
-void MemSSA::SSARenameBB(const BasicBlock& bb) {
+void MemSSA::SSARenameBB(FunMSSA& fm, const BasicBlock& bb) {
 
     // record which mem region needs to pop stack
     MRVector memRegs;
@@ -282,8 +352,9 @@ void MemSSA::SSARenameBB(const BasicBlock& bb) {
     // rename phi result op
     // for each r = phi (...)
     // 		rewrite r as new name
-    if (hasPHISet(&bb))
-        RenamePhiRes(getPHISet(&bb),memRegs);
+    BBToPhiSetMap::iterator phiIt = fm.bb2PhiSetMap.find(&bb);
+    if (phiIt != fm.bb2PhiSetMap.end())
+        RenamePhiRes(fm,phiIt->second,memRegs);
 
 
     // process mu and chi
@@ -302,23 +373,25 @@ void MemSSA::SSARenameBB(const BasicBlock& bb) {
                     bit!=ebit; ++bit) {
                 const PAGEdge* inst = *bit;
                 if (const LoadPE* load = dyn_cast<LoadPE>(inst))
-                    RenameMuSet(getMUSet(load));
+                    RenameMuSet(fm,fm.load2MuSetMap[load]);
 
                 else if (const StorePE* store = dyn_cast<StorePE>(inst))
-                    RenameChiSet(getCHISet(store),memRegs);
+                    RenameChiSet(fm,fm.store2ChiSetMap[store],memRegs);
 
             }
         }
         if (isCallSite(inst) && isInstrinsicDbgInst(inst)==false) {
             CallSite cs = analysisUtil::getLLVMCallSite(inst);
-            if(mrGen->hasRefMRSet(cs))
-                RenameMuSet(getMUSet(cs));
+            CallSiteToMUSetMap::iterator muIt = fm.callsiteToMuSetMap.find(cs);
+            if(muIt != fm.callsiteToMuSetMap.end())
+                RenameMuSet(fm,muIt->second);
 
-            if(mrGen->hasModMRSet(cs))
-                RenameChiSet(getCHISet(cs),memRegs);
+            CallSiteToCHISetMap::iterator chiIt = fm.callsiteToChiSetMap.find(cs);
+            if(chiIt != fm.callsiteToChiSetMap.end())
+                RenameChiSet(fm,chiIt->second,memRegs);
         }
         else if(isReturn(inst)) {
-            RenameMuSet(getReturnMuSet(bb.getParent()));
+            RenameMuSet(fm,fm.returnMuSet);
         }
     }
 
@@ -328,16 +401,16 @@ void MemSSA::SSARenameBB(const BasicBlock& bb) {
             sit != esit; ++sit) {
         const BasicBlock* succ = *sit;
         u32_t pos = getPreBBIndex(&bb, succ);
-        if (hasPHISet(succ))
-            RenamePhiOps(getPHISet(succ),pos,memRegs);
+        BBToPhiSetMap::iterator succPhiIt = fm.bb2PhiSetMap.find(succ);
+        if (succPhiIt != fm.bb2PhiSetMap.end())
+            RenamePhiOps(fm,succPhiIt->second,pos,memRegs);
     }
 
     // for succ basic block in dominator tree
-    DominatorTree* dt = getDT(*bb.getParent());
-    if(DomTreeNode *dtNode = dt->getNode(const_cast<BasicBlock*>(&bb))) {
+    if(DomTreeNode *dtNode = fm.dt->getNode(const_cast<BasicBlock*>(&bb))) {
         for (DomTreeNode::iterator DI = dtNode->begin(), DE = dtNode->end();
                 DI != DE; ++DI) {
-            SSARenameBB(*((*DI)->getBlock()));
+            SSARenameBB(fm, *((*DI)->getBlock()));
         }
     }
     // for each r = chi(..), and r = phi(..)
@@ -345,21 +418,21 @@ void MemSSA::SSARenameBB(const BasicBlock& bb) {
     while (!memRegs.empty()) {
         const MemRegion* mr = memRegs.back();
         memRegs.pop_back();
-        mr2VerStackMap[mr].pop_back();
+        fm.mr2VerStackMap[mr].pop_back();
     }
 
 }
 
-MRVer* MemSSA::newSSAName(const MemRegion* mr, MSSADEF* def) {
-    assert(0 != mr2CounterMap.count(mr)
+MRVer* MemSSA::newSSAName(FunMSSA& fm, const MemRegion* mr, MSSADEF* def) {
+    assert(0 != fm.mr2CounterMap.count(mr)
            && "did not find initial version in map? ");
-    assert(0 != mr2VerStackMap.count(mr)
+    assert(0 != fm.mr2VerStackMap.count(mr)
            && "did not find initial stack in map? ");
 
-    VERSION version = mr2CounterMap[mr];
-    mr2CounterMap[mr] = version + 1;
+    VERSION version = fm.mr2CounterMap[mr];
+    fm.mr2CounterMap[mr] = version + 1;
     MRVer* mrVer = new MRVer(mr, version, def);
-    mr2VerStackMap[mr].push_back(mrVer);
+    fm.mr2VerStackMap[mr].push_back(mrVer);
     return mrVer;
 }
 
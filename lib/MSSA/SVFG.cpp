@@ -33,6 +33,9 @@
 #include "Util/GraphUtil.h"
 #include "Util/AnalysisUtil.h"
 #include "Util/SVFModule.h"
+#include "Util/Parallel.h"
+
+#include <llvm/ADT/Hashing.h>
 
 using namespace llvm;
 using namespace analysisUtil;
@@ -41,11 +44,82 @@ using namespace analysisUtil;
 static cl::opt<bool> DumpVFG("dump-svfg", cl::init(false),
                              cl::desc("Dump dot graph of SVFG"));
 
+static cl::opt<bool> SVFGParallel("svfg-parallel", cl::init(false),
+                                  cl::desc("Collect the def-use edges of the SVFG nodes on parallel threads"));
+
+static cl::opt<unsigned> SVFGThreads("svfg-threads", cl::init(0),
+                                     cl::desc("Number of threads for -svfg-parallel, 0 for one per hardware thread"));
+
+std::deque<PointsTo> IndirectSVFGEdgeLabels::labels(1);
+std::unordered_multimap<size_t, IndirectSVFGEdgeLabels::LabelID> IndirectSVFGEdgeLabels::hashToLabels;
+IndirectSVFGEdgeLabels::LabelPairToLabelMap IndirectSVFGEdgeLabels::intersectionCache;
+u32_t IndirectSVFGEdgeLabels::numOfOwners = 0;
+
+/*!
+ * Find the label equal to pts, or add it
+ */
+IndirectSVFGEdgeLabels::LabelID IndirectSVFGEdgeLabels::getLabel(const PointsTo& pts) {
+    if (pts.empty())
+        return EmptyLabel;
+
+    size_t hash = llvm::hash_combine_range(pts.begin(), pts.end());
+    typedef std::unordered_multimap<size_t, LabelID>::const_iterator HashIter;
+    std::pair<HashIter, HashIter> range = hashToLabels.equal_range(hash);
+    for (HashIter it = range.first; it != range.second; ++it) {
+        if (labels[it->second] == pts)
+            return it->second;
+    }
+
+    LabelID label = labels.size();
+    labels.push_back(pts);
+    hashToLabels.insert(std::make_pair(hash, label));
+    return label;
+}
+
+/*!
+ * Label of the intersection of two labels
+ */
+IndirectSVFGEdgeLabels::LabelID IndirectSVFGEdgeLabels::intersectLabels(LabelID l1, LabelID l2) {
+    if (l1 == l2)
+        return l1;
+    if (l1 == EmptyLabel || l2 == EmptyLabel)
+        return EmptyLabel;
+
+    LabelPair key = getLabelPair(l1, l2);
+    LabelPairToLabelMap::const_iterator it = intersectionCache.find(key);
+    if (it != intersectionCache.end())
+        return it->second;
+
+    LabelID label = EmptyLabel;
+    if (labels[l1].intersects(labels[l2])) {
+        PointsTo pts = labels[l1];
+        pts &= labels[l2];
+        label = getLabel(pts);
+    }
+    intersectionCache[key] = label;
+    return label;
+}
+
+/*!
+ * Free the labels once the last SVFG using them is destroyed
+ */
+void IndirectSVFGEdgeLabels::release() {
+    assert(numOfOwners > 0 && "label table released more times than retained");
+    if (--numOfOwners > 0)
+        return;
+
+    labels.clear();
+    labels.resize(1);
+    hashToLabels.clear();
+    intersectionCache.clear();
+}
+
 /*!
  * Constructor
  */
 SVFG::SVFG(SVFGK k): totalSVFGNode(0), kind(k),mssa(NULL),pta(NULL) {
     stat = new SVFGStat(this);
+    IndirectSVFGEdgeLabels::retain();
 }
 
 /*!
@@ -54,6 +128,7 @@ SVFG::SVFG(SVFGK k): totalSVFGNode(0), kind(k),mssa(NULL),pta(NULL) {
 void SVFG::destroy() {
     delete stat;
     stat = NULL;
+    IndirectSVFGEdgeLabels::release();
     mssa = NULL;
     pta = NULL;
 }
@@ -280,55 +355,7 @@ void SVFG::addSVFGNodesForAddrTakenVars() {
  */
 void SVFG::connectDirectSVFGEdges() {
 
-    for(iterator it = begin(), eit = end(); it!=eit; ++it) {
-        NodeID nodeId = it->first;
-        const SVFGNode* node = it->second;
-
-        if(const StmtSVFGNode* stmtNode = dyn_cast<StmtSVFGNode>(node)) {
-            /// do not handle AddrSVFG node, as it is already the source of a definition
-            if(isa<AddrSVFGNode>(stmtNode))
-                continue;
-            /// for all other cases, like copy/gep/load/ret, connect the RHS pointer to its def
-            addIntraDirectVFEdge(getDef(stmtNode->getPAGSrcNode()),nodeId);
-
-            /// for store, connect the RHS/LHS pointer to its def
-            if(isa<StoreSVFGNode>(stmtNode)) {
-                addIntraDirectVFEdge(getDef(stmtNode->getPAGDstNode()),nodeId);
-            }
-
-        }
-        else if(const PHISVFGNode* phiNode = dyn_cast<PHISVFGNode>(node)) {
-            for (PHISVFGNode::OPVers::const_iterator it = phiNode->opVerBegin(), eit = phiNode->opVerEnd();
-                    it != eit; it++) {
-                addIntraDirectVFEdge(getDef(it->second),nodeId);
-            }
-        }
-        else if(const ActualParmSVFGNode* actualParm = dyn_cast<ActualParmSVFGNode>(node)) {
-            addIntraDirectVFEdge(getDef(actualParm->getParam()),nodeId);
-        }
-        else if(const FormalParmSVFGNode* formalParm = dyn_cast<FormalParmSVFGNode>(node)) {
-            for(CallPESet::const_iterator it = formalParm->callPEBegin(), eit = formalParm->callPEEnd();
-                    it!=eit; ++it) {
-                const Instruction* callInst = (*it)->getCallInst();
-                CallSite cs = analysisUtil::getLLVMCallSite(callInst);
-                const ActualParmSVFGNode* acutalParm = getActualParmSVFGNode((*it)->getSrcNode(),cs);
-                addInterVFEdgeFromAPToFP(acutalParm,formalParm,getCallSiteID((*it)->getCallSite(), formalParm->getFun()));
-            }
-        }
-        else if(const FormalRetSVFGNode* calleeRet = dyn_cast<FormalRetSVFGNode>(node)) {
-            /// connect formal ret to its definition node
-            addIntraDirectVFEdge(getDef(calleeRet->getRet()), nodeId);
-
-            /// connect formal ret to actual ret
-            for(RetPESet::const_iterator it = calleeRet->retPEBegin(), eit = calleeRet->retPEEnd();
-                    it!=eit; ++it) {
-                const ActualRetSVFGNode* callsiteRev = getActualRetSVFGNode((*it)->getDstNode());
-                addInterVFEdgeFromFRToAR(calleeRet,callsiteRev, getCallSiteID((*it)->getCallSite(), calleeRet->getFun()));
-            }
-        }
-        /// Do not process FormalRetSVFGNode, as they are connected by copy within callee
-        /// We assume one procedure only has unique return
-    }
+    connectSVFGEdgesOfNodes(true);
 
     /// connect direct value-flow edges (parameter passing) for thread fork/join
     /// add fork edge
@@ -357,78 +384,229 @@ void SVFG::connectDirectSVFGEdges() {
  */
 void SVFG::connectIndirectSVFGEdges() {
 
-    for(iterator it = begin(), eit = end(); it!=eit; ++it) {
-        NodeID nodeId = it->first;
-        const SVFGNode* node = it->second;
-        if(const LoadSVFGNode* loadNode = dyn_cast<LoadSVFGNode>(node)) {
-            MUSet& muSet = mssa->getMUSet(cast<LoadPE>(loadNode->getPAGEdge()));
-            for(MUSet::iterator it = muSet.begin(), eit = muSet.end(); it!=eit; ++it) {
-                if(LOADMU* mu = dyn_cast<LOADMU>(*it)) {
-                    NodeID def = getDef(mu->getVer());
-                    addIntraIndirectVFEdge(def,nodeId, mu->getVer()->getMR()->getPointsTo());
-                }
-            }
+    connectSVFGEdgesOfNodes(false);
+
+    connectFromGlobalToProgEntry();
+}
+
+/*!
+ * Connect the incoming edges of every node.
+ * With -svfg-parallel the edges of the nodes are collected on parallel threads (the graph is only read),
+ * all edges are then added in the order of the nodes, which is the order they are added in sequentially.
+ */
+void SVFG::connectSVFGEdgesOfNodes(bool direct) {
+
+    std::vector<const SVFGNode*> nodes;
+    nodes.reserve(getTotalNodeNum());
+    for(iterator it = begin(), eit = end(); it!=eit; ++it)
+        nodes.push_back(it->second);
+
+    if (!SVFGParallel) {
+        PendingSVFGEdges edges;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            edges.clear();
+            if (direct)
+                collectDirectSVFGEdges(nodes[i], edges);
+            else
+                collectIndirectSVFGEdges(nodes[i], edges);
+            addPendingSVFGEdges(edges);
         }
-        else if(const StoreSVFGNode* storeNode = dyn_cast<StoreSVFGNode>(node)) {
-            CHISet& chiSet = mssa->getCHISet(cast<StorePE>(storeNode->getPAGEdge()));
-            for(CHISet::iterator it = chiSet.begin(), eit = chiSet.end(); it!=eit; ++it) {
-                if(STORECHI* chi = dyn_cast<STORECHI>(*it)) {
-                    NodeID def = getDef(chi->getOpVer());
-                    addIntraIndirectVFEdge(def,nodeId, chi->getOpVer()->getMR()->getPointsTo());
-                }
-            }
+        return;
+    }
+
+    std::vector<PendingSVFGEdges> edgesOfNodes(nodes.size());
+    parallel::parallelFor(nodes.size(), [&](size_t i) {
+        if (direct)
+            collectDirectSVFGEdges(nodes[i], edgesOfNodes[i]);
+        else
+            collectIndirectSVFGEdges(nodes[i], edgesOfNodes[i]);
+    }, SVFGThreads);
+
+    for (size_t i = 0; i < edgesOfNodes.size(); i++)
+        addPendingSVFGEdges(edgesOfNodes[i]);
+}
+
+/*!
+ * Collect the incoming direct edges of a node
+ */
+void SVFG::collectDirectSVFGEdges(const SVFGNode* node, PendingSVFGEdges& edges) const {
+
+    NodeID nodeId = node->getId();
+
+    if(const StmtSVFGNode* stmtNode = dyn_cast<StmtSVFGNode>(node)) {
+        /// do not handle AddrSVFG node, as it is already the source of a definition
+        if(isa<AddrSVFGNode>(stmtNode))
+            return;
+        /// for all other cases, like copy/gep/load/ret, connect the RHS pointer to its def
+        edges.push_back(PendingSVFGEdge(SVFGEdge::IntraDirect, getDef(stmtNode->getPAGSrcNode()), nodeId));
+
+        /// for store, connect the RHS/LHS pointer to its def
+        if(isa<StoreSVFGNode>(stmtNode)) {
+            edges.push_back(PendingSVFGEdge(SVFGEdge::IntraDirect, getDef(stmtNode->getPAGDstNode()), nodeId));
         }
-        else if(const FormalINSVFGNode* formalIn = dyn_cast<FormalINSVFGNode>(node)) {
-            PTACallGraphEdge::CallInstSet callInstSet;
-            mssa->getPTA()->getPTACallGraph()->getDirCallSitesInvokingCallee(formalIn->getEntryChi()->getFunction(),callInstSet);
-            for(PTACallGraphEdge::CallInstSet::iterator it = callInstSet.begin(), eit = callInstSet.end(); it!=eit; ++it) {
-                CallSite cs = analysisUtil::getLLVMCallSite(*it);
-                if(!mssa->hasMU(cs))
-                    continue;
-                ActualINSVFGNodeSet& actualIns = getActualINSVFGNodes(cs);
-                for(ActualINSVFGNodeSet::iterator ait = actualIns.begin(), aeit = actualIns.end(); ait!=aeit; ++ait) {
-                    const ActualINSVFGNode* actualIn = llvm::cast<ActualINSVFGNode>(getSVFGNode(*ait));
-                    addInterIndirectVFCallEdge(actualIn,formalIn,getCallSiteID(cs, formalIn->getFun()));
-                }
+
+    }
+    else if(const PHISVFGNode* phiNode = dyn_cast<PHISVFGNode>(node)) {
+        for (PHISVFGNode::OPVers::const_iterator it = phiNode->opVerBegin(), eit = phiNode->opVerEnd();
+                it != eit; it++) {
+            edges.push_back(PendingSVFGEdge(SVFGEdge::IntraDirect, getDef(it->second), nodeId));
+        }
+    }
+    else if(const ActualParmSVFGNode* actualParm = dyn_cast<ActualParmSVFGNode>(node)) {
+        edges.push_back(PendingSVFGEdge(SVFGEdge::IntraDirect, getDef(actualParm->getParam()), nodeId));
+    }
+    else if(const FormalParmSVFGNode* formalParm = dyn_cast<FormalParmSVFGNode>(node)) {
+        for(CallPESet::const_iterator it = formalParm->callPEBegin(), eit = formalParm->callPEEnd();
+                it!=eit; ++it) {
+            const Instruction* callInst = (*it)->getCallInst();
+            CallSite cs = analysisUtil::getLLVMCallSite(callInst);
+            const ActualParmSVFGNode* acutalParm = getActualParmSVFGNode((*it)->getSrcNode(),cs);
+            edges.push_back(PendingSVFGEdge(SVFGEdge::DirCall, acutalParm->getId(), nodeId,
+                                            getCallSiteID((*it)->getCallSite(), formalParm->getFun())));
+        }
+    }
+    else if(const FormalRetSVFGNode* calleeRet = dyn_cast<FormalRetSVFGNode>(node)) {
+        /// connect formal ret to its definition node
+        edges.push_back(PendingSVFGEdge(SVFGEdge::IntraDirect, getDef(calleeRet->getRet()), nodeId));
+
+        /// connect formal ret to actual ret
+        for(RetPESet::const_iterator it = calleeRet->retPEBegin(), eit = calleeRet->retPEEnd();
+                it!=eit; ++it) {
+            const ActualRetSVFGNode* callsiteRev = getActualRetSVFGNode((*it)->getDstNode());
+            edges.push_back(PendingSVFGEdge(SVFGEdge::DirRet, nodeId, callsiteRev->getId(),
+                                            getCallSiteID((*it)->getCallSite(), calleeRet->getFun())));
+        }
+    }
+    /// Do not process FormalRetSVFGNode, as they are connected by copy within callee
+    /// We assume one procedure only has unique return
+}
+
+/*!
+ * Collect the incoming indirect edges of a node (outgoing ones for the call site returns of a formal-out).
+ * Memory SSA and call site maps are looked up with find, their operator[] would insert.
+ */
+void SVFG::collectIndirectSVFGEdges(const SVFGNode* node, PendingSVFGEdges& edges) const {
+
+    NodeID nodeId = node->getId();
+
+    if(const LoadSVFGNode* loadNode = dyn_cast<LoadSVFGNode>(node)) {
+        MemSSA::LoadToMUSetMap& loadToMUs = mssa->getLoadToMUSetMap();
+        MemSSA::LoadToMUSetMap::const_iterator mit = loadToMUs.find(cast<LoadPE>(loadNode->getPAGEdge()));
+        if (mit == loadToMUs.end())
+            return;
+        for(MUSet::const_iterator it = mit->second.begin(), eit = mit->second.end(); it!=eit; ++it) {
+            if(LOADMU* mu = dyn_cast<LOADMU>(*it)) {
+                NodeID def = getDef(mu->getVer());
+                edges.push_back(PendingSVFGEdge(SVFGEdge::IntraIndirect, def, nodeId, 0, &mu->getVer()->getMR()->getPointsTo()));
             }
         }
-        else if(const FormalOUTSVFGNode* formalOut = dyn_cast<FormalOUTSVFGNode>(node)) {
-            PTACallGraphEdge::CallInstSet callInstSet;
-            const MemSSA::RETMU* retMu = formalOut->getRetMU();
-            mssa->getPTA()->getPTACallGraph()->getDirCallSitesInvokingCallee(retMu->getFunction(),callInstSet);
-            for(PTACallGraphEdge::CallInstSet::iterator it = callInstSet.begin(), eit = callInstSet.end(); it!=eit; ++it) {
-                CallSite cs = analysisUtil::getLLVMCallSite(*it);
-                if(!mssa->hasCHI(cs))
-                    continue;
-                ActualOUTSVFGNodeSet& actualOuts = getActualOUTSVFGNodes(cs);
-                for(ActualOUTSVFGNodeSet::iterator ait = actualOuts.begin(), aeit = actualOuts.end(); ait!=aeit; ++ait) {
-                    const ActualOUTSVFGNode* actualOut = llvm::cast<ActualOUTSVFGNode>(getSVFGNode(*ait));
-                    addInterIndirectVFRetEdge(formalOut,actualOut,getCallSiteID(cs, formalOut->getFun()));
-                }
+    }
+    else if(const StoreSVFGNode* storeNode = dyn_cast<StoreSVFGNode>(node)) {
+        MemSSA::StoreToChiSetMap& storeToChis = mssa->getStoreToChiSetMap();
+        MemSSA::StoreToChiSetMap::const_iterator mit = storeToChis.find(cast<StorePE>(storeNode->getPAGEdge()));
+        if (mit == storeToChis.end())
+            return;
+        for(CHISet::const_iterator it = mit->second.begin(), eit = mit->second.end(); it!=eit; ++it) {
+            if(STORECHI* chi = dyn_cast<STORECHI>(*it)) {
+                NodeID def = getDef(chi->getOpVer());
+                edges.push_back(PendingSVFGEdge(SVFGEdge::IntraIndirect, def, nodeId, 0, &chi->getOpVer()->getMR()->getPointsTo()));
             }
-            NodeID def = getDef(retMu->getVer());
-            addIntraIndirectVFEdge(def,nodeId, retMu->getVer()->getMR()->getPointsTo());
         }
-        else if(const ActualINSVFGNode* actualIn = dyn_cast<ActualINSVFGNode>(node)) {
-            const MRVer* ver = actualIn->getCallMU()->getVer();
-            NodeID def = getDef(ver);
-            addIntraIndirectVFEdge(def,nodeId, ver->getMR()->getPointsTo());
+    }
+    else if(const FormalINSVFGNode* formalIn = dyn_cast<FormalINSVFGNode>(node)) {
+        PTACallGraphEdge::CallInstSet callInstSet;
+        mssa->getPTA()->getPTACallGraph()->getDirCallSitesInvokingCallee(formalIn->getEntryChi()->getFunction(),callInstSet);
+        for(PTACallGraphEdge::CallInstSet::iterator it = callInstSet.begin(), eit = callInstSet.end(); it!=eit; ++it) {
+            CallSite cs = analysisUtil::getLLVMCallSite(*it);
+            if(!mssa->hasMU(cs))
+                continue;
+            CallSiteToActualINsMapTy::const_iterator ait = callSiteToActualINMap.find(cs);
+            if (ait == callSiteToActualINMap.end())
+                continue;
+            CallSiteID csId = getCallSiteID(cs, formalIn->getFun());
+            for(ActualINSVFGNodeSet::iterator nit = ait->second.begin(), neit = ait->second.end(); nit!=neit; ++nit) {
+                const ActualINSVFGNode* actualIn = llvm::cast<ActualINSVFGNode>(getSVFGNode(*nit));
+                if(actualIn->getPointsTo().intersects(formalIn->getPointsTo()))
+                    edges.push_back(PendingSVFGEdge(SVFGEdge::IndCall, actualIn->getId(), nodeId, csId,
+                                                    &actualIn->getPointsTo(), &formalIn->getPointsTo()));
+            }
         }
-        else if(isa<ActualOUTSVFGNode>(node)) {
-            /// There's no need to connect actual out node to its definition site in the same function.
-        }
-        else if(const MSSAPHISVFGNode* phiNode = dyn_cast<MSSAPHISVFGNode>(node)) {
-            for (MemSSA::PHI::OPVers::const_iterator it = phiNode->opVerBegin(), eit = phiNode->opVerEnd();
-                    it != eit; it++) {
-                const MRVer* op = it->second;
-                NodeID def = getDef(op);
-                addIntraIndirectVFEdge(def,nodeId, op->getMR()->getPointsTo());
+    }
+    else if(const FormalOUTSVFGNode* formalOut = dyn_cast<FormalOUTSVFGNode>(node)) {
+        PTACallGraphEdge::CallInstSet callInstSet;
+        const MemSSA::RETMU* retMu = formalOut->getRetMU();
+        mssa->getPTA()->getPTACallGraph()->getDirCallSitesInvokingCallee(retMu->getFunction(),callInstSet);
+        for(PTACallGraphEdge::CallInstSet::iterator it = callInstSet.begin(), eit = callInstSet.end(); it!=eit; ++it) {
+            CallSite cs = analysisUtil::getLLVMCallSite(*it);
+            if(!mssa->hasCHI(cs))
+                continue;
+            CallSiteToActualOUTsMapTy::const_iterator ait = callSiteToActualOUTMap.find(cs);
+            if (ait == callSiteToActualOUTMap.end())
+                continue;
+            CallSiteID csId = getCallSiteID(cs, formalOut->getFun());
+            for(ActualOUTSVFGNodeSet::iterator nit = ait->second.begin(), neit = ait->second.end(); nit!=neit; ++nit) {
+                const ActualOUTSVFGNode* actualOut = llvm::cast<ActualOUTSVFGNode>(getSVFGNode(*nit));
+                if(formalOut->getPointsTo().intersects(actualOut->getPointsTo()))
+                    edges.push_back(PendingSVFGEdge(SVFGEdge::IndRet, nodeId, actualOut->getId(), csId,
+                                                    &formalOut->getPointsTo(), &actualOut->getPointsTo()));
             }
         }
+        NodeID def = getDef(retMu->getVer());
+        edges.push_back(PendingSVFGEdge(SVFGEdge::IntraIndirect, def, nodeId, 0, &retMu->getVer()->getMR()->getPointsTo()));
     }
+    else if(const ActualINSVFGNode* actualIn = dyn_cast<ActualINSVFGNode>(node)) {
+        const MRVer* ver = actualIn->getCallMU()->getVer();
+        NodeID def = getDef(ver);
+        edges.push_back(PendingSVFGEdge(SVFGEdge::IntraIndirect, def, nodeId, 0, &ver->getMR()->getPointsTo()));
+    }
+    else if(isa<ActualOUTSVFGNode>(node)) {
+        /// There's no need to connect actual out node to its definition site in the same function.
+    }
+    else if(const MSSAPHISVFGNode* phiNode = dyn_cast<MSSAPHISVFGNode>(node)) {
+        for (MemSSA::PHI::OPVers::const_iterator it = phiNode->opVerBegin(), eit = phiNode->opVerEnd();
+                it != eit; it++) {
+            const MRVer* op = it->second;
+            NodeID def = getDef(op);
+            edges.push_back(PendingSVFGEdge(SVFGEdge::IntraIndirect, def, nodeId, 0, &op->getMR()->getPointsTo()));
+        }
+    }
+}
 
-
-    connectFromGlobalToProgEntry();
+/*!
+ * Add the collected edges in the order they were collected
+ */
+void SVFG::addPendingSVFGEdges(const PendingSVFGEdges& edges) {
+    PointsTo intersection;
+    for (PendingSVFGEdges::const_iterator it = edges.begin(), eit = edges.end(); it != eit; ++it) {
+        const PointsTo* cpts = it->cpts;
+        if (it->mask != NULL) {
+            intersection = *it->cpts;
+            intersection &= *it->mask;
+            cpts = &intersection;
+        }
+        switch (it->kind) {
+        case SVFGEdge::IntraDirect:
+            addIntraDirectVFEdge(it->src, it->dst);
+            break;
+        case SVFGEdge::DirCall:
+            addCallDirectVFEdge(it->src, it->dst, it->csId);
+            break;
+        case SVFGEdge::DirRet:
+            addRetDirectVFEdge(it->src, it->dst, it->csId);
+            break;
+        case SVFGEdge::IntraIndirect:
+            addIntraIndirectVFEdge(it->src, it->dst, *cpts);
+            break;
+        case SVFGEdge::IndCall:
+            addCallIndirectVFEdge(it->src, it->dst, *cpts, it->csId);
+            break;
+        case SVFGEdge::IndRet:
+            addRetIndirectVFEdge(it->src, it->dst, *cpts, it->csId);
+            break;
+        default:
+            assert(false && "unexpected pending SVFG edge");
+        }
+    }
 }
 
 
@@ -908,6 +1086,21 @@ void SVFG::performStat()
  * GraphTraits specialization
  */
 namespace llvm {
+/// Function and kind of SVFG nodes for filtering graph exports
+template<>
+struct GraphExportTraits<SVFG*> {
+    static const Function* getFunction(SVFGNode *node) {
+        return node->getBB() ? node->getBB()->getParent() : NULL;
+    }
+    static std::string getNodeKind(SVFGNode *node) {
+        static const char* kinds[] = {"Addr", "Copy", "Gep", "Store", "Load", "TPhi", "TIntraPhi", "TInterPhi",
+                                      "MPhi", "MIntraPhi", "MInterPhi", "FRet", "ARet",
+                                      "AParm", "APIN", "APOUT", "FParm", "FPIN", "FPOUT", "NPtr"
+                                     };
+        return kinds[node->getNodeKind()];
+    }
+};
+
 template<>
 struct DOTGraphTraits<SVFG*> : public DOTGraphTraits<PAG*> {
 
@@ -31,6 +31,9 @@
 #include "MSSA/SVFG.h"
 #include "MSSA/SVFGBuilder.h"
 #include "WPA/Andersen.h"
+#include "Util/Parallel.h"
+
+#include <llvm/Support/CommandLine.h>
 
 using namespace llvm;
 using namespace analysisUtil;
@@ -41,6 +44,12 @@ static cl::opt<bool> SVFGWithIndirectCall("svfgWithIndCall", cl::init(false),
 static cl::opt<bool> SingleVFG("singleVFG", cl::init(false),
                                cl::desc("Create a single VFG shared by multiple analysis"));
 
+static cl::opt<bool> MSSAParallel("mssa-parallel", cl::init(false),
+                                  cl::desc("Build the memory SSA of the functions in parallel"));
+
+static cl::opt<unsigned> MSSAThreads("mssa-threads", cl::init(0),
+                                     cl::desc("Number of threads for -mssa-parallel, 0 for one per hardware thread"));
+
 SVFGOPT* SVFGBuilder::globalSvfg = NULL;
 
 /*!
@@ -90,21 +99,50 @@ bool SVFGBuilder::build(SVFG* graph,BVDataPTAImpl* pta) {
 
     DBOUT(DGENERAL, outs() << pasMsg("Build Memory SSA \n"));
 
-    DominatorTree dt;
-    MemSSADF df;
-
     SVFModule svfModule = pta->getModule();
-    for (SVFModule::iterator iter = svfModule.begin(), eiter = svfModule.end();
-            iter != eiter; ++iter) {
+    if (MSSAParallel) {
+        std::vector<llvm::Function*> funs;
+        for (SVFModule::iterator iter = svfModule.begin(), eiter = svfModule.end();
+                iter != eiter; ++iter) {
+            if (!analysisUtil::isExtCall(*iter))
+                funs.push_back(*iter);
+        }
 
-        llvm::Function *fun = *iter;
-        if (analysisUtil::isExtCall(fun))
-            continue;
+        /// each function is built into its own state with its own dominator tree/frontier,
+        /// then the states are added one after the other in the order of the module
+        std::vector<MemSSA::FunMSSA*> funMSSAs(funs.size(), NULL);
+        parallel::parallelFor(funs.size(), [&](size_t i) {
+            DominatorTree dt;
+            MemSSADF df;
+            dt.recalculate(*funs[i]);
+            df.runOnDT(dt);
+
+            MemSSA::FunMSSA* fm = new MemSSA::FunMSSA(funs[i], &df, &dt);
+            mssa->buildFunMSSA(*fm);
+            funMSSAs[i] = fm;
+        }, MSSAThreads);
+
+        for (std::vector<MemSSA::FunMSSA*>::iterator it = funMSSAs.begin(), eit = funMSSAs.end(); it != eit; ++it) {
+            mssa->addFunMSSA(**it);
+            delete *it;
+        }
+    }
+    else {
+        DominatorTree dt;
+        MemSSADF df;
+
+        for (SVFModule::iterator iter = svfModule.begin(), eiter = svfModule.end();
+                iter != eiter; ++iter) {
 
-        dt.recalculate(*fun);
-        df.runOnDT(dt);
+            llvm::Function *fun = *iter;
+            if (analysisUtil::isExtCall(fun))
+                continue;
 
-        mssa->buildMemSSA(*fun, &df, &dt);
+            dt.recalculate(*fun);
+            df.runOnDT(dt);
+
+            mssa->buildMemSSA(*fun, &df, &dt);
+        }
     }
 
     mssa->performStat();
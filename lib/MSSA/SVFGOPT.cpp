@@ -47,6 +47,86 @@ static std::string KeepAllSelfCycle = "all";
 static std::string KeepContextSelfCycle = "context";
 static std::string KeepNoneSelfCycle = "none";
 
+static cl::list<SVFGOPT::OptPassKind> OptPasses("svfg-opt-passes", cl::CommaSeparated,
+        cl::desc("SVFG optimisation passes run in order after removing parameter/return and actual/formal-in/out nodes (default: mssaphi)"),
+        cl::values(
+            clEnumValN(SVFGOPT::MSSAPHIPass, "mssaphi", "bypass MSSA phi nodes"),
+            clEnumValN(SVFGOPT::DeadValueFlowPass, "dead", "remove address-taken value-flows never reaching a load"),
+            clEnumValN(SVFGOPT::PHIChainPass, "phichain", "collapse chains and two-node cycles of MSSA phi nodes"),
+            clEnumValN(SVFGOPT::MergePHIPass, "mergephi", "merge MSSA phi nodes with the same incoming edges")
+        ));
+
+/// Statistics of each pass, indexed by OptPassKind.
+/// Passes only remove nodes, while bypassing a node may add more edges than it removes,
+/// so the net change of the edges is recorded as either added or removed edges.
+static const char* OptPassRmNodes[] = {"InterOptRmNode", "MSSAPHIOptRmNode", "DeadVFOptRmNode",
+                                       "PHIChainOptRmNode", "MergePHIOptRmNode"
+                                      };
+static const char* OptPassRmEdges[] = {"InterOptRmEdge", "MSSAPHIOptRmEdge", "DeadVFOptRmEdge",
+                                       "PHIChainOptRmEdge", "MergePHIOptRmEdge"
+                                      };
+static const char* OptPassAddEdges[] = {"InterOptAddEdge", "MSSAPHIOptAddEdge", "DeadVFOptAddEdge",
+                                        "PHIChainOptAddEdge", "MergePHIOptAddEdge"
+                                       };
+
+/*!
+ * Run the inter-procedural pass, followed by the passes of -svfg-opt-passes
+ */
+void SVFGOPT::runOptPasses()
+{
+    runOptPass(InterValueFlowPass);
+
+    if (OptPasses.empty())
+        runOptPass(MSSAPHIPass);
+    for (u32_t i = 0; i < OptPasses.size(); i++)
+        runOptPass(OptPasses[i]);
+}
+
+/*!
+ * Run one pass
+ */
+void SVFGOPT::runOptPass(OptPassKind pass)
+{
+    Size_t numOfNodes = getNumOfNodes();
+    Size_t numOfEdges = getNumOfEdges();
+
+    switch (pass) {
+    case InterValueFlowPass:
+        handleInterValueFlow();
+        break;
+    case MSSAPHIPass:
+        handleIntraValueFlow();
+        break;
+    case DeadValueFlowPass:
+        removeDeadValueFlow();
+        break;
+    case PHIChainPass:
+        collapseMSSAPHIChains();
+        break;
+    case MergePHIPass:
+        mergeEquivalentMSSAPHINodes();
+        break;
+    }
+
+    Size_t newNumOfNodes = getNumOfNodes();
+    Size_t newNumOfEdges = getNumOfEdges();
+    assert(newNumOfNodes <= numOfNodes && "SVFG optimisation passes should not add nodes");
+    stat->addOptPassStat(OptPassRmNodes[pass], numOfNodes - newNumOfNodes);
+    stat->addOptPassStat(OptPassRmEdges[pass], numOfEdges > newNumOfEdges ? numOfEdges - newNumOfEdges : 0);
+    stat->addOptPassStat(OptPassAddEdges[pass], newNumOfEdges > numOfEdges ? newNumOfEdges - numOfEdges : 0);
+}
+
+/*!
+ * Count the edges, removing an edge does not update the edge number of the graph
+ */
+Size_t SVFGOPT::getNumOfEdges() const
+{
+    Size_t numOfEdges = 0;
+    for (SVFG::const_iterator it = begin(), eit = end(); it != eit; ++it)
+        numOfEdges += it->second->getOutEdges().size();
+    return numOfEdges;
+}
+
 /*!
  *
  */
@@ -178,13 +258,13 @@ void SVFGOPT::retargetEdgesOfAInFOut(SVFGNode* node)
     assert(node->getInEdges().size() == 1 && "actual-in/formal-out can only have one incoming edge as its def size");
 
     SVFGNode* def = NULL;
-    PointsTo inPointsTo;
+    IndirectSVFGEdge::LabelID inLabel = IndirectSVFGEdgeLabels::EmptyLabel;
 
     SVFGNode::const_iterator it = node->InEdgeBegin();
     SVFGNode::const_iterator eit = node->InEdgeEnd();
     for (; it != eit; ++it) {
         const IndirectSVFGEdge* inEdge = llvm::cast<IndirectSVFGEdge>(*it);
-        inPointsTo = inEdge->getPointsTo();
+        inLabel = inEdge->getLabel();
 
         def = inEdge->getSrcNode();
         if (isa<ActualINSVFGNode>(node))
@@ -196,11 +276,10 @@ void SVFGOPT::retargetEdgesOfAInFOut(SVFGNode* node)
     it = node->OutEdgeBegin(), eit = node->OutEdgeEnd();
     for (; it != eit; ++it) {
         const IndirectSVFGEdge* outEdge = llvm::cast<IndirectSVFGEdge>(*it);
-        PointsTo intersection = inPointsTo;
-        intersection &= outEdge->getPointsTo();
-
-        if (intersection.empty())
+        IndirectSVFGEdge::LabelID label = IndirectSVFGEdgeLabels::intersectLabels(inLabel, outEdge->getLabel());
+        if (label == IndirectSVFGEdgeLabels::EmptyLabel)
             continue;
+        const PointsTo& intersection = IndirectSVFGEdgeLabels::getPointsTo(label);
 
         SVFGNode* dstNode = outEdge->getDstNode();
         if (const CallIndSVFGEdge* callEdge = dyn_cast<CallIndSVFGEdge>(outEdge))
@@ -230,10 +309,10 @@ void SVFGOPT::retargetEdgesOfAOutFIn(SVFGNode* node)
         for (; outIt != outEit; ++outIt) {
             const IndirectSVFGEdge* outEdge = llvm::cast<IndirectSVFGEdge>(*outIt);
 
-            PointsTo intersection = inEdge->getPointsTo();
-            intersection &= outEdge->getPointsTo();
-            if (intersection.empty())
+            IndirectSVFGEdge::LabelID label = IndirectSVFGEdgeLabels::intersectLabels(inEdge->getLabel(), outEdge->getLabel());
+            if (label == IndirectSVFGEdgeLabels::EmptyLabel)
                 continue;
+            const PointsTo& intersection = IndirectSVFGEdgeLabels::getPointsTo(label);
 
             NodeID dstId = outEdge->getDstID();
             if (const RetIndSVFGEdge* retEdge = dyn_cast<RetIndSVFGEdge>(inEdge)) {
@@ -339,6 +418,284 @@ void SVFGOPT::parseSelfCycleHandleOption()
     }
 }
 
+/*!
+ * Stores and the MSSAPHI/actual/formal-in/out nodes which can be removed only pass memory value-flows on,
+ * they are live only if a successor along an indirect edge is live.
+ * Def-sites of actual-in/formal-out, and actual-out/formal-in kept on purpose, are looked up later and stay live.
+ */
+bool SVFGOPT::mayBeDeadValueFlow(const SVFGNode* node)
+{
+    if (isa<StoreSVFGNode>(node))
+        return true;
+    if (isa<MSSAPHISVFGNode>(node) || isa<ActualINSVFGNode>(node) || isa<ActualOUTSVFGNode>(node)
+            || isa<FormalINSVFGNode>(node) || isa<FormalOUTSVFGNode>(node)) {
+        if (keepActualOutFormalIn && (isa<ActualOUTSVFGNode>(node) || isa<FormalINSVFGNode>(node)))
+            return false;
+        return canBeRemoved(node) && isDefOfAInFOut(node) == false;
+    }
+    return false;
+}
+
+/*!
+ * Remove the address-taken value-flows which never reach a load.
+ * Liveness is propagated backwards along the indirect edges from the nodes which are always live.
+ */
+void SVFGOPT::removeDeadValueFlow()
+{
+    NodeBS live;
+    FIFOWorkList<const SVFGNode*> liveWorklist;
+    std::vector<SVFGNode*> candidates;
+    for (SVFG::iterator it = begin(), eit = end(); it != eit; ++it) {
+        SVFGNode* node = it->second;
+        if (mayBeDeadValueFlow(node)) {
+            candidates.push_back(node);
+        }
+        else {
+            live.set(node->getId());
+            liveWorklist.push(node);
+        }
+    }
+
+    while (!liveWorklist.empty()) {
+        const SVFGNode* node = liveWorklist.pop();
+        for (SVFGNode::const_iterator it = node->InEdgeBegin(), eit = node->InEdgeEnd(); it != eit; ++it) {
+            if ((*it)->isIndirectVFGEdge() == false)
+                continue;
+            const SVFGNode* src = (*it)->getSrcNode();
+            if (live.test_and_set(src->getId()))
+                liveWorklist.push(src);
+        }
+    }
+
+    Size_t numOfDeadStores = 0;
+    for (std::vector<SVFGNode*>::const_iterator it = candidates.begin(), eit = candidates.end(); it != eit; ++it) {
+        SVFGNode* node = *it;
+        if (live.test(node->getId()))
+            continue;
+
+        /// a dead node never flows into a live one, so loads keep all their incoming value-flows
+        for (SVFGNode::const_iterator edgeIt = node->OutEdgeBegin(), edgeEit = node->OutEdgeEnd(); edgeIt != edgeEit; ++edgeIt)
+            assert(((*edgeIt)->isIndirectVFGEdge() == false || live.test((*edgeIt)->getDstID()) == false)
+                   && "removing a value-flow into a live node");
+
+        if (isa<StoreSVFGNode>(node)) {
+            /// a store is a statement, only its memory value-flows are dead
+            SVFGEdgeSetTy outEdges = node->getOutEdges();
+            for (SVFGEdgeSetTy::iterator eit = outEdges.begin(), eeit = outEdges.end(); eit != eeit; ++eit) {
+                if ((*eit)->isIndirectVFGEdge())
+                    removeSVFGEdge(*eit);
+            }
+            numOfDeadStores++;
+        }
+        else {
+            removeAllEdges(node);
+            removeSVFGNode(node);
+        }
+    }
+
+    stat->addOptPassStat("DeadVFStore", numOfDeadStores);
+}
+
+/*!
+ * Collapse chains and two-node cycles of MSSAPHI nodes.
+ * Unlike bypassing a node, merging it moves each of its edges to the representative once.
+ */
+void SVFGOPT::collapseMSSAPHIChains()
+{
+    FIFOWorkList<NodeID> phiWorklist;
+    for (SVFG::const_iterator it = begin(), eit = end(); it != eit; ++it) {
+        if (isMergeableMSSAPHI(it->second))
+            phiWorklist.push(it->first);
+    }
+
+    while (!phiWorklist.empty()) {
+        NodeID id = phiWorklist.pop();
+        if (hasSVFGNode(id) == false)
+            continue;
+
+        const SVFGNode* node = getSVFGNode(id);
+        const SVFGEdge* inEdge = NULL;
+        const SVFGEdge* outEdge = NULL;
+        const SVFGNode* rep = getMSSAPHIChainRep(node, inEdge, outEdge);
+        if (rep == NULL)
+            continue;
+
+        /// the neighbours get a new edge to/from rep, they may be mergeable now
+        for (SVFGNode::const_iterator it = node->InEdgeBegin(), eit = node->InEdgeEnd(); it != eit; ++it) {
+            if (isMergeableMSSAPHI((*it)->getSrcNode()))
+                phiWorklist.push((*it)->getSrcID());
+        }
+        for (SVFGNode::const_iterator it = node->OutEdgeBegin(), eit = node->OutEdgeEnd(); it != eit; ++it) {
+            if (isMergeableMSSAPHI((*it)->getDstNode()))
+                phiWorklist.push((*it)->getDstID());
+        }
+
+        mergeMSSAPHINode(node, rep, inEdge, outEdge);
+        if (isMergeableMSSAPHI(rep))
+            phiWorklist.push(rep->getId());
+    }
+}
+
+/*!
+ * A MSSAPHI node can be merged into rep without changing the value-flows if
+ * 1. its only incoming edge is an intra edge from rep, its successors then read rep directly;
+ * 2. its only outgoing edge is an intra edge to rep, its predecessors then flow into rep directly;
+ * 3. it and rep flow into each other along intra edges, and the edge to rep carries all objects
+ *    of its other incoming edges, the edge from rep carries all objects of its other outgoing edges.
+ */
+const SVFGNode* SVFGOPT::getMSSAPHIChainRep(const SVFGNode* node, const SVFGEdge*& inEdge, const SVFGEdge*& outEdge)
+{
+    if (node->getInEdges().size() == 1 && isMSSAPHIChainEdge(*node->InEdgeBegin())) {
+        inEdge = *node->InEdgeBegin();
+        return inEdge->getSrcNode();
+    }
+    if (node->getOutEdges().size() == 1 && isMSSAPHIChainEdge(*node->OutEdgeBegin())) {
+        outEdge = *node->OutEdgeBegin();
+        return outEdge->getDstNode();
+    }
+
+    for (SVFGNode::const_iterator outIt = node->OutEdgeBegin(), outEit = node->OutEdgeEnd(); outIt != outEit; ++outIt) {
+        const SVFGEdge* toRep = *outIt;
+        if (isMSSAPHIChainEdge(toRep) == false)
+            continue;
+
+        const SVFGNode* rep = toRep->getDstNode();
+        const SVFGEdge* fromRep = NULL;
+        bool covered = true;
+        for (SVFGNode::const_iterator inIt = node->InEdgeBegin(), inEit = node->InEdgeEnd(); inIt != inEit; ++inIt) {
+            const SVFGEdge* edge = *inIt;
+            if (edge->getSrcNode() == rep && isa<IntraIndSVFGEdge>(edge))
+                fromRep = edge;
+            else if (edge->getSrcNode() != node && labelCovered(edge, toRep) == false)
+                covered = false;
+        }
+        if (fromRep == NULL || covered == false)
+            continue;
+
+        for (SVFGNode::const_iterator it = node->OutEdgeBegin(), eit = node->OutEdgeEnd(); it != eit && covered; ++it) {
+            const SVFGEdge* edge = *it;
+            if (edge != toRep && edge->getDstNode() != node && labelCovered(edge, fromRep) == false)
+                covered = false;
+        }
+        if (covered) {
+            inEdge = fromRep;
+            outEdge = toRep;
+            return rep;
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+ * Move the edges of node to rep, then remove node.
+ * An incoming edge is joined with outEdge, an outgoing edge with inEdge, self cycles of node are dropped.
+ */
+void SVFGOPT::mergeMSSAPHINode(const SVFGNode* node, const SVFGNode* rep, const SVFGEdge* inEdge, const SVFGEdge* outEdge)
+{
+    NodeID nodeId = node->getId();
+    NodeID repId = rep->getId();
+
+    for (SVFGNode::const_iterator it = node->InEdgeBegin(), eit = node->InEdgeEnd(); it != eit; ++it) {
+        const SVFGEdge* edge = *it;
+        if (edge == inEdge || edge->getSrcID() == nodeId)
+            continue;
+        assert(outEdge && "merging a node with other incoming edges but no edge to rep");
+        addNewSVFGEdge(edge->getSrcID(), repId, edge, outEdge);
+    }
+
+    for (SVFGNode::const_iterator it = node->OutEdgeBegin(), eit = node->OutEdgeEnd(); it != eit; ++it) {
+        const SVFGEdge* edge = *it;
+        if (edge == outEdge || edge->getDstID() == nodeId)
+            continue;
+        assert(inEdge && "merging a node with other outgoing edges but no edge from rep");
+        addNewSVFGEdge(repId, edge->getDstID(), inEdge, edge);
+    }
+
+    removeAllEdges(node);
+    removeSVFGNode(const_cast<SVFGNode*>(node));
+}
+
+/*!
+ * Merge the MSSAPHI nodes of a function which have the same incoming edges, they get the same objects.
+ * Repeat until nothing is merged, as the successors of merged nodes may have the same incoming edges now.
+ */
+void SVFGOPT::mergeEquivalentMSSAPHINodes()
+{
+    bool merged = true;
+    while (merged) {
+        merged = false;
+
+        std::map<MSSAPHIInEdgesKey, const SVFGNode*> keyToRep;
+        std::vector<std::pair<const SVFGNode*, const SVFGNode*> > toMerge;
+        for (SVFG::const_iterator it = begin(), eit = end(); it != eit; ++it) {
+            const SVFGNode* node = it->second;
+            if (isMergeableMSSAPHI(node) == false || node->hasIncomingEdge() == false)
+                continue;
+
+            MSSAPHIInEdgesKey key;
+            getMSSAPHIInEdgesKey(node, key);
+            std::pair<std::map<MSSAPHIInEdgesKey, const SVFGNode*>::iterator, bool> res =
+                keyToRep.insert(std::make_pair(key, node));
+            if (res.second == false)
+                toMerge.push_back(std::make_pair(node, res.first->second));
+        }
+
+        /// nodes with the same key keep the same incoming edges while their predecessors are merged
+        for (u32_t i = 0; i < toMerge.size(); i++) {
+            const SVFGNode* node = toMerge[i].first;
+            NodeID repId = toMerge[i].second->getId();
+
+            SVFGEdgeSetTy outEdges = node->getOutEdges();
+            for (SVFGEdgeSetTy::const_iterator it = outEdges.begin(), eit = outEdges.end(); it != eit; ++it) {
+                NodeID dstId = (*it)->getDstID() == node->getId() ? repId : (*it)->getDstID();
+                addIndirectSVFGEdgeLike(repId, dstId, *it);
+            }
+            removeAllEdges(node);
+            removeSVFGNode(const_cast<SVFGNode*>(node));
+            merged = true;
+        }
+    }
+}
+
+/*!
+ * The function of a MSSAPHI node followed by (src, kind, call site, label) of its incoming edges.
+ * A self cycle refers to the node itself, so a node's key differs from any other node's then.
+ */
+void SVFGOPT::getMSSAPHIInEdgesKey(const SVFGNode* node, MSSAPHIInEdgesKey& key) const
+{
+    key.first = node->getBB()->getParent();
+    for (SVFGNode::const_iterator it = node->InEdgeBegin(), eit = node->InEdgeEnd(); it != eit; ++it) {
+        const SVFGEdge* edge = *it;
+        assert(isa<IndirectSVFGEdge>(edge) && "MSSAPHI node with a direct incoming edge");
+        CallSiteID csId = 0;
+        if (const CallIndSVFGEdge* callEdge = dyn_cast<CallIndSVFGEdge>(edge))
+            csId = callEdge->getCallSiteId();
+        else if (const RetIndSVFGEdge* retEdge = dyn_cast<RetIndSVFGEdge>(edge))
+            csId = retEdge->getCallSiteId();
+        key.second.push_back(edge->getSrcID());
+        key.second.push_back(edge->getEdgeKind());
+        key.second.push_back(csId);
+        key.second.push_back(cast<IndirectSVFGEdge>(edge)->getLabel());
+    }
+}
+
+/*!
+ * Add an indirect edge from src to dst of the same kind, call site and objects as edge
+ */
+SVFGEdge* SVFGOPT::addIndirectSVFGEdgeLike(NodeID srcId, NodeID dstId, const SVFGEdge* edge)
+{
+    const PointsTo& pts = cast<IndirectSVFGEdge>(edge)->getPointsTo();
+    if (const CallIndSVFGEdge* callEdge = dyn_cast<CallIndSVFGEdge>(edge))
+        return addCallIndirectSVFGEdge(srcId, dstId, callEdge->getCallSiteId(), pts);
+    else if (const RetIndSVFGEdge* retEdge = dyn_cast<RetIndSVFGEdge>(edge))
+        return addRetIndirectSVFGEdge(srcId, dstId, retEdge->getCallSiteId(), pts);
+    else {
+        assert(isa<IntraIndSVFGEdge>(edge) && "unexpected outgoing edge of MSSAPHI node");
+        return addIntraIndirectVFEdge(srcId, dstId, pts);
+    }
+}
+
 /*!
  *  Remove MSSAPHI SVFG nodes.
  */
@@ -469,11 +826,10 @@ bool SVFGOPT::addNewSVFGEdge(NodeID srcId, NodeID dstId, const SVFGEdge* preEdge
     const IndirectSVFGEdge* preIndEdge = llvm::cast<IndirectSVFGEdge>(preEdge);
     const IndirectSVFGEdge* succIndEdge = llvm::cast<IndirectSVFGEdge>(succEdge);
 
-    PointsTo intersection = preIndEdge->getPointsTo();
-    intersection &= succIndEdge->getPointsTo();
-
-    if (intersection.empty())
+    IndirectSVFGEdge::LabelID label = IndirectSVFGEdgeLabels::intersectLabels(preIndEdge->getLabel(), succIndEdge->getLabel());
+    if (label == IndirectSVFGEdgeLabels::EmptyLabel)
         return false;
+    const PointsTo& intersection = IndirectSVFGEdgeLabels::getPointsTo(label);
 
     assert(bothInterEdges(preEdge, succEdge) == false && "both edges are inter edges");
 
@@ -219,6 +219,8 @@ void SVFGStat::performStat()
     PTNumStatMap["IndRetEdge"] = totalIndRetEdge;
     PTNumStatMap["DirectCallEdge"] = totalDirCallEdge;
     PTNumStatMap["DirectRetEdge"] = totalDirRetEdge;
+    PTNumStatMap["IndEdgeLabels"] = IndirectSVFGEdgeLabels::getNumOfLabels();
+    PTNumStatMap.insert(optPassNumMap.begin(), optPassNumMap.end());
 
     PTNumStatMap["AvgInDegree"] = avgInDegree;
     PTNumStatMap["AvgOutDegree"] = avgOutDegree;
@@ -13,6 +13,17 @@
 template<>
 CtxPAG<ctx::CallSite>* CtxPAG<ctx::CallSite>::ctxPAG = nullptr;
 
+CallSitePAG::CallSitePAG(SVFModule &module, PTACallGraph *callGraph, bool cloneReachable) : CtxPAG<ctx::CallSite>(), module(module), callGraph(callGraph) {
+    // TODO: not a good practice!! change it to singleton pattern later!
+    CallSitePAG::ctxPAG = this;
+    this->cloneReachable = cloneReachable;
+}
+
+ctx::CallSiteTree &ctx::CallSite::getTree() {
+    static CallSiteTree tree;
+    return tree;
+}
+
 void CallSitePAG::recAddNodes(PAGNode *node, PTACallGraphNode *callGraphNode, ctx::CallSite &ctx, int depth) {
     if (depth == 0 || !callGraphNode->hasIncomingEdge()) {
         addNodeInCtx(node, ctx);
@@ -36,50 +47,64 @@ void CallSitePAG::addNodeWithCallSite(PAGNode *node, const llvm::Function *func)
     recAddNodes(node, callGraphNode, callChain, K_LIMIT);
 }
 
+const llvm::Function *CallSitePAG::getOwnerFunction(PAGNode *node) {
+    if (!node->hasValue()) {
+        // Dummy node
+        return nullptr;
+    }
+
+    const llvm::Value *value = node->getValue();
+    if (auto *inst = llvm::dyn_cast<llvm::Instruction>(value)) {
+        return inst->getParent()->getParent();
+    } else if (auto *func = llvm::dyn_cast<llvm::Function>(value)) {
+        // function pointer?
+        if (node->getNodeKind() != PAGNode::RetNode && node->getNodeKind() != PAGNode::VarargNode) {
+            return nullptr;
+        }
+        //return node or varargs Node
+        return func;
+    } else if (auto *arg = llvm::dyn_cast<llvm::Argument>(value)) {
+        return arg->getParent();
+    }
+    // TODO: may need to be handled later, GLOBAL VARIABLES?
+    // constants and INLINE ASM
+    return nullptr;
+}
+
+ctx::CallSite CallSitePAG::getCalleeCtx(const ctx::CallSite &callerCtx, PTACallGraphNode *caller) {
+    ctx::CallSite calleeCtx = callerCtx;
+    if (calleeCtx.getDepth() < K_LIMIT) {
+        calleeCtx.addNodeInFront(caller);
+    } else {
+        assert(calleeCtx.getDepth() == K_LIMIT);
+        calleeCtx.addNodeInFrontAndPopBack(caller);
+    }
+    return calleeCtx;
+}
+
 void CallSitePAG::addNodes() {
     for (auto it = pag->begin(); it != pag->end(); it++) {
         // iterate over pag node, and duplicated them when they can be in different call site
         PAGNode *pagNode = it->second;
 
-        if (pagNode->hasValue()) {
-            const llvm::Value *value = pagNode->getValue();
-
-            if (llvm::isa<llvm::Instruction>(value)) {
-                auto *inst = llvm::dyn_cast<llvm::Instruction>(value);
-                auto func = inst->getParent()->getParent();
+        const llvm::Function *func = getOwnerFunction(pagNode);
+        if (func == nullptr) {
+            if (pagNode->hasValue()) {
+                addNodeInCtx(pagNode, ctx::CallSite::emptyCtx());
+            } else {
+                // Dummy node
+                assert(pagNode->getNodeKind() == PAGNode::DummyObjNode||
+                       pagNode->getNodeKind() == PAGNode::DummyValNode);
 
-                addNodeWithCallSite(pagNode, func);
-            } else if (llvm::isa<llvm::Function>(value)) {
-                // function pointer?
-                if (pagNode->getNodeKind() != PAGNode::RetNode && pagNode->getNodeKind() != PAGNode::VarargNode) {
+                if (pagNode->getId() > 3) {
                     addNodeInCtx(pagNode, ctx::CallSite::emptyCtx());
-                    continue;
                 }
-
-                //return node or varargs Node
-                auto func = llvm::dyn_cast<llvm::Function>(value);
-                addNodeWithCallSite(pagNode, func);
-            } else if (llvm::isa<llvm::Argument>(value)) {
-                auto *arg = llvm::dyn_cast<llvm::Argument>(value);
-                auto func = arg->getParent();
-
-                addNodeWithCallSite(pagNode, func);
-            } else if (llvm::isa<llvm::Constant>(value)) {
-                auto *cons = llvm::dyn_cast<llvm::Constant>(value);
-                // TODO: may need to be handled later, GLOBAL VARIABLES?
-                addNodeInCtx(pagNode, ctx::CallSite::emptyCtx());
-            } else {
-                //INLINE ASM
-                addNodeInCtx(pagNode, ctx::CallSite::emptyCtx());
             }
+        } else if (isCloningReachable()) {
+            // cloned once the function is reached in a context
+            funcToNodes[func].push_back(pagNode);
         } else {
-            // Dummy node
-            assert(pagNode->getNodeKind() == PAGNode::DummyObjNode||
-                   pagNode->getNodeKind() == PAGNode::DummyValNode);
-
-            if (pagNode->getId() > 3) {
-                addNodeInCtx(pagNode, ctx::CallSite::emptyCtx());
-            }
+            addNodeWithCallSite(pagNode, func);
         }
     }
 }
@@ -87,17 +112,11 @@ void CallSitePAG::addNodes() {
 void CallSitePAG::recAddCtxCallEdges(PAGNode *src, PAGNode *dst, PTACallGraphNode *callGraphNode,
                                      PTACallGraphNode *curFunc, ctx::CallSite &ctx, CallPE *callEdge, int depth) {
     if (depth == 0 || !callGraphNode->hasIncomingEdge()) {
-        ctx::CallSite calleeCtx = ctx;
-        if (calleeCtx.getCallChain()->size() < K_LIMIT) {
-            calleeCtx.addNodeInFront(curFunc);
-        } else {
-            assert(calleeCtx.getCallChain()->size() == K_LIMIT);
-            calleeCtx.addNodeInFrontAndPopBack(curFunc);
-        }
+        ctx::CallSite calleeCtx = getCalleeCtx(ctx, curFunc);
 
-        auto ctxCallerNode = inSensToSensIDMap.find(std::make_pair(src->getId(), ctx));
+        auto ctxCallerNode = inSensToSensIDMap.find(getCtxInSensID(src->getId(), ctx));
         assert(ctxCallerNode != inSensToSensIDMap.end());
-        auto ctxCalleeNode = inSensToSensIDMap.find(std::make_pair(dst->getId(), calleeCtx));
+        auto ctxCalleeNode = inSensToSensIDMap.find(getCtxInSensID(dst->getId(), calleeCtx));
         assert(ctxCalleeNode != inSensToSensIDMap.end());
 
         auto *srcNode = getGNode(ctxCallerNode->second);
@@ -146,17 +165,11 @@ void CallSitePAG::dupCtxCallEdge(CallPE *callEdge) {
 void CallSitePAG::recAddCtxRetEdges(PAGNode *src, PAGNode *dst, PTACallGraphNode *callGraphNode,
                                      PTACallGraphNode *curFunc, ctx::CallSite &ctx, RetPE *retEdge, int depth) {
     if (depth == 0 || !callGraphNode->hasIncomingEdge()) {
-        ctx::CallSite calleeCtx = ctx;
-        if (calleeCtx.getCallChain()->size() < K_LIMIT) {
-            calleeCtx.addNodeInFront(curFunc);
-        } else {
-            assert(calleeCtx.getCallChain()->size() == K_LIMIT);
-            calleeCtx.addNodeInFrontAndPopBack(curFunc);
-        }
+        ctx::CallSite calleeCtx = getCalleeCtx(ctx, curFunc);
 
-        auto ctxCallerNode = inSensToSensIDMap.find(std::make_pair(dst->getId(), ctx));
+        auto ctxCallerNode = inSensToSensIDMap.find(getCtxInSensID(dst->getId(), ctx));
         assert(ctxCallerNode != inSensToSensIDMap.end());
-        auto ctxCalleeNode = inSensToSensIDMap.find(std::make_pair(src->getId(), calleeCtx));
+        auto ctxCalleeNode = inSensToSensIDMap.find(getCtxInSensID(src->getId(), calleeCtx));
         assert(ctxCalleeNode != inSensToSensIDMap.end());
 
         auto *dstNode = getGNode(ctxCallerNode->second);
@@ -197,6 +210,194 @@ void CallSitePAG::dupCtxRetEdge(RetPE *retEdge) {
     addCtxRetEdges(srcNode, dstNode, retEdge, llvm::dyn_cast<llvm::Instruction>(dstNode->getValue())->getParent()->getParent());
 }
 
+/*!
+ * Cloning of the reachable instances: a function is cloned under a context only when it is reached in that context
+ * over the call graph, starting from the program entry and the address-taken functions without a caller
+ * (e.g. thread routines). Functions which are never reached get no clone at all.
+ * Reachability is not driven by points-to facts: a reached instance is cloned with all its nodes and edges,
+ * even if no points-to fact ever flows into it.
+ */
+void CallSitePAG::addEdges() {
+    if (!isCloningReachable()) {
+        CtxPAG<ctx::CallSite>::addEdges();
+        return;
+    }
+
+    indexEdges();
+
+    for (auto it = callGraph->begin(); it != callGraph->end(); it++) {
+        PTACallGraphNode *callGraphNode = it->second;
+        const llvm::Function *func = callGraphNode->getFunction();
+        if (callGraphNode->hasIncomingEdge()) {
+            continue;
+        }
+        if (analysisUtil::isProgEntryFunction(func) || func->hasAddressTaken()) {
+            reachInstance(func, ctx::CallSite::emptyCtx());
+        }
+    }
+    cloneReachedInstances();
+}
+
+void CallSitePAG::indexEdges() {
+    const PAGEdge::PEDGEK intraKinds[] = {PAGEdge::Addr, PAGEdge::Copy, PAGEdge::Load, PAGEdge::Store,
+                                          PAGEdge::VariantGep, PAGEdge::NormalGep};
+    for (PAGEdge::PEDGEK kind : intraKinds) {
+        for (PAGEdge *edge : pag->getEdgeSet(kind)) {
+            const llvm::Function *func = getOwnerFunction(edge->getSrcNode());
+            if (func == nullptr) {
+                func = getOwnerFunction(edge->getDstNode());
+            }
+
+            if (func == nullptr) {
+                // between nodes without context, cloned once
+                cloneIntraEdge(edge, getCloneInCtx(edge->getSrcNode(), ctx::CallSite::emptyCtx()),
+                               getCloneInCtx(edge->getDstNode(), ctx::CallSite::emptyCtx()));
+            } else {
+                funcToIntraEdges[func].push_back(edge);
+            }
+        }
+    }
+
+    // same restrictions as dupCtxCallEdge/dupCtxRetEdge
+    for (PAGEdge *edge : pag->getEdgeSet(PAGEdge::Call)) {
+        if (!edge->getSrcNode()->hasValue() || !edge->getDstNode()->hasValue()) {
+            continue;
+        }
+        if (auto *srcInst = llvm::dyn_cast<llvm::Instruction>(edge->getSrcNode()->getValue())) {
+            funcToCallEdges[srcInst->getParent()->getParent()].push_back(edge);
+        }
+    }
+    for (PAGEdge *edge : pag->getEdgeSet(PAGEdge::Ret)) {
+        if (!edge->getSrcNode()->hasValue() || !edge->getDstNode()->hasValue()) {
+            continue;
+        }
+        auto *dstInst = llvm::dyn_cast<llvm::Instruction>(edge->getDstNode()->getValue());
+        assert(dstInst);
+        funcToCallEdges[dstInst->getParent()->getParent()].push_back(edge);
+    }
+}
+
+void CallSitePAG::reachInstance(const llvm::Function *func, const ctx::CallSite &ctx) {
+    // a function without contexts has a single instance, whatever context it is reached in
+    FuncInstance instance(func, ctx);
+    if (selection != nullptr && !selection->isCtxSensitive(func)) {
+        instance.second = ctx::CallSite::emptyCtx();
+    }
+
+    if (reachedInstances.insert(instance).second) {
+        instancesToClone.push_back(instance);
+    }
+}
+
+bool CallSitePAG::hasCtx(PAGNode *node) const {
+    const llvm::Function *func = getOwnerFunction(node);
+    if (func == nullptr) {
+        return false;
+    }
+    return selection == nullptr || selection->isCtxSensitive(node, func);
+}
+
+CtxPAGNode<ctx::CallSite> *CallSitePAG::getCloneInCtx(PAGNode *node, const ctx::CallSite &ctx) {
+    return getCtxNode(node->getId(), hasCtx(node) ? ctx : ctx::CallSite::emptyCtx());
+}
+
+void CallSitePAG::cloneInstance(const FuncInstance &instance) {
+    auto nodes = funcToNodes.find(instance.first);
+    if (nodes != funcToNodes.end()) {
+        for (PAGNode *node : nodes->second) {
+            if (hasCtx(node)) {
+                addNodeInCtx(node, instance.second);
+            } else if (!hasCtxNode(node->getId(), ctx::CallSite::emptyCtx())) {
+                // shared by all instances of the function
+                addNodeInCtx(node, ctx::CallSite::emptyCtx());
+            }
+        }
+    }
+
+    auto edges = funcToIntraEdges.find(instance.first);
+    if (edges != funcToIntraEdges.end()) {
+        for (PAGEdge *edge : edges->second) {
+            cloneIntraEdge(edge, getCloneInCtx(edge->getSrcNode(), instance.second),
+                           getCloneInCtx(edge->getDstNode(), instance.second));
+        }
+    }
+}
+
+void CallSitePAG::addInstanceCallEdges(const FuncInstance &instance) {
+    auto edges = funcToCallEdges.find(instance.first);
+    if (edges == funcToCallEdges.end()) {
+        return;
+    }
+
+    const ctx::CallSite &callerCtx = instance.second;
+    ctx::CallSite calleeCtx = getCalleeCtx(callerCtx, callGraph->getCallGraphNode(instance.first));
+    for (PAGEdge *edge : edges->second) {
+        if (llvm::isa<CallPE>(edge)) {
+            cloneInterEdge(edge, getCloneInCtx(edge->getSrcNode(), callerCtx), getCloneInCtx(edge->getDstNode(), calleeCtx));
+        } else {
+            cloneInterEdge(edge, getCloneInCtx(edge->getSrcNode(), calleeCtx), getCloneInCtx(edge->getDstNode(), callerCtx));
+        }
+    }
+}
+
+/*!
+ * Clone the reached function instances, and transitively the instances of their callees.
+ * The call/ret edges of an instance are added once all its callee instances exist.
+ */
+bool CallSitePAG::cloneReachedInstances() {
+    if (instancesToClone.empty()) {
+        return false;
+    }
+
+    std::vector<FuncInstance> cloned;
+    while (!instancesToClone.empty()) {
+        FuncInstance instance = instancesToClone.back();
+        instancesToClone.pop_back();
+
+        cloneInstance(instance);
+        cloned.push_back(instance);
+
+        PTACallGraphNode *callGraphNode = callGraph->getCallGraphNode(instance.first);
+        ctx::CallSite calleeCtx = getCalleeCtx(instance.second, callGraphNode);
+        for (auto outEdge = callGraphNode->OutEdgeBegin(); outEdge != callGraphNode->OutEdgeEnd(); outEdge++) {
+            reachInstance((*outEdge)->getDstNode()->getFunction(), calleeCtx);
+        }
+    }
+
+    for (const FuncInstance &instance : cloned) {
+        addInstanceCallEdges(instance);
+    }
+    return true;
+}
+
+/*!
+ * The callee of a resolved indirect call runs in the context extended by the caller, just like a direct callee.
+ * When only reachable instances are cloned, the callee instance is cloned here if it was not reached before,
+ * otherwise it exists already because the pre-built call graph contains the call edge.
+ */
+bool CallSitePAG::connectIndirectCall(llvm::CallSite cs, const llvm::Function *callee, const ctx::CallSite &callerCtx) {
+    const llvm::Function *caller = cs.getInstruction()->getParent()->getParent();
+    ctx::CallSite calleeCtx = getCalleeCtx(callerCtx, callGraph->getCallGraphNode(caller));
+
+    if (isCloningReachable()) {
+        reachInstance(callee, calleeCtx);
+        cloneReachedInstances();
+    }
+
+    std::vector<PAGEdge *> edges;
+    getIndirectCallEdges(cs, callee, edges);
+
+    bool connected = false;
+    for (PAGEdge *edge : edges) {
+        if (llvm::isa<CallPE>(edge)) {
+            connected |= cloneInterEdge(edge, getCloneInCtx(edge->getSrcNode(), callerCtx), getCloneInCtx(edge->getDstNode(), calleeCtx));
+        } else {
+            connected |= cloneInterEdge(edge, getCloneInCtx(edge->getSrcNode(), calleeCtx), getCloneInCtx(edge->getDstNode(), callerCtx));
+        }
+    }
+    return connected;
+}
+
 void CallSitePAG::dump(std::string name) {
     llvm::GraphPrinter::WriteGraphToFile(llvm::outs(), name, this);
 }
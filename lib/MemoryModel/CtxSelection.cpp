@@ -0,0 +1,164 @@
+//===- CtxSelection.cpp -- Selective context sensitivity----------------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MemoryModel/CtxSelection.h"
+#include "MemoryModel/CallSitePAG.h"
+#include "MemoryModel/PointerAnalysis.h"
+
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+static llvm::cl::opt<unsigned long long> CtxSelMaxCost("ctx-sel-max-cost", llvm::cl::init(100000),
+        llvm::cl::desc("Functions whose estimated cost of one more context exceeds it stay context-insensitive"));
+
+static llvm::cl::opt<unsigned> CtxSelMaxPointedBy("ctx-sel-max-pointed-by", llvm::cl::init(100),
+        llvm::cl::desc("Objects pointed by more pointers stay context-insensitive"));
+
+static llvm::cl::opt<std::string> CtxSelDump("ctx-sel-dump", llvm::cl::init(""),
+        llvm::cl::desc("Dump the context sensitivity decisions into the given file"));
+
+void CtxSelection::computeCosts() {
+    PAG *pag = pta->getPAG();
+    PTACallGraph *callGraph = pta->getPTACallGraph();
+
+    for (auto it = callGraph->begin(), eit = callGraph->end(); it != eit; ++it) {
+        PTACallGraphNode *node = it->second;
+        FuncCost &cost = funcCosts[node->getFunction()];
+        for (auto inEdge = node->InEdgeBegin(); inEdge != node->InEdgeEnd(); inEdge++) {
+            cost.fanIn += (*inEdge)->getDirectCalls().size() + (*inEdge)->getIndirectCalls().size();
+        }
+    }
+
+    for (auto it = pag->begin(), eit = pag->end(); it != eit; ++it) {
+        PAGNode *node = it->second;
+        if (!node->isPointer() || llvm::isa<ObjPN>(node)) {
+            continue;
+        }
+
+        const PointsTo &pts = pta->getPts(node->getId());
+        for (NodeID obj : pts) {
+            if (const MemObj *memObj = pag->getObject(obj)) {
+                objCosts[memObj].pointedBy++;
+            }
+        }
+
+        if (const llvm::Function *func = CallSitePAG::getOwnerFunction(node)) {
+            funcCosts[func].ptsVolume += pts.count();
+        }
+    }
+
+    for (auto it = pag->begin(), eit = pag->end(); it != eit; ++it) {
+        PAGNode *node = it->second;
+        const llvm::Function *func = CallSitePAG::getOwnerFunction(node);
+        if (func == nullptr) {
+            continue;
+        }
+
+        FuncCost &cost = funcCosts[func];
+        cost.numOfNodes++;
+        // field objects share the memory object of their base, which is counted once
+        auto *obj = llvm::dyn_cast<ObjPN>(node);
+        if (obj != nullptr && !llvm::isa<GepObjPN>(node) && obj->getMemObj()->isHeap()) {
+            cost.numOfHeapObjs++;
+            cost.heapPointedBy += objCosts[obj->getMemObj()].pointedBy;
+        }
+    }
+}
+
+void CtxSelection::select() {
+    computeCosts();
+
+    for (auto &entry : funcCosts) {
+        FuncCost &cost = entry.second;
+        cost.cost = (cost.ptsVolume + cost.heapPointedBy) * cost.fanIn;
+        if (cost.cost > CtxSelMaxCost) {
+            cost.sensitive = false;
+            numOfInsensitiveFuncs++;
+        }
+    }
+
+    for (auto &entry : objCosts) {
+        if (entry.second.pointedBy > CtxSelMaxPointedBy) {
+            entry.second.sensitive = false;
+            numOfInsensitiveObjs++;
+        }
+    }
+
+    if (!CtxSelDump.empty()) {
+        dump(CtxSelDump);
+    }
+}
+
+bool CtxSelection::isCtxSensitive(const llvm::Function *func) const {
+    auto it = funcCosts.find(func);
+    return it == funcCosts.end() || it->second.sensitive;
+}
+
+bool CtxSelection::isCtxSensitive(const MemObj *obj) const {
+    auto it = objCosts.find(obj);
+    return it == objCosts.end() || it->second.sensitive;
+}
+
+bool CtxSelection::isCtxSensitive(const PAGNode *node, const llvm::Function *func) const {
+    if (!isCtxSensitive(func)) {
+        return false;
+    }
+    if (auto *obj = llvm::dyn_cast<ObjPN>(node)) {
+        return isCtxSensitive(obj->getMemObj());
+    }
+    return true;
+}
+
+/*!
+ * One line per function and per object allocated in a function:
+ *  fun <name> <sensitive|insensitive> cost=.. fanIn=.. nodes=.. heapObjs=.. ptsVolume=..
+ *  obj <symbol id> <sensitive|insensitive> pointedBy=.. <allocation site>
+ */
+void CtxSelection::dump(const std::string &fileName) const {
+    std::error_code err;
+    llvm::raw_fd_ostream out(fileName, err, llvm::sys::fs::F_None);
+    if (err) {
+        llvm::errs() << "cannot open " << fileName << ": " << err.message() << "\n";
+        return;
+    }
+
+    for (const auto &entry : funcCosts) {
+        const FuncCost &cost = entry.second;
+        out << "fun " << entry.first->getName() << (cost.sensitive ? " sensitive" : " insensitive")
+            << " cost=" << cost.cost << " fanIn=" << cost.fanIn << " nodes=" << cost.numOfNodes
+            << " heapObjs=" << cost.numOfHeapObjs << " ptsVolume=" << cost.ptsVolume << "\n";
+    }
+
+    for (const auto &entry : objCosts) {
+        const MemObj *obj = entry.first;
+        const llvm::Value *value = obj->getRefVal();
+        const auto *inst = llvm::dyn_cast_or_null<llvm::Instruction>(value);
+        if (inst == nullptr) {
+            // globals, functions and dummies never have contexts
+            continue;
+        }
+        out << "obj " << obj->getSymId() << (entry.second.sensitive ? " sensitive" : " insensitive")
+            << " pointedBy=" << entry.second.pointedBy << " " << inst->getFunction()->getName()
+            << ":" << *inst << "\n";
+    }
+}
@@ -8,70 +8,157 @@
 #include "Util/GraphUtil.h"
 #include "Util/AnalysisUtil.h"
 #include "Util/GraphUtil.h"
+#include "Util/SCC.h"
+#include "Util/ThreadAPI.h"
 
-//#define ORIGINS "gc_collect"
-//#define ORIGINS "u_undo", "change_indent"
-#define ORIGINS "commit_tree" , "merge_trees"
+#include <llvm/IR/InstIterator.h>
+#include <llvm/Support/CommandLine.h>
+#include <fstream>
+
+static llvm::cl::list<std::string> OriginEntries("origin-entries", llvm::cl::CommaSeparated,
+        llvm::cl::desc("Entry functions of the origins (comma separated)"));
+
+static llvm::cl::opt<std::string> OriginEntriesFile("origin-entries-file", llvm::cl::init(""),
+        llvm::cl::desc("File listing entry functions of the origins, one per line"));
+
+static llvm::cl::opt<bool> OriginThreads("origin-threads", llvm::cl::init(true),
+        llvm::cl::desc("Use the start routines of the forked threads as origin entries"));
+
+static llvm::cl::opt<bool> OriginCallbacks("origin-callbacks", llvm::cl::init(false),
+        llvm::cl::desc("Use the functions registered to external functions (event handlers, signal handlers...) as origin entries"));
 
 template<>
 CtxPAG<OriginID>* CtxPAG<OriginID>::ctxPAG = nullptr;
 
-void OriginPAG::markOrigin(llvm::Function *root, u32_t id) {
-    funcToOrigins[root].set(id);
-    std::stack<const PTACallGraphNode*> nodeStack;
-    auto rootNode = callGraph->getCallGraphNode(root);
+void OriginPAG::addOriginEntry(const llvm::Function *func) {
+    if (func == nullptr || func->isDeclaration())
+        return;
+    if (std::find(originEntries.begin(), originEntries.end(), func) == originEntries.end())
+        originEntries.push_back(func);
+}
+
+/*!
+ * Origin entries given on the command line come first (in the order given), then the discovered ones
+ */
+void OriginPAG::collectOriginEntries() {
+    std::vector<std::string> names(OriginEntries.begin(), OriginEntries.end());
+    if (!OriginEntriesFile.empty()) {
+        std::ifstream file(OriginEntriesFile);
+        if (!file.is_open())
+            analysisUtil::wrnMsg("cannot open origin entries file " + OriginEntriesFile);
+
+        std::string line;
+        while (std::getline(file, line)) {
+            line.erase(0, line.find_first_not_of(" \t"));
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (!line.empty() && line[0] != '#')
+                names.push_back(line);
+        }
+    }
+
+    for (const std::string &name : names) {
+        llvm::Function *func = module.getFunction(name);
+        if (func == nullptr || func->isDeclaration()) {
+            analysisUtil::wrnMsg("origin entry " + name + " is not defined in the module");
+            continue;
+        }
+        addOriginEntry(func);
+    }
 
-    NodeBS visitedNodes;
-    nodeStack.push(rootNode);
-    visitedNodes.set(rootNode->getId());
+    if (!OriginThreads && !OriginCallbacks)
+        return;
 
-    while (!nodeStack.empty()) {
-        auto *node = const_cast<PTACallGraphNode*>(nodeStack.top());
-        nodeStack.pop();
+    ThreadAPI *threadAPI = ThreadAPI::getThreadAPI();
+    for (const llvm::Function *func : module) {
+        for (const llvm::Instruction &inst : llvm::instructions(func)) {
+            if (!analysisUtil::isCallSite(&inst))
+                continue;
 
-        for (auto it = node->OutEdgeBegin(), eit = node->OutEdgeEnd(); it != eit; ++it) {
-            PTACallGraphEdge* edge = *it;
+            if (threadAPI->isTDFork(&inst)) {
+                // only start routines passed directly are known before solving
+                if (OriginThreads)
+                    addOriginEntry(llvm::dyn_cast<llvm::Function>(threadAPI->getForkedFun(&inst)->stripPointerCasts()));
+                continue;
+            }
 
-            if (visitedNodes.test_and_set(edge->getDstID())) {
-                nodeStack.push(edge->getDstNode());
+            llvm::CallSite cs = analysisUtil::getLLVMCallSite(&inst);
+            const llvm::Function *callee = analysisUtil::getCallee(cs);
+            if (!OriginCallbacks || callee == nullptr || !callee->isDeclaration() || callee->isIntrinsic())
+                continue;
 
-                funcToOrigins[edge->getDstNode()->getFunction()].set(id);
+            // a function passed to an external function is a callback invoked from outside the module
+            for (auto it = cs.arg_begin(), eit = cs.arg_end(); it != eit; ++it) {
+                addOriginEntry(llvm::dyn_cast<llvm::Function>((*it)->stripPointerCasts()));
             }
         }
     }
 }
 
+/*!
+ * Every function is in the default origin (0). A function is also in the origin of every entry it is reachable from,
+ * which is propagated once over the call graph SCCs in topological order (callers before callees).
+ * Origin entries themselves are only in their own origin.
+ * Origins are not updated when the solver resolves more indirect calls, so the call graph has to be
+ * complete already, i.e. the Andersen call graph (asserted by OriginSensitive).
+ */
 void OriginPAG::markFuncOrigins() {
-    // categorize functions into different origins.
-    std::vector<std::string> origins = {ORIGINS};
-    std::vector<std::pair<llvm::Function *, uint>> entryFunctions;
-
-    for (auto func : this->module) {
-        // default origin, can be accessed from main
-        markOrigin(func, 0);
-
-        int inOriginNum = -1;
-        for (int i = 0; i < origins.size(); i++) {
-            if (func->getName().equals(origins[i])) {
-                inOriginNum = i + 1;
-                entryFunctions.push_back(std::make_pair(func, i));
-                break;
-            }
+    collectOriginEntries();
+
+    std::map<const llvm::Function *, u32_t> entryToOrigin;
+    for (u32_t i = 0; i < originEntries.size(); i++) {
+        entryToOrigin[originEntries[i]] = i + 1;
+    }
+
+    SCCDetection<PTACallGraph *> scc(callGraph);
+    scc.find();
+
+    std::map<NodeID, Origins> sccToOrigins;
+    auto &topoOrder = scc.topoNodeStack();
+    while (!topoOrder.empty()) {
+        NodeID rep = topoOrder.top();
+        topoOrder.pop();
+
+        // origins flowing in from the callers are already merged
+        Origins reached = sccToOrigins[rep];
+        sccToOrigins.erase(rep);
+
+        const NodeBS &subNodes = scc.subNodes(rep);
+        for (NodeID id : subNodes) {
+            auto it = entryToOrigin.find(callGraph->getCallGraphNode(id)->getFunction());
+            if (it != entryToOrigin.end())
+                reached.set(it->second);
         }
 
-        if (inOriginNum > 0) {
-            markOrigin(func, inOriginNum);
+        for (NodeID id : subNodes) {
+            PTACallGraphNode *node = callGraph->getCallGraphNode(id);
+            for (auto it = node->OutEdgeBegin(), eit = node->OutEdgeEnd(); it != eit; ++it) {
+                NodeID dstRep = scc.repNode((*it)->getDstID());
+                if (dstRep != rep)
+                    sccToOrigins[dstRep] |= reached;
+            }
+
+            Origins &origins = funcToOrigins[node->getFunction()];
+            origins = reached;
+            origins.set(0);
         }
     }
 
-    assert(entryFunctions.size() == origins.size());
-
-    for (const std::pair<llvm::Function *, uint> &entry: entryFunctions) {
+    for (const auto &entry : entryToOrigin) {
         funcToOrigins[entry.first].clear();
         funcToOrigins[entry.first].set(entry.second);
     }
 }
 
+/*!
+ * Nodes not selected for context sensitivity are in no origin, they have a single clone without context
+ */
+OriginPAG::Origins OriginPAG::getNodeOrigins(PAGNode *node, const llvm::Function *func) {
+    if (selection != nullptr && !selection->isCtxSensitive(node, func)) {
+        return Origins();
+    }
+    return funcToOrigins[func];
+}
+
 void OriginPAG::addNodeInOrigins(PAGNode *node, OriginPAG::Origins &origins) {
     if (origins.empty()) {
         addNodeInCtx(node, OriginID::emptyCtx());
@@ -97,7 +184,7 @@ void OriginPAG::addNodes() {
                 auto *inst = llvm::dyn_cast<llvm::Instruction>(value);
 
                 auto func = inst->getParent()->getParent();
-                auto origins = funcToOrigins[func];
+                auto origins = getNodeOrigins(pagNode, func);
                 addNodeInOrigins(pagNode, origins);
             } else if (llvm::isa<llvm::Function>(value)) {
                 // function pointer?
@@ -108,14 +195,14 @@ void OriginPAG::addNodes() {
 
                 //return node
                 auto func = llvm::dyn_cast<llvm::Function>(value);
-                auto origins = funcToOrigins[func];
+                auto origins = getNodeOrigins(pagNode, func);
 
                 addNodeInOrigins(pagNode, origins);
             } else if (llvm::isa<llvm::Argument>(value)) {
                 auto *arg = llvm::dyn_cast<llvm::Argument>(value);
 
                 auto func = arg->getParent();
-                auto origins = funcToOrigins[func];
+                auto origins = getNodeOrigins(pagNode, func);
                 addNodeInOrigins(pagNode, origins);
             } else if (llvm::isa<llvm::Constant>(value)) {
                 auto *cons = llvm::dyn_cast<llvm::Constant>(value);
@@ -143,39 +230,7 @@ void OriginPAG::addNodes() {
 
 
 void OriginPAG::dupCtxRetEdge(RetPE *retEdge) {
-    assert(retEdge);
-
-    NodeID src = retEdge->getSrcID();
-    NodeID dest = retEdge->getDstID();
-    const auto &ctxSrcIDs = inSensToSensSetMap[src];
-    const auto &ctxDestIDs = inSensToSensSetMap[dest];
-
-    auto commonSet = commonOrigins(ctxSrcIDs, ctxDestIDs);
-    if (commonSet.empty()) {
-        // origin switch
-        for (NodeID srcID : ctxSrcIDs) {
-            for (NodeID destID : ctxDestIDs) {
-                auto *srcNode = getGNode(srcID);
-                auto *destNode = getGNode(destID);
-                addEdge(srcNode, destNode, new CtxRetPE<OriginID>(srcNode, destNode, retEdge));
-            }
-        }
-    } else {
-        //invoke in the same origin
-        for (OriginID id : commonSet) {
-            auto srcIt = inSensToSensIDMap.find(std::make_pair(src, id));
-            auto destIt = inSensToSensIDMap.find(std::make_pair(dest, id));
-            assert(srcIt != inSensToSensIDMap.end() && destIt != inSensToSensIDMap.end());
-
-            NodeID srcID = (*srcIt).second;
-            NodeID destID = (*destIt).second;
-
-            auto *srcNode = getGNode(srcID);
-            auto *destNode = getGNode(destID);
-            addEdge(srcNode, destNode, new CtxRetPE<OriginID>(srcNode, destNode, retEdge));
-        }
-    }
-
+    dupInterEdge<CtxRetPE<OriginID>>(retEdge);
 }
 
 std::set<uint32_t> OriginPAG::commonOrigins(const CtxPAG<OriginID>::CtxSenIDs &ctxSrcIDs, const CtxPAG<OriginID>::CtxSenIDs &ctxDestIDs) {
@@ -194,37 +249,60 @@ std::set<uint32_t> OriginPAG::commonOrigins(const CtxPAG<OriginID>::CtxSenIDs &c
 }
 
 void OriginPAG::dupCtxCallEdge(CallPE *callEdge) {
-    assert(callEdge);
-    NodeID src = callEdge->getSrcID();
-    NodeID dest = callEdge->getDstID();
-    const auto &ctxSrcIDs = inSensToSensSetMap[src];
-    const auto &ctxDestIDs = inSensToSensSetMap[dest];
-
-    auto commonSet = commonOrigins(ctxSrcIDs, ctxDestIDs);
-    if (commonSet.empty()) {
-        // origin switch
-        for (NodeID srcID : ctxSrcIDs) {
-            for (NodeID destID : ctxDestIDs) {
-                auto *srcNode = getGNode(srcID);
-                auto *destNode = getGNode(destID);
-                addEdge(srcNode, destNode, new CtxCallPE<OriginID>(srcNode, destNode, callEdge));
+    dupInterEdge<CtxCallPE<OriginID>>(callEdge);
+}
+
+/*!
+ * The start routine of a thread is only in the origin of the thread (unless threads are no origin entries),
+ * so the actual parameter in every origin of the forking function flows into that origin.
+ */
+void OriginPAG::dupCtxForkEdge(TDForkPE *forkEdge) {
+    dupInterEdge<CtxTDForkPE<OriginID>>(forkEdge);
+}
+
+/*!
+ * Back from the origin of the joined thread into every origin of the joining function
+ */
+void OriginPAG::dupCtxJoinEdge(TDJoinPE *joinEdge) {
+    dupInterEdge<CtxTDJoinPE<OriginID>>(joinEdge);
+}
+
+/*!
+ * Same as a direct call: stay in the caller's origin if the callee is cloned in it,
+ * otherwise switch into every origin of the callee.
+ */
+bool OriginPAG::connectIndirectCall(llvm::CallSite cs, const llvm::Function *callee, const OriginID &callerCtx) {
+    std::vector<PAGEdge *> edges;
+    getIndirectCallEdges(cs, callee, edges);
+
+    bool connected = false;
+    for (PAGEdge *edge : edges) {
+        bool isCall = llvm::isa<CallPE>(edge);
+        NodeID callerSide = isCall ? edge->getSrcID() : edge->getDstID();
+        NodeID calleeSide = isCall ? edge->getDstID() : edge->getSrcID();
+
+        OriginID ctx = hasCtxNode(callerSide, callerCtx) ? callerCtx : OriginID::emptyCtx();
+        CtxPAGNode<OriginID> *callerNode = getCtxNode(callerSide, ctx);
+
+        std::vector<CtxPAGNode<OriginID> *> calleeNodes;
+        if (hasCtxNode(calleeSide, callerCtx)) {
+            calleeNodes.push_back(getCtxNode(calleeSide, callerCtx));
+        } else {
+            // origin switch
+            for (NodeID id : getCtxSenIDs(calleeSide)) {
+                calleeNodes.push_back(getGNode(id));
             }
         }
-    } else {
-        //invoke in the same origin
-        for (OriginID id : commonSet) {
-            auto srcIt = inSensToSensIDMap.find(std::make_pair(src, id));
-            auto destIt = inSensToSensIDMap.find(std::make_pair(dest, id));
-            assert(srcIt != inSensToSensIDMap.end() && destIt != inSensToSensIDMap.end());
-
-            NodeID srcID = (*srcIt).second;
-            NodeID destID = (*destIt).second;
-
-            auto *srcNode = getGNode(srcID);
-            auto *destNode = getGNode(destID);
-            addEdge(srcNode, destNode, new CtxCallPE<OriginID>(srcNode, destNode, callEdge));
+
+        for (CtxPAGNode<OriginID> *calleeNode : calleeNodes) {
+            if (isCall) {
+                connected |= cloneInterEdge(edge, callerNode, calleeNode);
+            } else {
+                connected |= cloneInterEdge(edge, calleeNode, callerNode);
+            }
         }
     }
+    return connected;
 }
 
 std::string OriginPAG::getGraphName() {
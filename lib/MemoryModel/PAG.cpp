@@ -670,6 +670,20 @@ void PAG::handleBlackHole(bool b) {
 }
 
 namespace llvm {
+/*!
+ * Function and kind of PAG nodes for filtering graph exports
+ */
+    template<>
+    struct GraphExportTraits<PAG*> {
+        static const Function* getFunction(PAGNode *node) {
+            return node->hasValue() ? GraphPrinter::getFunctionOf(node->getValue()) : NULL;
+        }
+        static std::string getNodeKind(PAGNode *node) {
+            static const char* kinds[] = {"Val", "Obj", "Ret", "Vararg", "GepVal", "GepObj", "FIObj", "DummyVal", "DummyObj"};
+            return kinds[node->getNodeKind()];
+        }
+    };
+
 /*!
  * Write value flow graph into dot file for debugging
  */
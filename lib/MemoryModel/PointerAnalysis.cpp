@@ -305,13 +305,13 @@ BVDataPTAImpl::BVDataPTAImpl(PointerAnalysis::PTATY type) :
         ptD = new PTDataTy();
 	} else if (type == AndersenWaveDiff_WPA || type == AndersenWaveDiffWithType_WPA) {
 		ptD = new DiffPTDataTy();
-	} else if (type == FSSPARSE_WPA) {
+	} else if (type == FSSPARSE_WPA || type == VFS_WPA) {
 		if (INCDFPTData)
 			ptD = new IncDFPTDataTy();
 		else
 			ptD = new DFPTDataTy();
 	} else if (type == ORIGIN_PTA) {
-        ptD = new DiffPTDataTy(); // for now, use the same as Andersen's
+        ptD = NULL; // the context-sensitive analyses keep their own (shared) points-to data
 	} else {
 		assert(false && "no points-to data available");
     }
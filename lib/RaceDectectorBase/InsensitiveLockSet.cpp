@@ -3,47 +3,25 @@
 //
 
 #include "RaceDetectorBase/InsensitiveLockSet.h"
+#include "Util/ThreadAPI.h"
 
+#include <functional>
+
+// the synchronization APIs are modelled by ThreadAPI, resolved per function once the module is resolved
 bool InsensitiveLockSet::isThreadCreate(Instruction *inst) {
-    CallInst *called = dyn_cast<CallInst>(inst);
-    if (!called) {
-        return false;
-    } else if (called->getCalledFunction()->getName().equals("pthread_create")) {
-        return true;
-    }
-    return false;
+    return ThreadAPI::getThreadAPI()->isTDFork(inst);
 }
 
 bool InsensitiveLockSet::isThreadJoin(Instruction *inst) {
-    CallInst *called = dyn_cast<CallInst>(inst);
-    if (!called) {
-        return false;
-    } else if (called->getCalledFunction()->getName().equals("pthread_join")) {
-        return true;
-    }
-    return false;
+    return ThreadAPI::getThreadAPI()->isTDJoin(inst);
 }
 
 bool InsensitiveLockSet::isMutexLock(Instruction *inst) {
-    auto *called = dyn_cast<CallInst>(inst);
-    if (!called) {
-        return false;
-    } else if (called->getCalledFunction()->getName().equals("pthread_mutex_lock") ||
-               called->getCalledFunction()->getName().equals("_Z15safe_mutex_lockP15pthread_mutex_t")) {
-        return true;
-    }
-    return false;
+    return ThreadAPI::getThreadAPI()->isTDAcquire(inst);
 }
 
 bool InsensitiveLockSet::isMutexUnLock(Instruction *inst) {
-    auto called = dyn_cast<CallInst>(inst);
-    if (!called) {
-        return false;
-    } else if (called->getCalledFunction()->getName().equals("pthread_mutex_unlock") ||
-               called->getCalledFunction()->getName().equals("_Z15safe_mutex_unlockP15pthread_mutex_t")) {
-        return true;
-    }
-    return false;
+    return ThreadAPI::getThreadAPI()->isTDRelease(inst);
 }
 
 bool InsensitiveLockSet::isRead(Instruction *inst) {
@@ -58,157 +36,361 @@ bool InsensitiveLockSet::isReadORWrite(Instruction * inst) {
     return isRead(inst) || isWrite(inst);
 }
 
+// modelled APIs are not analyzed even if they are defined in the module (e.g. lock wrappers)
 bool InsensitiveLockSet::isExtFunction(Function *func) {
-    return func->isDeclaration() ||
+    return func == nullptr ||
+           func->isDeclaration() ||
            func->isIntrinsic() ||
-           func->getName().equals("pthread_create") ||
-           func->getName().equals("pthread_mutex_lock") ||
-           func->getName().equals("_Z15safe_mutex_lockP15pthread_mutex_t") ||
-           func->getName().equals("pthread_mutex_unlock") ||
-           func->getName().equals("_Z15safe_mutex_unlockP15pthread_mutex_t");
+           ThreadAPI::getThreadAPI()->isTDAPI(func);
 }
 
 bool InsensitiveLockSet::protectedByCommonLock(const Instruction *i1, const Instruction *i2) {
     if (i1 == i2) return true;
 
-    auto it1 = outLockSetMap->find(i1);
-    auto it2 = outLockSetMap->find(i2);
+    auto it1 = stmtLockSetMap.find(i1);
+    auto it2 = stmtLockSetMap.find(i2);
 
     // not protected by any lock
-    if (it1 == outLockSetMap->end() || it2 == outLockSetMap->end()) {
+    if (it1 == stmtLockSetMap.end() || it2 == stmtLockSetMap.end()) {
         return false;
     }
 
-    LockSet *set1 = it1->second;
-    LockSet *set2 = it2->second;
+    return it1->second.intersects(it2->second);
+}
+
+const NodeBS &InsensitiveLockSet::getLockSet(const Instruction *inst) const {
+    static const NodeBS emptyLockSet;
+    auto iter = stmtLockSetMap.find(inst);
+    return iter == stmtLockSetMap.end() ? emptyLockSet : iter->second;
+}
+
+/*
+ * Intern the lock pointers: lock objects which may be pointed to by the same lock pointer are merged
+ * into one alias class (union-find over the points-to sets), and every lock pointer gets the ID of its class.
+ */
+void InsensitiveLockSet::internLocks(Module *module) {
+    vector<const Value *> locks;
+    for (auto &func : *module) {
+        if (isExtFunction(&func)) {
+            continue;
+        }
+        for (auto &bb : func) {
+            for (auto &inst : bb) {
+                if (isMutexLock(&inst) || isMutexUnLock(&inst)) {
+                    locks.push_back(ThreadAPI::getThreadAPI()->getLockVal(&inst));
+                }
+            }
+        }
+    }
+
+    map<NodeID, NodeID> parent;
+    std::function<NodeID(NodeID)> find = [&](NodeID obj) -> NodeID {
+        auto iter = parent.find(obj);
+        if (iter == parent.end() || iter->second == obj) {
+            return obj;
+        }
+        return iter->second = find(iter->second);
+    };
+
+    PAG *pag = PTA->getPAG();
+    for (const Value *lock : locks) {
+        if (!pag->hasValueNode(lock)) {
+            continue;
+        }
+        const PointsTo &pts = PTA->getPts(pag->getValueNode(lock));
+        if (pts.empty()) {
+            continue;
+        }
+        NodeID root = find(pts.find_first());
+        for (NodeID obj : pts) {
+            NodeID objRoot = find(obj);
+            if (objRoot != root) {
+                parent[objRoot] = root;
+            }
+        }
+    }
+
+    map<NodeID, LockID> root2IDMap;
+    LockID nextID = 0;
+    for (const Value *lock : locks) {
+        if (lock2IDMap.count(lock)) {
+            continue;
+        }
+        // a lock without points-to information is only an alias of itself
+        LockID id = nextID;
+        if (pag->hasValueNode(lock) && !PTA->getPts(pag->getValueNode(lock)).empty()) {
+            NodeID root = find(PTA->getPts(pag->getValueNode(lock)).find_first());
+            auto iter = root2IDMap.find(root);
+            if (iter != root2IDMap.end()) {
+                id = iter->second;
+            } else {
+                root2IDMap[root] = id;
+            }
+        }
+        if (id == nextID) {
+            nextID++;
+            id2LockMap.push_back(lock);
+        }
+        lock2IDMap[lock] = id;
+    }
+}
+
+InsensitiveLockSet::LockID InsensitiveLockSet::getLockID(const Value *lock) {
+    auto iter = lock2IDMap.find(lock);
+    assert(iter != lock2IDMap.end() && "lock is not interned");
+    return iter->second;
+}
 
-    for (Value *lock1 : *set1) {
-        for (Value *lock2 : *set2) {
-            if (this->PTA->alias(lock1, lock2)==MayAlias) {
-                return true;
+// direct callee, or the callees resolved by the pointer analysis, external functions are skipped
+void InsensitiveLockSet::getCallees(Instruction *inst, FuncSet &callees) {
+    CallSite cs(inst);
+    if (Function *callee = cs.getCalledFunction()) {
+        if (!isExtFunction(callee)) {
+            callees.insert(callee);
+        }
+    } else if (PTA->getPTACallGraph()->hasCallGraphEdge(inst)) {
+        PTACallGraph *callGraph = PTA->getPTACallGraph();
+        for (auto it = callGraph->getCallEdgeBegin(inst); it != callGraph->getCallEdgeEnd(inst); it++) {
+            auto callee = const_cast<Function *>((*it)->getDstNode()->getFunction());
+            if (!isExtFunction(callee)) {
+                callees.insert(callee);
             }
         }
     }
-    return false;
 }
 
-void InsensitiveLockSet::analyze(llvm::Module *module) {
-    inLockSetMap = new StmtLockSetMap();
-    outLockSetMap = new StmtLockSetMap();
-    func2CallSitesMap = new Func2CallSites();
-    func2ReturnMap = new Func2CallSites();
+void InsensitiveLockSet::transfer(Instruction *inst, LockBS &ls) {
+    if (isMutexLock(inst)) {
+        ls.set(getLockID(ThreadAPI::getThreadAPI()->getLockVal(inst)));
+    } else if (isMutexUnLock(inst)) {
+        ls.reset(getLockID(ThreadAPI::getThreadAPI()->getLockVal(inst)));
+    } else if (isa<CallInst>(inst) || isa<InvokeInst>(inst)) {
+        FuncSet callees;
+        getCallees(inst, callees);
+        if (callees.empty()) {
+            return;
+        }
+
+        // any of the callees may be called: release what one may release, hold what all hold
+        LockBS release, hold;
+        bool first = true;
+        for (Function *callee : callees) {
+            auto iter = summaryMap.find(callee);
+            if (iter == summaryMap.end()) {
+                // recursive call whose summary is not computed yet, assume it may release every lock
+                ls.clear();
+                return;
+            }
+            release |= iter->second.mayRelease;
+            if (first) {
+                hold = iter->second.mustHold;
+                first = false;
+            } else {
+                hold &= iter->second.mustHold;
+            }
+        }
+        ls.intersectWithComplement(release);
+        ls |= hold;
+    }
+}
+
+/*
+ * Must-lockset over the basic blocks of func: the lockset at a block entry is the intersection of
+ * the locksets at the end of its (already visited) predecessors.
+ */
+void InsensitiveLockSet::solveFunction(Function *func, const LockBS &entry, BBLockSetMap &inMap) {
+    inMap.clear();
 
-    auto *worklist = new vector<Instruction *>();
+    BasicBlock *entryBB = &func->getEntryBlock();
+    inMap[entryBB] = entry;
+    vector<BasicBlock *> worklist;
+    worklist.push_back(entryBB);
+
+    while (!worklist.empty()) {
+        BasicBlock *bb = worklist.back();
+        worklist.pop_back();
+
+        LockBS ls = inMap[bb];
+        for (auto &inst : *bb) {
+            transfer(&inst, ls);
+        }
 
+        for (BasicBlock *succ : successors(bb)) {
+            auto iter = inMap.find(succ);
+            if (iter == inMap.end()) {
+                inMap[succ] = ls;
+                worklist.push_back(succ);
+            } else if (iter->second &= ls) {
+                worklist.push_back(succ);
+            }
+        }
+    }
+}
+
+/*
+ * Bottom-up lock effect summaries.
+ * mayRelease is a fixpoint over the call graph; mustHold is computed once per function in post order,
+ * with an empty lockset at its entry, a recursive call inside an SCC releases every lock (see transfer).
+ */
+void InsensitiveLockSet::buildSummaries(Module *module) {
+    map<const Function *, LockBS> mayRelease;
+    map<const Function *, FuncSet> calleesMap;
     for (auto &func : *module) {
         if (isExtFunction(&func)) {
             continue;
         }
-
+        LockBS &release = mayRelease[&func];
+        FuncSet &callees = calleesMap[&func];
         for (auto &bb : func) {
             for (auto &inst : bb) {
-                worklist->push_back(&inst);
-                inLockSetMap->insert(make_pair(&inst, new LockSet()));
-                outLockSetMap->insert(make_pair(&inst, new LockSet()));
-
-                // TODO: handle invoke
-                if (isa<CallInst>(inst)) {
-                    auto callinst = dyn_cast<CallInst>(&inst);
-                    (*func2CallSitesMap)[callinst->getCalledFunction()].insert(callinst);
-                } else if (isa<ReturnInst>(inst)) {
-                    (*func2ReturnMap)[inst.getFunction()].insert(&inst);
+                if (isMutexUnLock(&inst)) {
+                    release.set(getLockID(ThreadAPI::getThreadAPI()->getLockVal(&inst)));
+                } else if (!isMutexLock(&inst) && (isa<CallInst>(inst) || isa<InvokeInst>(inst))) {
+                    FuncSet instCallees;
+                    getCallees(&inst, instCallees);
+                    for (Function *callee : instCallees) {
+                        callees.insert(callee);
+                        func2CallSitesMap[callee].insert(&inst);
+                    }
                 }
             }
         }
     }
 
-    while (!worklist->empty()) {
-        Instruction *inst = worklist->back();
-        worklist->pop_back();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto &funcCallees : calleesMap) {
+            LockBS &release = mayRelease[funcCallees.first];
+            for (Function *callee : funcCallees.second) {
+                changed |= (release |= mayRelease[callee]);
+            }
+        }
+    }
 
-        BasicBlock *instBB = inst->getParent();
-        Function *instFunc = instBB->getParent();
+    set<const Function *> visited;
+    BBLockSetMap inMap;
+    std::function<void(Function *)> summarize = [&](Function *func) {
+        if (!visited.insert(func).second) {
+            return;
+        }
+        for (Function *callee : calleesMap[func]) {
+            summarize(callee);
+        }
 
-        LockSet inLS;
-        LockSet outLS;
+        solveFunction(func, LockBS(), inMap);
 
-        // first instruction in BB;
-        if (&instBB->front() == inst) {
-            if (instBB == &instFunc->getEntryBlock()) {
-                // func entry block's first instruction, predecessor are callsites;
-                for (auto callsite : (*func2CallSitesMap)[instFunc]) {
-                    for (Value *v : *outLockSetMap->find(callsite)->second){
-                        inLS.insert(v);
-                    }
-                }
+        LockSummary summary;
+        summary.mayRelease = mayRelease[func];
+        bool first = true;
+        for (auto &bbLS : inMap) {
+            if (!isa<ReturnInst>(bbLS.first->getTerminator())) {
+                continue;
+            }
+            LockBS ls = bbLS.second;
+            for (auto &inst : *const_cast<BasicBlock *>(bbLS.first)) {
+                transfer(&inst, ls);
+            }
+            if (first) {
+                summary.mustHold = ls;
+                first = false;
             } else {
-                for (BasicBlock *pred : predecessors(inst->getParent())) {
-                    for (Value *v : *outLockSetMap->find(pred->getTerminator())->second){
-                        inLS.insert(v);
-                    }
-                }
+                summary.mustHold &= ls;
             }
-        } else if (isa<CallInst>(inst->getPrevNode())) {
-            auto callInst = dyn_cast<CallInst>(inst->getPrevNode());
-            // previous call edges
-            if (callInst->getCalledFunction()) {
-                if (isExtFunction(callInst->getCalledFunction())) {
-                    for (Value *v : *outLockSetMap->find(inst->getPrevNode())->second){
-                        inLS.insert(v);
-                    }
-                } else {
-                    for (auto retInst : (*func2ReturnMap)[callInst->getCalledFunction()]) {
-                        for (Value *v : *outLockSetMap->find(retInst)->second){
-                            inLS.insert(v);
-                        }
+        }
+        summaryMap[func] = summary;
+    };
+
+    for (auto &func : *module) {
+        if (!isExtFunction(&func)) {
+            summarize(&func);
+        }
+    }
+}
+
+/*
+ * Top-down: meet the lockset of every call site into the entry of its callees, until the entries are stable.
+ * Entries only shrink, so every function is re-solved a bounded number of times.
+ */
+void InsensitiveLockSet::computeEntryLockSets(Module *module) {
+    vector<Function *> worklist;
+    set<const Function *> threadRoutines;
+    for (auto &func : *module) {
+        if (isExtFunction(&func)) {
+            continue;
+        }
+        for (auto &bb : func) {
+            for (auto &inst : bb) {
+                if (isThreadCreate(&inst)) {
+                    if (auto routine = dyn_cast<Function>(ThreadAPI::getThreadAPI()->getForkedFun(&inst))) {
+                        threadRoutines.insert(routine);
                     }
                 }
-            } else {
-                continue;
-            }
-        } else {
-            // normal cases
-            for (Value *v : *outLockSetMap->find(inst->getPrevNode())->second){
-                inLS.insert(v);
             }
         }
+    }
 
-        // we get inLS now, calculate the outLS
-        outLS = inLS;
-        if (isMutexLock(inst)) {
-            auto callInst = dyn_cast<CallInst>(inst);
-            outLS.insert(callInst->getArgOperand(0));
-        } else if (isMutexUnLock(inst)) {
-            auto callInst = dyn_cast<CallInst>(inst);
-            outLS.erase(callInst->getArgOperand(0));
+    // program and thread entries, and functions without (resolved) callers hold no lock
+    for (auto &func : *module) {
+        if (isExtFunction(&func)) {
+            continue;
+        }
+        if (func.getName().equals("main") || threadRoutines.count(&func) || !func2CallSitesMap.count(&func)) {
+            entryLockSetMap[&func] = LockBS();
+            worklist.push_back(&func);
         }
+    }
 
-        // if outLS != inLS, add successors into worklist
-        if (*(*outLockSetMap)[inst]!=outLS) {
-            *(*outLockSetMap)[inst] = outLS;
+    BBLockSetMap inMap;
+    auto drain = [&]() {
+        while (!worklist.empty()) {
+            Function *func = worklist.back();
+            worklist.pop_back();
 
-            if (isa<ReturnInst>(inst)) {
-                for (auto callSite : (*func2CallSitesMap)[inst->getFunction()]) {
-                    worklist->push_back(callSite->getNextNode());
-                }
-            } else if (isa<TerminatorInst>(inst)) {
-                auto termInst = dyn_cast<TerminatorInst>(inst);
-                for (auto bb : termInst->successors())  {
-                    worklist->push_back(&bb->front());
-                }
-            } else if (isa<CallInst>(inst)) {
-                auto callInst = dyn_cast<CallInst>(inst);
-                if (callInst->getFunction() == nullptr) {
-                    // indirect call?
-                    worklist->push_back(inst->getNextNode());
-                } else if (isExtFunction(callInst->getCalledFunction())) {
-                    worklist->push_back(inst->getNextNode());
-                } else {
-                    worklist->push_back(&callInst->getCalledFunction()->getEntryBlock().front());
+            solveFunction(func, entryLockSetMap[func], inMap);
+
+            for (auto &bbLS : inMap) {
+                LockBS ls = bbLS.second;
+                for (auto &inst : *const_cast<BasicBlock *>(bbLS.first)) {
+                    if (isReadORWrite(&inst)) {
+                        if (ls.empty()) {
+                            stmtLockSetMap.erase(&inst);
+                        } else {
+                            stmtLockSetMap[&inst] = ls;
+                        }
+                    } else if (!isMutexLock(&inst) && !isMutexUnLock(&inst)
+                               && (isa<CallInst>(inst) || isa<InvokeInst>(inst))) {
+                        FuncSet callees;
+                        getCallees(&inst, callees);
+                        for (Function *callee : callees) {
+                            auto iter = entryLockSetMap.find(callee);
+                            if (iter == entryLockSetMap.end()) {
+                                entryLockSetMap[callee] = ls;
+                                worklist.push_back(callee);
+                            } else if (!threadRoutines.count(callee) && (iter->second &= ls)) {
+                                worklist.push_back(callee);
+                            }
+                        }
+                    }
+                    transfer(&inst, ls);
                 }
-            } else {
-                worklist->push_back(inst->getNextNode());
             }
         }
+    };
+
+    drain();
+    // functions only reachable from unresolved cycles
+    for (auto &func : *module) {
+        if (!isExtFunction(&func) && !entryLockSetMap.count(&func)) {
+            entryLockSetMap[&func] = LockBS();
+            worklist.push_back(&func);
+            drain();
+        }
     }
-}
\ No newline at end of file
+}
+
+void InsensitiveLockSet::analyze(llvm::Module *module) {
+    internLocks(module);
+    buildSummaries(module);
+    computeEntryLockSets(module);
+}
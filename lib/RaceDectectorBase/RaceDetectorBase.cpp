@@ -11,41 +11,51 @@
 #include "RaceDetectorBase/SHBGraph.h"
 #include "Util/GraphUtil.h"
 #include "WPA/Andersen.h"
+#include "WPA/CtxSensitive.h"
+#include "Util/ThreadAPI.h"
 
 //#include "MTA/TCT.h"
 //#include "MTA/LockAnalysis.h"
 
 // using nullptr for MAIN_THREAD
 #define MAIN_THREAD nullptr
+#define TSA_STATE_FILE "../../TSAState.txt"
 
-vector<string> unsharedVarLocs;
-vector<string> sharedVarLocs;
-vector<string> unsharedStrings;
-vector<string> sharedStrings;
-bool debug;
-
-vector<string> RaceDetectorBase::split(string s, string splitStr){
-    size_t pos = 0;
-    size_t subtracted =0;
-    vector<string> temp;
-    string scopy = s;
-    while ((pos = scopy.find(splitStr)) != std::string::npos) {
-        pos+=splitStr.length();
-        temp.push_back(scopy.substr(0, pos));
-        subtracted+=pos;
-        scopy.erase(0, pos + splitStr.length());
-    }
-    temp.push_back(s.substr(subtracted)); //Gets the remaining str
-    return temp;
-}
+#define UNSHARED_OUTPUT_FILE "../../UnsharedOutput.txt"
+#define SHARED_OUTPUT_FILE "../../PotentiallySharedOutput.txt"
+#define CANDIDATES_FILE "../../RaceCandidates"
 
-int RaceDetectorBase::runOnModule(SVFModule svfModule,bool sharedOutput,bool outputFiles, bool outputMethods,bool outputVariables,bool debug) {
+int RaceDetectorBase::runOnModule(SVFModule svfModule,bool sharedOutput,bool outputFiles, bool outputMethods,bool outputVariables,bool debug,bool incremental,TSAReport::Format candidates,PTAKind ptaKind,bool dumpGraphs) {
     this->debug = debug;
-    this->inputExistingLogs();
+    this->incremental = incremental;
+    if (incremental) {
+        cout << "Reading in previous TSA state\n";
+        if (!prevState.load(TSA_STATE_FILE)) {cout << "No previous TSA state found, analyzing the whole program\n";}
+    }
+    // with a previous state every verdict is regenerated, merging the old logs would only keep stale entries
+    vector<string> loggedUnshared, loggedShared;
+    if (!prevState.isLoaded()) {this->inputExistingLogs(loggedUnshared, loggedShared);}
+
+    // the new logs are written next to the old ones, which are only replaced once the analysis finished
+    string candidatesFile = string(CANDIDATES_FILE) + (candidates == TSAReport::CSV ? ".csv" : ".json");
+    if (!report.open(sharedOutput ? SHARED_OUTPUT_FILE : UNSHARED_OUTPUT_FILE, sharedOutput, candidates, candidatesFile)) {
+        cout<<"Could Not Log Output";return 2;
+    }
+    for (const string &entry : loggedUnshared) {report.addLoggedEntry(entry, false);}
+    for (const string &entry : loggedShared) {report.addLoggedEntry(entry, true);}
 
-    cout<<"Running pointer analysis\n";this->PTA = AndersenWaveDiff::createAndersenWaveDiff(module); //HOTCODE
-    this->PTA->getPAG()->dump("PAG");
     this->module = svfModule.getModule(0);
+    // resolve the synchronization APIs once, instead of comparing names at every instruction
+    ThreadAPI::getThreadAPI()->resolveModule(*this->module);
+    cout<<"Running pointer analysis\n";
+    switch (ptaKind) {
+        // context-sensitive results are projected onto the PAG, getPts/alias of PAG nodes work as with Andersen
+        case OriginPTA: this->PTA = this->originPTA = new OriginSensitive(); this->PTA->analyze(svfModule); break;
+        case CallSitePTA: this->PTA = new CallSiteSensitive(); this->PTA->analyze(svfModule); break;
+        default: this->PTA = AndersenWaveDiff::createAndersenWaveDiff(svfModule); break; //HOTCODE
+    }
+    // format and filters as given by -graph-format/-graph-func/-graph-kind
+    if (dumpGraphs) {this->PTA->getPAG()->dump("PAG");}
 
     // Basic LockSet algorithm
     this->LS = new InsensitiveLockSet(this->PTA);
@@ -53,23 +63,150 @@ int RaceDetectorBase::runOnModule(SVFModule svfModule,bool sharedOutput,bool out
 
     // Construct SHBGRAPH
     this->shbGraph = SHBGraph::buildFromModule(this->module, PTA);
-    this->shbGraph->dumpDotGraph();
+    if (dumpGraphs) {this->shbGraph->dumpDotGraph();}
 
     this->collectAccess();
+    this->computeDirtyFunctions();
     this->detectShared(); //HOTCODE
 
-    return this->output(sharedOutput,outputFiles,outputMethods,outputVariables);
+    int ret = this->output(outputFiles,outputMethods,outputVariables);
+    // the state matches the logs of this run, keep the old one if they could not be written
+    if (ret == 0 && incremental && !curState.save(TSA_STATE_FILE)) {cout<<"Could Not Save TSA State\n";}
+    return ret;
 
 }
 
-void RaceDetectorBase::inputExistingLogs(){
+void RaceDetectorBase::inputExistingLogs(vector<string> &loggedUnshared, vector<string> &loggedShared){
     cout << "Reading in pre-existing logged TSA data\n";
     string line;
     ifstream myFile;
-    myFile.open("../../UnsharedOutput.txt"); //Adds pre-existing unshared logged data
-    if (myFile.is_open()) {while (getline(myFile, line)) {unsharedStrings.push_back(line);} myFile.close();}
-    myFile.open("../../PotentiallySharedOutput.txt");//Adds pre-existing shared logged data
-    if (myFile.is_open()) {while (getline(myFile, line)) {sharedStrings.push_back(line);} myFile.close();}
+    myFile.open(UNSHARED_OUTPUT_FILE); //Adds pre-existing unshared logged data
+    if (myFile.is_open()) {while (getline(myFile, line)) {loggedUnshared.push_back(line);} myFile.close();}
+    myFile.open(SHARED_OUTPUT_FILE);//Adds pre-existing shared logged data
+    if (myFile.is_open()) {while (getline(myFile, line)) {loggedShared.push_back(line);} myFile.close();}
+}
+
+/*
+ * Decide which functions have to be re-analyzed, and record the summary of every function for the next run.
+ * A function is dirty if it is new, its body changed, or the set of threads reaching it changed.
+ * If a dirty function can (or could) reach a fork/join site the happens-before relation of unchanged
+ * functions may change as well, so everything is re-analyzed.
+ */
+void RaceDetectorBase::computeDirtyFunctions() {
+    // functions which create or join threads, directly or through their callees
+    FuncSet forkingFuncs;
+    map<const Function *, FuncSet> callers;
+    vector<const Function *> worklist;
+    for (Function &func : *module) {
+        if (InsensitiveLockSet::isExtFunction(&func)) {continue;}
+        for (BasicBlock &bb : func) {
+            for (Instruction &inst : bb) {
+                if (InsensitiveLockSet::isThreadCreate(&inst) || InsensitiveLockSet::isThreadJoin(&inst)) {
+                    if (forkingFuncs.insert(&func).second) {worklist.push_back(&func);}
+                } else if (auto *call = dyn_cast<CallInst>(&inst)) {
+                    if (const Function *callee = call->getCalledFunction()) {callers[callee].insert(&func);}
+                }
+            }
+        }
+    }
+    while (!worklist.empty()) {
+        const Function *func = worklist.back();
+        worklist.pop_back();
+        for (const Function *caller : callers[func]) {
+            if (forkingFuncs.insert(caller).second) {worklist.push_back(caller);}
+        }
+    }
+
+    bool reanalyzeAll = !prevState.isLoaded();
+    for (Function &func : *module) {
+        if (InsensitiveLockSet::isExtFunction(&func)) {continue;}
+        TSAState::FunctionSummary &summary = curState.getOrAddSummary(func.getName().str());
+        summary.hash = TSAState::hashFunction(&func);
+        summary.reachesFork = forkingFuncs.count(&func) != 0;
+        auto threadIt = funcThreads.find(&func);
+        if (threadIt != funcThreads.end()) {summary.threads = threadIt->second;}
+
+        const TSAState::FunctionSummary *prev = prevState.getSummary(func.getName().str());
+        if (!prev || prev->hash != summary.hash || prev->threads != summary.threads) {
+            dirtyFuncs.insert(&func);
+            if (summary.reachesFork || (prev && prev->reachesFork)) {reanalyzeAll = true;}
+        }
+    }
+    if (reanalyzeAll) {
+        for (Function &func : *module) {
+            if (!InsensitiveLockSet::isExtFunction(&func)) {dirtyFuncs.insert(&func);}
+        }
+    }
+
+    // summarize the accesses: source location and points-to digest, the verdict is filled in by detectShared
+    map<pair<const Function *, string>, set<string>> locDigests;
+    for (auto &threadAccess : threadAccessSetMap) {
+        for (SHBNode *node : threadAccess.second) {
+            if (accessLocs.count(node)) {continue;}
+            string loc = analysisUtil::getSourceLoc(node->getPointerOperand());
+            accessLocs[node] = loc;
+            if (loc != "") {locDigests[make_pair(node->getInst()->getFunction(), loc)].insert(getPtsDigest(node));}
+        }
+    }
+    for (auto &locDigest : locDigests) {
+        string combined;
+        for (const string &digest : locDigest.second) {combined += digest;}
+        TSAState::AccessRecord &record = curState.getOrAddSummary(locDigest.first.first->getName().str()).accesses[locDigest.first.second];
+        record.verdict = TSAState::Unshared;
+        record.ptsDigest = TSAState::digest(combined);
+    }
+
+    if (prevState.isLoaded()) {
+        cout << "Re-analyzing " << dirtyFuncs.size() << " of " << curState.getSummaries().size() << " functions\n";
+    }
+}
+
+/*
+ * Digest of the objects an access may point to, identified by name and source location
+ * so that it is stable across builds.
+ */
+string RaceDetectorBase::getPtsDigest(SHBNode *node) {
+    PAG *pag = PTA->getPAG();
+    const Value *ptr = node->getPointerOperand();
+    set<string> objs;
+    if (pag->hasValueNode(ptr)) {
+        for (NodeID obj : PTA->getPts(pag->getValueNode(ptr))) {
+            const MemObj *mem = pag->getObject(obj);
+            if (mem && mem->getRefVal()) {
+                objs.insert(mem->getRefVal()->getName().str() + "@" + analysisUtil::getSourceLoc(mem->getRefVal()));
+            } else {
+                objs.insert("<dummy>");
+            }
+        }
+    }
+    string str;
+    for (const string &obj : objs) {str += obj + ";";}
+    return TSAState::digest(str);
+}
+
+const TSAState::AccessRecord *RaceDetectorBase::getPrevRecord(SHBNode *node, const string &loc) {
+    const TSAState::FunctionSummary *prev = prevState.getSummary(node->getInst()->getFunction()->getName().str());
+    if (!prev) {return nullptr;}
+    auto iter = prev->accesses.find(loc);
+    if (iter == prev->accesses.end()) {return nullptr;}
+    return &iter->second;
+}
+
+// an access is clean if neither its function nor the objects it may point to changed
+bool RaceDetectorBase::isDirtyAccess(SHBNode *node) {
+    const Function *func = node->getInst()->getFunction();
+    if (dirtyFuncs.count(func)) {return true;}
+
+    const string &loc = accessLocs[node];
+    const TSAState::AccessRecord *prev = getPrevRecord(node, loc);
+    const TSAState::FunctionSummary *cur = curState.getSummary(func->getName().str());
+    auto curIt = cur->accesses.find(loc);
+    return !prev || curIt == cur->accesses.end() || prev->ptsDigest != curIt->second.ptsDigest;
+}
+
+void RaceDetectorBase::recordVerdict(SHBNode *node, const string &loc, bool shared) {
+    TSAState::AccessRecord &record = curState.getOrAddSummary(node->getInst()->getFunction()->getName().str()).accesses[loc];
+    if (shared) {record.verdict = TSAState::Shared;}
 }
 
 // HOTCODE
@@ -78,295 +215,219 @@ void RaceDetectorBase::detectShared() {
     const SHBGraph::ThreadSet &set = shbGraph->getThreadSet();
     SHBGraph::ThreadSet setContainsMain(set);
     setContainsMain.insert(MAIN_THREAD);
+
+    // accesses which have to be re-analyzed, per thread
+    map<Value *, vector<SHBNode *>> dirtyAccessMap;
+    for (Value *thread : setContainsMain) {
+        for (SHBNode *access : threadAccessSetMap[thread]) {
+            if (isDirtyAccess(access)) {dirtyAccessMap[thread].push_back(access);}
+        }
+    }
+
     //for every thread
     //  for every variable in that thread
     //      for every other thread
     //          for every variable in that other thread
     //--------------------------------------------------
     //for every variable in every thread, check sharing to every variable in every other thread
+    //a clean variable only needs to be checked against the dirty variables of the other threads,
+    //and a clean variable that was shared stays shared (conservative for the ignore list)
     for (auto outer = setContainsMain.begin(); outer != setContainsMain.end(); outer ++) {
         Value *t1 = *outer;
         for (SHBNode *a1 : threadAccessSetMap[t1]) {
-            bool shared = false;
-            string loc = analysisUtil::getSourceLoc(a1->getPointerOperand());
-            if (loc!= "") {
-                for (auto inner = setContainsMain.begin(); inner != setContainsMain.end(); inner++) {
-                    if (inner != outer) { // no thread share check for the same thread
-                        Value *t2 = *inner;
-
-                        for (SHBNode *a2 : threadAccessSetMap[t2]) {
-                            if (this->checkNodes(a1, a2)) {
-                                sharedVarLocs.push_back(loc);
-                                shared = true;
-                            }
-                        }
+            const string &loc = accessLocs[a1];
+            if (loc == "") {continue;}
+
+            bool dirty = isDirtyAccess(a1);
+            bool shared = !dirty && getPrevRecord(a1, loc)->verdict == TSAState::Shared;
+            for (auto inner = setContainsMain.begin(); inner != setContainsMain.end() && !shared; inner++) {
+                if (inner == outer) {continue;} // no thread share check for the same thread
+                Value *t2 = *inner;
+
+                if (dirty) {
+                    for (SHBNode *a2 : threadAccessSetMap[t2]) {
+                        if (this->checkNodes(a1, t1, a2, t2)) {shared = true; reportCandidate(a1, t1, a2, t2); break;}
+                    }
+                } else {
+                    for (SHBNode *a2 : dirtyAccessMap[t2]) {
+                        if (this->checkNodes(a1, t1, a2, t2)) {shared = true; reportCandidate(a1, t1, a2, t2); break;}
                     }
                 }
-                if (!shared) {unsharedVarLocs.push_back(loc);}
             }
+
+            recordSharing(a1, loc, shared);
+            recordVerdict(a1, loc, shared);
         }
     }
+    if (report.writesCandidates()) {
+        cout << "Wrote " << report.getNumOfCandidates() << " race candidate";
+        if(report.getNumOfCandidates()!=1){cout <<"s";}
+        cout << "\n";
+    }
 }
 
-bool RaceDetectorBase::checkNodes(SHBNode *n1, SHBNode *n2) {
+// with origins, each access is queried in the origin of its thread, objects of different origins do not alias
+bool RaceDetectorBase::checkNodes(SHBNode *n1, Value *t1, SHBNode *n2, Value *t2) {
     if (!shbGraph->reachable(n1, n2)) {
+        if (originPTA) {
+            return originPTA->alias(n1->getPointerOperand(), getThreadOrigin(t1), n2->getPointerOperand(), getThreadOrigin(t2))==MayAlias;
+        }
         if (PTA->alias(n1->getPointerOperand(), n2->getPointerOperand())==MayAlias) {
             return true;
         }
     }
+    return false;
+}
+
+OriginID RaceDetectorBase::getThreadOrigin(Value *thread) {
+    return originPTA->getOriginOfEntry(thread == MAIN_THREAD ? nullptr : shbGraph->getThreadStart(thread));
 }
 
 void RaceDetectorBase::collectAccess() {
     cout << "\nCollecting Memory Access Operations\n";
     for (auto thread : shbGraph->getThreadSet()) {
-        SHBNode *entryNode = shbGraph->getFunctionEnterNode(shbGraph->getThreadStart(thread));
-        // DFS from entry node to collect all the read and write operations
-        intraThreadDFS(entryNode, thread);
+        // the accesses of a thread are the access summary of its start routine
+        collectThreadAccess(shbGraph->getThreadStart(thread), thread);
     }
 
     //collect main thread
-    SHBNode *mainEntry = shbGraph->getFunctionEnterNode(this->module->getFunction("main"));
-    intraThreadDFS(mainEntry, MAIN_THREAD);
+    collectThreadAccess(this->module->getFunction("main"), MAIN_THREAD);
 }
 
-void RaceDetectorBase::intraThreadDFS(SHBNode *entry, Value *thread) {
-    std::stack<SHBNode *> nodeStack;
-    NodeBS visitedNode;
+string RaceDetectorBase::getThreadName(Value *thread) {
+    return thread == MAIN_THREAD ? "main" : shbGraph->getThreadStart(thread)->getName().str();
+}
 
-    nodeStack.push(entry);
-    visitedNode.set(entry->getId());
+// functions shared by several threads are summarized once in the SHB graph, not re-walked per thread
+void RaceDetectorBase::collectThreadAccess(const Function *startRoutine, Value *thread) {
+    string threadName = getThreadName(thread);
 
-    while (!nodeStack.empty()) {
-        SHBNode *node = nodeStack.top();
-        nodeStack.pop();
-        // collect read and write operation
-        if (node->getType() == SHBNode::Read || node->getType() == SHBNode::Write) {
-            this->threadAccessSetMap[thread].insert(node);
-        }
-        for (auto it = node->directOutEdgeBegin(); it != node->directOutEdgeEnd(); it ++) {
-            SHBEdge *edge = (*it);
-            // only collect read and write within the same thread
-            if (!edge->isInterThreadEdge()) {
-                if (edge->getType() != SHBEdge::Ret) {
-                    SHBNode *dst = edge->getDstNode();
-                    if (visitedNode.test_and_set(dst->getId())) {
-                        nodeStack.push(dst);
-                    }
-                }
-            }
-        }
+    for (NodeID id : shbGraph->getFunctionAccesses(startRoutine)) {
+        SHBNode *node = shbGraph->getGNode(id);
+        this->threadAccessSetMap[thread].insert(node);
+        this->funcThreads[node->getFunction()].insert(threadName);
     }
 }
 
-void RaceDetectorBase::checkFiles(bool shared)
-{
-    vector<string> srcloc;
-    string file;
-    if(!shared)
-    {
-        cout << "Unshared File Check: ";
-        int un =0;
-        for(int index = 0;index<unsharedVarLocs.size();index++){
-            if(debug) {cout << "\nStep # [" << index+1 << "/" << unsharedVarLocs.size() << "]";}
-            string unsnode = unsharedVarLocs[index];
-            srcloc = split(unsnode, "fl: ");
-            if(srcloc.size()>1){file = srcloc[1];} else{continue;}
-            if(true) {
-                //If already identified as unshared
-                for (string unshare : unsharedStrings) {if (unshare == "src:" + file) {goto cancel;}}
-                //If already identified as shared
-                for (string share : sharedStrings) {if (share == "src:" + file) {goto cancel;}}
-                //If the file contains shared elements
-                vector<string> srcloc2;
-                string file2;
-                for (string snode : sharedVarLocs) {
-                    srcloc2 = split(snode, "fl: ");
-                    if(srcloc2.size()>1){file2 = srcloc2[1];} else{continue;}
-                    if (file == file2) {
-                        sharedStrings.push_back("src:" + file);
-                        goto cancel;
-                    }
-                }
-                //Add file to blacklist
-                un++;
-                unsharedStrings.push_back("src:" + file);
-
-                //TODO: could remove unshared nodes after use?
-                //unsharedVarLocs.erase(std::remove(unsharedVarLocs.begin(), unsharedVarLocs.end(), unsnode), unsharedVarLocs.end());
-                //Using above may skip a node when the values are shifted back
-            }cancel:;
-        }
-        if(debug){cout<<"\n";}
-        cout << "Found " << un << " new unshared file";
-        if(un!=1){cout <<"s";}
-        cout<<"\n";
+/*
+ * Aggregate the verdict of an access into its file, function and variable, a single shared access makes them shared.
+ * Only the aggregates are kept, not the accesses.
+ */
+void RaceDetectorBase::recordSharing(SHBNode *node, const string &loc, bool shared) {
+    string var = loc.find("Glob ") == 0 ? loc.substr(5) : loc;
+    size_t pos = var.find("fl: ");
+    string file = pos == string::npos ? "" : var.substr(pos + 4);
+
+    if (file != "") {fileSharing[file] |= shared;}
+    funcSharing[node->getFunction()->getName().str()] |= shared;
+    VarSharing &varSharing = varSharingMap[var];
+    varSharing.file = file;
+    varSharing.shared |= shared;
+}
+
+// objects both accesses may point to, identified by name and source location
+vector<string> RaceDetectorBase::getCommonObjects(SHBNode *n1, Value *t1, SHBNode *n2, Value *t2) {
+    vector<string> objects;
+    PAG *pag = PTA->getPAG();
+    const Value *p1 = n1->getPointerOperand(), *p2 = n2->getPointerOperand();
+    if (!pag->hasValueNode(p1) || !pag->hasValueNode(p2)) {return objects;}
+
+    PointsTo common;
+    if (originPTA) {
+        common = originPTA->getPts(pag->getValueNode(p1), getThreadOrigin(t1));
+        common &= originPTA->getPts(pag->getValueNode(p2), getThreadOrigin(t2));
+    } else {
+        common = PTA->getPts(pag->getValueNode(p1));
+        common &= PTA->getPts(pag->getValueNode(p2));
     }
-    else {
-        int sh=0;
-        cout << "Shared File Check: ";
-        for (int index=0;index<sharedVarLocs.size();index++) {
-            if(debug) {cout << "\nStep # [" << index+1 << "/" << sharedVarLocs.size() << "]";}
-            string snode = sharedVarLocs[index];
-            srcloc = split(snode, "fl: ");
-            if (srcloc.size() > 1) { file = srcloc[1]; } else {continue;}
-            if (true) {
-                //If already identified as shared
-                for (string share : sharedStrings) { if (share == "src:" + file) { goto cancel2; }}
-                //Add file to whitelist
-                sh++;
-                sharedStrings.push_back("src:" + file);
-            }
-            cancel2:;
+    for (NodeID obj : common) {
+        const MemObj *mem = pag->getObject(obj);
+        if (mem && mem->getRefVal()) {
+            objects.push_back(mem->getRefVal()->getName().str() + "@" + analysisUtil::getSourceLoc(mem->getRefVal()));
+        } else {
+            objects.push_back("<dummy>");
         }
-        if(debug){cout << "\n";}
-        cout << "Found " << sh << " new shared file";
-        if(sh!=1){cout <<"s";}
-        cout<<"\n";
     }
-} //TODO: Potential Improvements
-void RaceDetectorBase::checkMethods(bool shared){
-    vector<string> srcloc;
-    string file;
-    string method;
-    if(!shared)
-    {
-        cout << "Unshared Method Check: ";
-        int un =0;
-        for(int index=0;index<unsharedVarLocs.size();index++){
-            if(debug) {cout << "\nStep # [" << index+1 << "/" << unsharedVarLocs.size() << "]";}
-            string unsnode = unsharedVarLocs[index];
-            srcloc = split(unsnode, "fl: ");
-            if(srcloc.size()>1){file = srcloc[1];} else{continue;}
-            if(true) {
-                //If already identified as unshared
-                for (string unshare : unsharedStrings) {if (unshare == "src:" + file || unshare == "fun:"+method) {goto cancel;}}
-                //If already identified as shared
-                for (string share : sharedStrings) {if (share == "src:" + file || share == "fun:"+method) {goto cancel;}}
-                //If the method contains shared elements
-                for (string snode : sharedVarLocs) {
-                    string method2 = "";//FIXME: ^^
-                    if (method == method2) {
-                        sharedStrings.push_back("fun:" + method);
-                        goto cancel;
-                    }
-                }
-                //Add file to blacklist
-                unsharedStrings.push_back("fun:" + method);
-                //TODO: could remove unshared nodes after use?
-                //unsharedVarLocs.erase(std::remove(unsharedVarLocs.begin(), unsharedVarLocs.end(), unsnode), unsharedVarLocs.end());
-                //Using above may skip a node when the values are shifted back
-            }cancel:;
-        }
-        if(debug){cout << "\n";}
-        cout << "Found " << un << " new unshared method";
-        if(un!=1){cout <<"s";}
-        cout<<"\n";
+    return objects;
+}
+
+TSAReport::Access RaceDetectorBase::getReportAccess(SHBNode *node, Value *thread) {
+    TSAReport::Access access;
+    access.thread = getThreadName(thread);
+    access.loc = analysisUtil::getSourceLoc(node->getInst());
+    access.write = node->getType() == SHBNode::Write;
+    for (NodeID lock : LS->getLockSet(node->getInst())) {
+        access.locks.push_back(analysisUtil::getSourceLoc(LS->getLock(lock)));
     }
-    else {
-        cout << "Shared Method Check: ";
-        int sh = 0;
-        for(int index=0;index<sharedVarLocs.size();index++){
-            if(debug) {cout << "\nStep # [" << index+1 << "/" << sharedVarLocs.size() << "]";}
-            string snode = sharedVarLocs[index];
-            srcloc = split(snode, "fl: ");
-            if(srcloc.size()>1){file = srcloc[1];} else{continue;}
-            if (true) {
-                //If already identified as shared
-                for (string share : sharedStrings) {
-                    if (share == "src:" + file || share == "fun:" + method) { goto cancel2; }
-                }
-                //Add method to whitelist
-                sh++;
-                sharedStrings.push_back("fun:" + method);
-            }
-            cancel2:;
-        }
-        if(debug){cout << "\n";}
-        cout << "Found " << sh << " new shared method";
-        if(sh!=1){cout <<"s";}
-        cout<<"\n";
+    return access;
+}
+
+void RaceDetectorBase::reportCandidate(SHBNode *n1, Value *t1, SHBNode *n2, Value *t2) {
+    if (!report.writesCandidates()) {return;}
+    TSAReport::RaceCandidate candidate;
+    candidate.first = getReportAccess(n1, t1);
+    candidate.second = getReportAccess(n2, t2);
+    candidate.objects = getCommonObjects(n1, t1, n2, t2);
+    report.addCandidate(candidate);
+}
+
+static void printFound(unsigned num, const char *kind) {
+    cout << "Found " << num << " new " << kind;
+    if(num!=1){cout <<"s";}
+    cout<<"\n";
+}
+
+void RaceDetectorBase::checkFiles() {
+    unsigned un = 0, sh = 0;
+    for (auto &file : fileSharing) {
+        string entry = "src:" + file.first;
+        //If already identified as unshared or shared
+        if (report.hasEntry(entry)) {continue;}
+        report.addEntry(entry, file.second);
+        if (file.second) {sh++;} else {un++;}
+        if (debug) {cout << (file.second ? "Shared " : "Unshared ") << entry << "\n";}
     }
-}//FIXME: METHODS??
-void RaceDetectorBase::checkVariables(bool shared){
-    vector<string> srcloc;
-    string file;
-    string method;
-    string var;
-    if(!shared) {
-        int un=0;
-        cout << "Unshared Var Check: ";
-        for(int index=0;index<unsharedVarLocs.size();index++){
-            if(debug) {cout << "\nStep # [" << index+1 << "/" << unsharedVarLocs.size() << "]";}
-            string unsnode = unsharedVarLocs[index];
-            if(unsnode.find("Glob ")!=string::npos){unsnode = split(unsnode, "Glob ")[1];}
-            srcloc = split(unsnode, "fl: ");
-            if (srcloc.size() > 1) { file = srcloc[1]; } else { continue; }
-            method = ""; //FIXME: Find method name
-            if (true) {
-                //If already identified as unshared
-                for (string unshare : unsharedStrings) {
-                    if (unshare == "src:" + file || unshare == "fun:" + method || unshare == "var:" + unsnode) { goto cancel; }
-                }
+    printFound(un, "unshared file");
+    printFound(sh, "shared file");
+}
 
-                //Add variable to blacklist
-                un++;
-                unsharedStrings.push_back("var:" + unsnode);
-                //TODO: could remove unshared nodes after use?
-                //unsharedVarLocs.erase(std::remove(unsharedVarLocs.begin(), unsharedVarLocs.end(), unsnode), unsharedVarLocs.end());
-                //Using above may skip a node when the values are shifted back
-            }
-            cancel:;
-        }
-        if(debug){cout<<"\n";}
-        cout << "Found " << un << " new unshared var";
-        if(un!=1){cout <<"s";}
-        cout<<"\n";
+void RaceDetectorBase::checkMethods() {
+    unsigned un = 0, sh = 0;
+    for (auto &func : funcSharing) {
+        string entry = "fun:" + func.first;
+        //If already identified as unshared or shared
+        if (report.hasEntry(entry)) {continue;}
+        report.addEntry(entry, func.second);
+        if (func.second) {sh++;} else {un++;}
+        if (debug) {cout << (func.second ? "Shared " : "Unshared ") << entry << "\n";}
     }
-    else
-    {
-        int sh=0;
-        for(int index=0;index<sharedVarLocs.size();index++){
-            if(debug) {cout << "\nStep # [" << index+1 << "/" << sharedVarLocs.size() << "]";}
-            string snode = sharedVarLocs[index];
-            if(snode.find("Glob ")!=string::npos){snode = split(snode, "Glob ")[1];}
-            srcloc = split(snode, "fl: ");
-            if(srcloc.size()>1){file = srcloc[1];} else{continue;}
-            method = "";//FIXME:^^
-            if(true) {
-                //If already identified as shared
-                for (string share : sharedStrings) {if (share == "src:" + file || share == "fun:"+method||share == snode) {goto cancel2;}}
-                //Add variable to whitelist
-                sh++;
-                sharedStrings.push_back("var:" + snode);
-            }cancel2:;
-        }
-        cout << "\nFound " << sh << " new shared var";
-        if(sh!=1){cout <<"s";}
-        cout<<"\n";
+    printFound(un, "unshared method");
+    printFound(sh, "shared method");
+}
+
+void RaceDetectorBase::checkVariables() {
+    unsigned un = 0, sh = 0;
+    for (auto &var : varSharingMap) {
+        if (var.second.file == "") {continue;}
+        string entry = "var:" + var.first;
+        if (report.hasEntry(entry)) {continue;}
+        //If the whole file is already unshared
+        if (!var.second.shared && report.hasEntry("src:" + var.second.file, false)) {continue;}
+        report.addEntry(entry, var.second.shared);
+        if (var.second.shared) {sh++;} else {un++;}
+        if (debug) {cout << (var.second.shared ? "Shared " : "Unshared ") << entry << "\n";}
     }
-}//FIXME: METHODS??
-
-int RaceDetectorBase::output(bool sharedOutput,bool outputFiles, bool outputMethods,bool outputVariables){
-    vector<int> found;
-    //Generate strings for output
-        if (outputFiles) {checkFiles(sharedOutput);}//Find unshared files to exclude from analysis
-        if (outputMethods) {checkMethods(sharedOutput);} //Find unshared methods in files that have not been excluded yet
-        if (outputVariables) {checkVariables(sharedOutput);}//Find unshared variables in files/methods that have not been fully excluded (not TSan supported by default)
-
-    //Generate analysis logs {sharedOutput: false = log unshared,true = log potentially shared}
-        ofstream myFile;
-        if (!sharedOutput) {
-            cout<<"Writing Unshared Output (UnsharedOutput.txt)";
-            myFile.open("../../UnsharedOutput.txt");
-            if (myFile.is_open()) {for (string s : unsharedStrings) {myFile << s + "\n";}}
-            else{cout<<"Could Not Log Output";return 2;}
-        }
-        else {
-            cout<<"Writing Potentially Shared Output (PotentiallySharedOutput.txt)";
-            myFile.open("../../PotentiallySharedOutput.txt");
-            if (myFile.is_open()) {for (string s : sharedStrings) {myFile << s + "\n";}}
-            else{cout<<"Could Not Log Output";return 2;}
-        }
-        myFile.close();
+    printFound(un, "unshared var");
+    printFound(sh, "shared var");
+}
+
+int RaceDetectorBase::output(bool outputFiles, bool outputMethods,bool outputVariables){
+    //Entries are written to the log as they are found {sharedOutput: false = log unshared,true = log potentially shared}
+        if (outputFiles) {checkFiles();}//Find unshared files to exclude from analysis
+        if (outputMethods) {checkMethods();} //Find unshared methods
+        if (outputVariables) {checkVariables();}//Find unshared variables in files that have not been fully excluded (not TSan supported by default)
+
+        if (!report.commit()) {cout<<"Could Not Log Output";return 2;}
+        cout << "Wrote " << report.getNumOfNewEntries() << " new entries to the output log\n";
         return 0;
-}
\ No newline at end of file
+}
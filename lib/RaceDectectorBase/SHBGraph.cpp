@@ -5,9 +5,14 @@
 #include "RaceDetectorBase/SHBGraph.h"
 #include "RaceDetectorBase/InsensitiveLockSet.h"
 #include "Util/GraphUtil.h"
+#include "Util/Parallel.h"
+#include "Util/SCC.h"
+#include "Util/ThreadAPI.h"
 
 #include <llvm/Support/DOTGraphTraits.h>	// for dot graph traits
 
+#include <algorithm>
+
 u64_t SHBNode::CURRENT_NODE_ID = 1;
 u64_t SHBEdge::CURRENT_EDGE_ID = 1;
 using namespace llvm;
@@ -30,16 +35,29 @@ SHBGraph* SHBGraph:: buildFromModule(llvm::Module *module, PointerAnalysis *PTA)
     connectForkEdges(module, graph, forkSite, sites2Node);
     connectJoinEdges(module, graph, joinSite, sites2Node);
 
+    graph->buildSummaries();
+
+    delete forkSite;
+    delete joinSite;
+    delete callSite;
+    delete sites2Node;
+
     return graph;
 }
 
-// A BFS-based reachable algorithm
+/*
+ * A BFS-based reachable algorithm, composed with the function summaries.
+ * The calling context of n1 is unknown, so the search may return from n1's function to any of its callers
+ * (Ret edges), but it never walks into a callee or a forked thread: whatever happens after a call/fork site
+ * is looked up in the summary of the callee, so the search can not leave a callee through another call site.
+ */
 bool SHBGraph::reachable(SHBNode *n1, SHBNode *n2) {
     if (n1 == n2) {
         return true;
     }
 
     NodeBS visited;
+    FuncSet visitedCallees;
     std::list<SHBNode *> queue;
 
     visited.set(n1->getId());
@@ -55,6 +73,14 @@ bool SHBGraph::reachable(SHBNode *n1, SHBNode *n2) {
                 return true;
             }
 
+            if (edge->getType() == SHBEdge::Call || edge->getType() == SHBEdge::Fork) {
+                const llvm::Function *callee = edge->getDstNode()->getFunction();
+                if (visitedCallees.insert(callee).second && getFunctionReach(callee).test(n2->getId())) {
+                    return true;
+                }
+                continue;
+            }
+
             if (visited.test_and_set(edge->getDstID())) {
                 queue.push_back(edge->getDstNode());
             }
@@ -64,6 +90,128 @@ bool SHBGraph::reachable(SHBNode *n1, SHBNode *n2) {
     return false;
 }
 
+/*
+ * Compute the bottom-up summaries of all functions:
+ *  - accesses: the read/write nodes of a function and of everything it calls (the same thread),
+ *  - reach: the nodes of a function, of everything it calls and of the threads forked by them.
+ */
+void SHBGraph::buildSummaries() {
+    FuncDepMap callOrForkMap(calleeMap);
+    for (auto &fork : forkMap) {
+        callOrForkMap[fork.first].insert(fork.second.begin(), fork.second.end());
+    }
+    // every function with nodes gets a summary, even if it has no access of its own
+    for (auto &funcNodes : func2LocalNodesMap) {
+        func2LocalAccessesMap[funcNodes.first];
+    }
+
+    summarizeBottomUp(calleeMap, func2LocalAccessesMap, func2AccessesMap);
+    summarizeBottomUp(callOrForkMap, func2LocalNodesMap, func2ReachMap);
+}
+
+// dependencies on functions without a summary of their own are left out
+FuncDepGraph::FuncDepGraph(const SHBGraph::FuncDepMap &deps, const SHBGraph::FuncNodesMap &local) {
+    std::map<const llvm::Function *, FuncDepNode *> func2Node;
+    NodeID id = 0;
+    for (auto &funcNodes : local) {
+        auto *node = new FuncDepNode(id, funcNodes.first);
+        addGNode(id++, node);
+        func2Node[funcNodes.first] = node;
+    }
+
+    for (auto &funcDeps : deps) {
+        auto srcIter = func2Node.find(funcDeps.first);
+        if (srcIter == func2Node.end()) {
+            continue;
+        }
+        for (const llvm::Function *dep : funcDeps.second) {
+            auto dstIter = func2Node.find(dep);
+            if (dstIter == func2Node.end()) {
+                continue;
+            }
+            auto *edge = new FuncDepEdge(srcIter->second, dstIter->second, 0);
+            srcIter->second->addOutgoingEdge(edge);
+            dstIter->second->addIncomingEdge(edge);
+        }
+    }
+}
+
+/*
+ * summary(F) = local(F) U summary(G) for every G that F depends on.
+ * The dependency graph is collapsed into SCCs (SCCDetection), the SCCs are grouped by their height in the
+ * condensed DAG, and the SCCs of the same height are summarized in parallel since they only read
+ * the summaries of lower ones. Every function of an SCC gets the summary of the whole SCC.
+ */
+void SHBGraph::summarizeBottomUp(const FuncDepMap &deps, const FuncNodesMap &local, FuncNodesMap &summary) {
+    FuncDepGraph depGraph(deps, local);
+    FuncDepGraph *graph = &depGraph;
+    SCCDetection<FuncDepGraph *> scc(graph);
+    scc.find();
+
+    // SCC reps in reverse topological order, dependencies first (the stack pops them in topological order)
+    std::vector<NodeID> reps;
+    for (SCCDetection<FuncDepGraph *>::GNodeStack topo = scc.topoNodeStack(); !topo.empty(); topo.pop()) {
+        reps.push_back(topo.top());
+    }
+    std::reverse(reps.begin(), reps.end());
+
+    // height of each SCC in the condensed DAG, leaves have height 0
+    std::map<NodeID, u32_t> height;
+    std::vector<std::vector<NodeID>> levels;
+    for (NodeID rep : reps) {
+        u32_t &repHeight = height[rep];
+        for (NodeID sub : scc.subNodes(rep)) {
+            for (FuncDepEdge *edge : depGraph.getGNode(sub)->getOutEdges()) {
+                NodeID depRep = scc.repNode(edge->getDstID());
+                if (depRep != rep) {
+                    repHeight = std::max(repHeight, height[depRep] + 1);
+                }
+            }
+        }
+        if (levels.size() <= repHeight) {
+            levels.resize(repHeight + 1);
+        }
+        levels[repHeight].push_back(rep);
+    }
+
+    // create all the entries up front, the workers only modify existing ones
+    for (auto &funcNodes : local) {
+        summary[funcNodes.first];
+    }
+
+    for (std::vector<NodeID> &level : levels) {
+        parallel::parallelFor(level.size(), [&](size_t i) {
+            NodeID rep = level[i];
+            NodeBS nodes;
+            for (NodeID sub : scc.subNodes(rep)) {
+                FuncDepNode *node = depGraph.getGNode(sub);
+                nodes |= local.find(node->getFunction())->second;
+                for (FuncDepEdge *edge : node->getOutEdges()) {
+                    if (scc.repNode(edge->getDstID()) != rep) {
+                        nodes |= summary.find(edge->getDstNode()->getFunction())->second;
+                    }
+                }
+            }
+            for (NodeID sub : scc.subNodes(rep)) {
+                summary.find(depGraph.getGNode(sub)->getFunction())->second = nodes;
+            }
+        });
+    }
+}
+
+// direct callee, or the callees resolved by the pointer analysis for an indirect call
+void SHBGraph::getCallees(llvm::Instruction *inst, FuncSet &callees) {
+    CallSite call(inst);
+    if (const Function *callee = call.getCalledFunction()) {
+        callees.insert(callee);
+    } else if (PTA->getPTACallGraph()->hasCallGraphEdge(inst)) {
+        PTACallGraph *callGraph = PTA->getPTACallGraph();
+        for (auto it = callGraph->getCallEdgeBegin(inst); it != callGraph->getCallEdgeEnd(inst); it++) {
+            callees.insert((*it)->getDstNode()->getFunction());
+        }
+    }
+}
+
 void SHBGraph::buildIntraProcNode(
         llvm::Module *module, SHBGraph *graph,
         std::set<Instruction *> *forkSite,
@@ -112,13 +260,15 @@ void SHBGraph::connectCallEdges(llvm::Module *module, SHBGraph *graph,
         std::map<Instruction *, NodeID> *map) {
 
     for (Instruction *inst : *callSite) {
-        auto *call = new CallSite(inst);
-        if (!call->isIndirectCall()) {
+        SHBGraph::FuncSet callees;
+        graph->getCallees(inst, callees);
+
+        for (const Function *callee : callees) {
             // find function enter and exit node
-            Function *callee = call->getCalledFunction();
-            if (InsensitiveLockSet::isExtFunction(callee)) {
+            if (!graph->hasFunctionNodes(callee)) {
                 continue;
             }
+            graph->calleeMap[inst->getFunction()].insert(callee);
 
             auto enterNode = graph->getFunctionEnterNode(callee);
             auto retNode = graph->getFunctionRetNode(callee);
@@ -139,8 +289,6 @@ void SHBGraph::connectCallEdges(llvm::Module *module, SHBGraph *graph,
             }
             assert(nextNode);
             graph->addEdge(retNode, nextNode, SHBEdge::Ret);
-        } else {
-            //TODO: indirect call. using result from PTA
         }
     }
 }
@@ -148,17 +296,18 @@ void SHBGraph::connectCallEdges(llvm::Module *module, SHBGraph *graph,
 void SHBGraph::connectForkEdges(llvm::Module *, SHBGraph *graph,
         std::set<llvm::Instruction *> *forkSites, std::map<Instruction *, NodeID> *map) {
     for (Instruction *inst : *forkSites) {
-        // TODO: ONLY SUPPORT PTHREAD_CREATE();
-        auto forkSite = new CallSite(inst);
-        assert(forkSite->getCalledFunction()->getName().equals("pthread_create"));
+        // fork APIs follow the pthread_create() layout: thread handle first, start routine third
+        const ThreadAPI *tdAPI = ThreadAPI::getThreadAPI();
+        assert(tdAPI->isTDFork(inst));
 
-        Value *startFunc = forkSite->getArgOperand(2);
-        Value *threadHandle = forkSite->getArgOperand(0);
+        Value *startFunc = const_cast<Value *>(tdAPI->getForkedFun(inst));
+        Value *threadHandle = const_cast<Value *>(tdAPI->getForkedThread(inst));
 
         auto funcStart = dyn_cast<Function>(startFunc);
         assert(funcStart);
 
         graph->addThread(threadHandle, funcStart);
+        graph->forkMap[inst->getFunction()].insert(funcStart);
 
         auto enterNode = graph->getFunctionEnterNode(funcStart);
         auto retNode = graph->getFunctionRetNode(funcStart);
@@ -174,19 +323,22 @@ void SHBGraph::connectJoinEdges(llvm::Module *, SHBGraph *graph,
         std::set<llvm::Instruction *> *joinSites, std::map<Instruction *, NodeID> *map) {
 
     for  (Instruction *inst : *joinSites) {
-        // TODO: ONLY SUPPORT PTHREAD_JOIN();
-        auto joinSite = new CallSite(inst);
-        assert(joinSite->getCalledFunction()->getName().equals("pthread_join"));\
+        // join APIs follow the pthread_join() layout
+        CallSite joinSite(inst);
+        assert(ThreadAPI::getThreadAPI()->isTDJoin(inst));
 
-        Value *threadHandle = joinSite->getArgOperand(0);
+        Value *threadHandle = joinSite.getArgOperand(0);
         // FIXME!!! pthread_join does not take a pointer to identify the thread! so it is skipped by PTA
         // only handle the following special case for now
         // %thread_t = alloca i64,
         // %x = load i64, i64* thread_t,
         // pthread_join(%x),
 
-        assert(isa<LoadInst>(threadHandle));
+        // other handles (e.g. the std::thread object passed to a join API listed in a thread API file)
+        // are not matched to a fork yet
         auto load = dyn_cast<LoadInst>(threadHandle);
+        if (load == nullptr)
+            continue;
         auto handle = load->getPointerOperand();
 
         for (llvm::Value *thread : graph->getThreadSet()) {
@@ -222,6 +374,29 @@ void SHBGraph::connectJoinEdges(llvm::Module *, SHBGraph *graph,
 
 
 namespace llvm {
+    /*!
+     * Function and kind of SHB nodes for filtering graph exports
+     */
+    template<>
+    struct GraphExportTraits<SHBGraph *> {
+        static const Function *getFunction(SHBNode *node) {
+            return node->getFunction();
+        }
+        static std::string getNodeKind(SHBNode *node) {
+            switch (node->getType()) {
+                case SHBNode::Write:
+                    return "Write";
+                case SHBNode::Read:
+                    return "Read";
+                case SHBNode::Enter:
+                    return "Enter";
+                case SHBNode::Ret:
+                    return "Ret";
+            }
+            return "";
+        }
+    };
+
     /*!
      * Write value flow graph into dot file for debugging
      */
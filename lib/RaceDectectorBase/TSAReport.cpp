@@ -0,0 +1,163 @@
+//
+// TSAReport.cpp -- streaming writer for the TSA ignore list and race candidates
+//
+
+#include "RaceDetectorBase/TSAReport.h"
+#include "Util/AnalysisUtil.h"
+
+#include <cstdio>
+
+using namespace std;
+
+static const char *TMP_SUFFIX = ".tmp";
+
+bool TSAReport::open(const string &ignoreListPath, bool sharedOutput, Format format, const string &candidatesPath) {
+    this->sharedOutput = sharedOutput;
+    this->format = format;
+    this->ignoreListPath = ignoreListPath;
+    this->candidatesPath = candidatesPath;
+
+    // the buffers have to be installed before the files are opened
+    ignoreListBuf.resize(BUFFER_SIZE);
+    ignoreList.rdbuf()->pubsetbuf(ignoreListBuf.data(), ignoreListBuf.size());
+    ignoreList.open(ignoreListPath + TMP_SUFFIX);
+    if (!ignoreList.is_open()) {
+        return false;
+    }
+
+    if (format != NoCandidates) {
+        candidatesBuf.resize(BUFFER_SIZE);
+        candidates.rdbuf()->pubsetbuf(candidatesBuf.data(), candidatesBuf.size());
+        candidates.open(candidatesPath + TMP_SUFFIX);
+        if (!candidates.is_open()) {
+            return false;
+        }
+        if (format == CSV) {
+            candidates << "thread1,access1,write1,locks1,thread2,access2,write2,locks2,objects\n";
+        }
+    }
+    return true;
+}
+
+bool TSAReport::commit() {
+    bool ok = true;
+    if (ignoreList.is_open()) {
+        ignoreList.close();
+        ok = !ignoreList.fail() && rename((ignoreListPath + TMP_SUFFIX).c_str(), ignoreListPath.c_str()) == 0;
+    }
+    if (candidates.is_open()) {
+        candidates.close();
+        ok = !candidates.fail() && rename((candidatesPath + TMP_SUFFIX).c_str(), candidatesPath.c_str()) == 0 && ok;
+    }
+    return ok;
+}
+
+void TSAReport::discard() {
+    if (ignoreList.is_open()) {
+        ignoreList.close();
+        remove((ignoreListPath + TMP_SUFFIX).c_str());
+    }
+    if (candidates.is_open()) {
+        candidates.close();
+        remove((candidatesPath + TMP_SUFFIX).c_str());
+    }
+}
+
+void TSAReport::addLoggedEntry(const string &entry, bool shared) {
+    unordered_set<string> &entries = shared ? sharedEntries : unsharedEntries;
+    if (entries.insert(entry).second && shared == sharedOutput) {
+        ignoreList << entry << '\n';
+    }
+}
+
+bool TSAReport::addEntry(const string &entry, bool shared) {
+    unordered_set<string> &entries = shared ? sharedEntries : unsharedEntries;
+    if (!entries.insert(entry).second) {
+        return false;
+    }
+    if (shared == sharedOutput) {
+        ignoreList << entry << '\n';
+        numOfNewEntries++;
+    }
+    return true;
+}
+
+void TSAReport::addCandidate(const RaceCandidate &candidate) {
+    numOfCandidates++;
+    if (format == JSON) {
+        writeCandidateJSON(candidate);
+    } else if (format == CSV) {
+        writeCandidateCSV(candidate);
+    }
+}
+
+static void writeJSONList(ofstream &out, const vector<string> &list) {
+    out << '[';
+    for (size_t i = 0; i < list.size(); i++) {
+        if (i) {
+            out << ',';
+        }
+        out << analysisUtil::getJSONString(list[i]);
+    }
+    out << ']';
+}
+
+static void writeJSONAccess(ofstream &out, const TSAReport::Access &access) {
+    out << "{\"thread\":";
+    out << analysisUtil::getJSONString(access.thread);
+    out << ",\"access\":";
+    out << analysisUtil::getJSONString(access.loc);
+    out << ",\"write\":" << (access.write ? "true" : "false") << ",\"locks\":";
+    writeJSONList(out, access.locks);
+    out << '}';
+}
+
+// one JSON object per line, so that the file can be consumed while it is written
+void TSAReport::writeCandidateJSON(const RaceCandidate &candidate) {
+    candidates << "{\"first\":";
+    writeJSONAccess(candidates, candidate.first);
+    candidates << ",\"second\":";
+    writeJSONAccess(candidates, candidate.second);
+    candidates << ",\"objects\":";
+    writeJSONList(candidates, candidate.objects);
+    candidates << "}\n";
+}
+
+static void writeCSVField(ofstream &out, const string &field) {
+    out << '"';
+    for (char c : field) {
+        if (c == '"') {
+            out << '"';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+static void writeCSVList(ofstream &out, const vector<string> &list) {
+    string joined;
+    for (size_t i = 0; i < list.size(); i++) {
+        if (i) {
+            joined += ';';
+        }
+        joined += list[i];
+    }
+    writeCSVField(out, joined);
+}
+
+static void writeCSVAccess(ofstream &out, const TSAReport::Access &access) {
+    writeCSVField(out, access.thread);
+    out << ',';
+    writeCSVField(out, access.loc);
+    out << ',' << (access.write ? 1 : 0) << ',';
+    writeCSVList(out, access.locks);
+}
+
+void TSAReport::writeCandidateCSV(const RaceCandidate &candidate) {
+    writeCSVAccess(candidates, candidate.first);
+    candidates << ',';
+    writeCSVAccess(candidates, candidate.second);
+    candidates << ',';
+    writeCSVList(candidates, candidate.objects);
+    candidates << '\n';
+}
@@ -0,0 +1,145 @@
+//
+// TSAState.cpp -- persisted TSA state for incremental runs
+//
+
+#include "RaceDetectorBase/TSAState.h"
+
+#include <fstream>
+#include <sstream>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DebugLoc.h>
+#include <llvm/IR/InlineAsm.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace llvm;
+
+/*
+ * State file format, one record per line:
+ *   fn <function name> <hash> <reaches fork: 0|1>
+ *   th <thread start routine>              (belongs to the previous fn)
+ *   ac <U|S> <pts digest> <source loc>     (belongs to the previous fn)
+ */
+bool TSAState::load(const std::string &path) {
+    std::ifstream stateFile(path);
+    if (!stateFile.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    FunctionSummary *cur = nullptr;
+    while (getline(stateFile, line)) {
+        std::istringstream record(line);
+        std::string tag;
+        record >> tag;
+        if (tag == "fn") {
+            std::string name, hash;
+            int reachesFork = 0;
+            record >> name >> hash >> reachesFork;
+            cur = &summaries[name];
+            cur->hash = hash;
+            cur->reachesFork = reachesFork != 0;
+        } else if (tag == "th" && cur) {
+            std::string thread;
+            record >> thread;
+            cur->threads.insert(thread);
+        } else if (tag == "ac" && cur) {
+            std::string verdict, ptsDigest, loc;
+            record >> verdict >> ptsDigest;
+            getline(record >> std::ws, loc);
+            AccessRecord &access = cur->accesses[loc];
+            access.verdict = verdict == "S" ? Shared : Unshared;
+            access.ptsDigest = ptsDigest;
+        }
+    }
+    stateFile.close();
+
+    loaded = true;
+    return true;
+}
+
+bool TSAState::save(const std::string &path) const {
+    // written next to the previous state, which is only replaced by a complete one
+    std::string tmpPath = path + ".tmp";
+    std::ofstream stateFile(tmpPath);
+    if (!stateFile.is_open()) {
+        return false;
+    }
+
+    for (const auto &summary : summaries) {
+        stateFile << "fn " << summary.first << " " << summary.second.hash << " "
+                  << (summary.second.reachesFork ? 1 : 0) << "\n";
+        for (const std::string &thread : summary.second.threads) {
+            stateFile << "th " << thread << "\n";
+        }
+        for (const auto &access : summary.second.accesses) {
+            stateFile << "ac " << (access.second.verdict == Shared ? "S" : "U") << " "
+                      << access.second.ptsDigest << " " << access.first << "\n";
+        }
+    }
+    stateFile.close();
+    if (stateFile.fail()) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+std::string TSAState::digest(const std::string &str) {
+    MD5 hasher;
+    hasher.update(str);
+    MD5::MD5Result result;
+    hasher.final(result);
+
+    SmallString<32> hex;
+    MD5::stringifyResult(result, hex);
+    return hex.str().str();
+}
+
+std::string TSAState::hashFunction(const llvm::Function *func) {
+    // number local values by position so that renaming does not change the hash
+    std::map<const Value *, unsigned> localIDs;
+    unsigned nextID = 0;
+    for (const Argument &arg : func->args()) {
+        localIDs[&arg] = nextID++;
+    }
+    for (const BasicBlock &bb : *func) {
+        localIDs[&bb] = nextID++;
+        for (const Instruction &inst : bb) {
+            localIDs[&inst] = nextID++;
+        }
+    }
+
+    std::string str;
+    raw_string_ostream rawstr(str);
+    rawstr << *func->getFunctionType() << "\n";
+    for (const BasicBlock &bb : *func) {
+        rawstr << "bb" << localIDs[&bb] << ":\n";
+        for (const Instruction &inst : bb) {
+            rawstr << inst.getOpcodeName() << " " << *inst.getType();
+            for (const Value *op : inst.operands()) {
+                auto iter = localIDs.find(op);
+                if (iter != localIDs.end()) {
+                    rawstr << " %" << iter->second;
+                } else if (const auto *global = dyn_cast<GlobalValue>(op)) {
+                    rawstr << " @" << global->getName();
+                } else if (isa<Constant>(op) || isa<InlineAsm>(op)) {
+                    // the whole constant (floats, strings, aggregates, constant expressions)
+                    rawstr << " " << *op;
+                } else if (op) {
+                    // metadata, printed by number, which would change with unrelated code
+                    rawstr << " " << *op->getType();
+                }
+            }
+            // the ignore list is keyed by source location, so line shifts matter
+            if (const DebugLoc &loc = inst.getDebugLoc()) {
+                rawstr << " !" << loc.getLine();
+            }
+            rawstr << "\n";
+        }
+    }
+    return digest(rawstr.str());
+}
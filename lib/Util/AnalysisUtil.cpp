@@ -42,6 +42,7 @@
 #include <llvm/IR/CFG.h>		// for CFG
 #include "Util/Conditions.h"
 #include <sys/resource.h>		/// increase stack size
+#include <cstdio>		/// for snprintf
 #include <llvm/IRReader/IRReader.h>     /// for isIRFile
 #include <llvm/Bitcode/BitcodeReader.h>     /// for isBitcode
 
@@ -400,6 +401,43 @@ std::string analysisUtil::pasMsg(std::string msg) {
     return KBLU + msg + KNRM;
 }
 
+/*!
+ * Quote and escape a string for JSON output
+ */
+std::string analysisUtil::getJSONString(const std::string& str) {
+    std::string json = "\"";
+    for (std::string::const_iterator it = str.begin(), eit = str.end(); it != eit; ++it) {
+        unsigned char c = *it;
+        switch (c) {
+        case '"':
+            json += "\\\"";
+            break;
+        case '\\':
+            json += "\\\\";
+            break;
+        case '\n':
+            json += "\\n";
+            break;
+        case '\r':
+            json += "\\r";
+            break;
+        case '\t':
+            json += "\\t";
+            break;
+        default:
+            if (c < 0x20) {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", c);
+                json += buf;
+            } else {
+                json += c;
+            }
+        }
+    }
+    json += "\"";
+    return json;
+}
+
 /*!
  * Dump points-to set
  */
@@ -0,0 +1,66 @@
+//===- GraphUtil.cpp -- Options of graph exports ------------------------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * GraphUtil.cpp
+ *
+ * Command line options shared by every graph export (-dump-pag, -dump-svfg, ...)
+ */
+
+#include "Util/GraphUtil.h"
+
+#include <algorithm>
+
+using namespace llvm;
+
+static cl::opt<GraphPrinter::Format> GraphFormat("graph-format", cl::init(GraphPrinter::DOT),
+        cl::desc("Format of the dumped graphs"),
+        cl::values(
+            clEnumValN(GraphPrinter::DOT, "dot", "dot files (<graph>.dot)"),
+            clEnumValN(GraphPrinter::EdgeList, "edges", "JSON lines of nodes and edges (<graph>.jsonl)")
+        ));
+
+static cl::list<std::string> GraphFunctions("graph-func", cl::CommaSeparated,
+        cl::desc("Only dump the graph nodes of these functions"));
+
+static cl::list<std::string> GraphKinds("graph-kind", cl::CommaSeparated,
+        cl::desc("Only dump the graph nodes of these kinds (e.g. Load,Store for SVFG, Read,Write for SHB)"));
+
+GraphPrinter::Format GraphPrinter::getFormat() {
+    return GraphFormat;
+}
+
+bool GraphPrinter::hasNodeFilter() {
+    return !GraphFunctions.empty() || !GraphKinds.empty();
+}
+
+bool GraphPrinter::isNodeExported(const Function* fun, const std::string& kind) {
+    if (!GraphFunctions.empty()) {
+        if (fun == NULL || std::find(GraphFunctions.begin(), GraphFunctions.end(), fun->getName().str()) == GraphFunctions.end())
+            return false;
+    }
+    if (!GraphKinds.empty()) {
+        if (std::find(GraphKinds.begin(), GraphKinds.end(), kind) == GraphKinds.end())
+            return false;
+    }
+    return true;
+}
@@ -34,7 +34,10 @@
 #include "Util/AnalysisUtil.h"
 #include <llvm/IR/Module.h>
 #include <llvm/IR/InstIterator.h>	// for inst iteration
+#include <llvm/Support/CommandLine.h>	// for cl
 #include <iostream>		/// std output
+#include <fstream>
+#include <sstream>
 #include <stdio.h>
 #include <iomanip>		/// for setw
 
@@ -44,6 +47,9 @@ using namespace std;
 
 ThreadAPI* ThreadAPI::tdAPI = NULL;
 
+static cl::opt<std::string> ThreadAPIFile("thread-api", cl::init(""), cl::value_desc("filename"),
+        cl::desc("Read additional thread/lock APIs from a file"));
+
 /// string and type pair
 struct ei_pair {
     const char *n;
@@ -61,18 +67,30 @@ static const ei_pair ei_pairs[]= {
     {"pthread_cancel", ThreadAPI::TD_JOIN},
     {"pthread_mutex_lock", ThreadAPI::TD_ACQUIRE},
     {"pthread_rwlock_rdlock", ThreadAPI::TD_ACQUIRE},
+    {"pthread_rwlock_wrlock", ThreadAPI::TD_ACQUIRE},
+    {"pthread_spin_lock", ThreadAPI::TD_ACQUIRE},
     {"sem_wait", ThreadAPI::TD_ACQUIRE},
     {"_spin_lock", ThreadAPI::TD_ACQUIRE},
     {"SRE_SplSpecLockEx", ThreadAPI::TD_ACQUIRE},
+    {"_ZNSt5mutex4lockEv", ThreadAPI::TD_ACQUIRE},    // std::mutex::lock()
+    {"_ZNSt15recursive_mutex4lockEv", ThreadAPI::TD_ACQUIRE},    // std::recursive_mutex::lock()
     {"pthread_mutex_trylock", ThreadAPI::TD_TRY_ACQUIRE},
+    {"pthread_rwlock_tryrdlock", ThreadAPI::TD_TRY_ACQUIRE},
+    {"pthread_rwlock_trywrlock", ThreadAPI::TD_TRY_ACQUIRE},
+    {"pthread_spin_trylock", ThreadAPI::TD_TRY_ACQUIRE},
+    {"_ZNSt5mutex8try_lockEv", ThreadAPI::TD_TRY_ACQUIRE},    // std::mutex::try_lock()
     {"pthread_mutex_unlock", ThreadAPI::TD_RELEASE},
     {"pthread_rwlock_unlock", ThreadAPI::TD_RELEASE},
+    {"pthread_spin_unlock", ThreadAPI::TD_RELEASE},
     {"sem_post", ThreadAPI::TD_RELEASE},
     {"_spin_unlock", ThreadAPI::TD_RELEASE},
     {"SRE_SplSpecUnlockEx", ThreadAPI::TD_RELEASE},
+    {"_ZNSt5mutex6unlockEv", ThreadAPI::TD_RELEASE},    // std::mutex::unlock()
+    {"_ZNSt15recursive_mutex6unlockEv", ThreadAPI::TD_RELEASE},    // std::recursive_mutex::unlock()
 //    {"pthread_cancel", ThreadAPI::TD_CANCEL},
     {"pthread_exit", ThreadAPI::TD_EXIT},
     {"pthread_detach", ThreadAPI::TD_DETACH},
+    {"_ZNSt6thread6detachEv", ThreadAPI::TD_DETACH},    // std::thread::detach()
     {"pthread_cond_wait", ThreadAPI::TD_COND_WAIT},
     {"pthread_cond_signal", ThreadAPI::TD_COND_SIGNAL},
     {"pthread_cond_broadcast", ThreadAPI::TD_COND_BROADCAST},
@@ -116,6 +134,76 @@ void ThreadAPI::init() {
         }
         tdAPIMap[p->n]= p->t;
     }
+
+    if (!ThreadAPIFile.empty() && !loadAPIFile(ThreadAPIFile))
+        analysisUtil::wrnMsg("cannot open thread API file " + ThreadAPIFile);
+}
+
+/// Names of the threadAPI types used in a thread API file
+static const ei_pair td_kinds[]= {
+    {"fork", ThreadAPI::TD_FORK},
+    {"join", ThreadAPI::TD_JOIN},
+    {"detach", ThreadAPI::TD_DETACH},
+    {"acquire", ThreadAPI::TD_ACQUIRE},
+    {"try_acquire", ThreadAPI::TD_TRY_ACQUIRE},
+    {"release", ThreadAPI::TD_RELEASE},
+    {"exit", ThreadAPI::TD_EXIT},
+    {"cancel", ThreadAPI::TD_CANCEL},
+    {"cond_wait", ThreadAPI::TD_COND_WAIT},
+    {"cond_signal", ThreadAPI::TD_COND_SIGNAL},
+    {"cond_broadcast", ThreadAPI::TD_COND_BROADCAST},
+    {"mutex_init", ThreadAPI::TD_MUTEX_INI},
+    {"mutex_destroy", ThreadAPI::TD_MUTEX_DESTROY},
+    {"condvar_init", ThreadAPI::TD_CONDVAR_INI},
+    {"condvar_destroy", ThreadAPI::TD_CONDVAR_DESTROY},
+    {"barrier_init", ThreadAPI::TD_BAR_INIT},
+    {"barrier_wait", ThreadAPI::TD_BAR_WAIT},
+    {"hare_parallel_for", ThreadAPI::HARE_PAR_FOR},
+    {0, ThreadAPI::TD_DUMMY}
+};
+
+/*!
+ * Read additional APIs, one "<function name> <kind>" pair per line, '#' starts a comment.
+ * Fork/join/lock APIs are expected to take their arguments in the same positions as
+ * pthread_create/pthread_join/pthread_mutex_lock.
+ */
+bool ThreadAPI::loadAPIFile(const std::string& file) {
+    std::ifstream apiFile(file.c_str());
+    if (!apiFile.is_open())
+        return false;
+
+    std::string line;
+    while (getline(apiFile, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream entry(line);
+        std::string name, kind;
+        if (!(entry >> name >> kind))
+            continue;
+
+        const ei_pair *p = td_kinds;
+        for (; p->n; ++p) {
+            if (kind == p->n)
+                break;
+        }
+        if (p->n)
+            tdAPIMap[name] = p->t;
+        else
+            analysisUtil::wrnMsg("unknown thread API kind '" + kind + "' for " + name);
+    }
+
+    // names may have changed, resolve the module again
+    funToTDTypeMap.clear();
+    return true;
+}
+
+/*!
+ * Resolve every function of the module to its threadAPI type
+ */
+void ThreadAPI::resolveModule(const llvm::Module& module) {
+    for (const Function &fun : module) {
+        TDAPIMap::const_iterator it = tdAPIMap.find(fun.getName());
+        funToTDTypeMap[&fun] = it != tdAPIMap.end() ? it->second : TD_DUMMY;
+    }
 }
 
 /*!
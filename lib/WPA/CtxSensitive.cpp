@@ -0,0 +1,73 @@
+//===- CtxSensitive.cpp -- Context-sensitive pointer analysis-----------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+#include "WPA/CtxSensitive.h"
+
+#include <llvm/Support/CommandLine.h>
+
+static llvm::cl::opt<CtxSensitiveOptions::CallGraphKind> CtxCallGraph("ctx-callgraph",
+        llvm::cl::init(CtxSensitiveOptions::AndersenCallGraph),
+        llvm::cl::desc("Call graph the contexts are built from, indirect calls are resolved while solving"),
+        llvm::cl::values(
+            clEnumValN(CtxSensitiveOptions::DirectCallGraph, "direct", "direct calls only"),
+            clEnumValN(CtxSensitiveOptions::TypeCallGraph, "type", "indirect calls to the address-taken functions with matching arguments (CHA for virtual calls)"),
+            clEnumValN(CtxSensitiveOptions::AndersenCallGraph, "andersen", "call graph of a whole-program Andersen analysis")
+        ));
+
+static llvm::cl::opt<bool> CtxCloneReachable("ctx-clone-reachable", llvm::cl::init(false),
+        llvm::cl::desc("Clone functions only for the call site contexts reachable over the call graph (including indirect calls resolved while solving), instead of for every k-limited caller chain"));
+
+static llvm::cl::opt<bool> CtxSelective("ctx-selective", llvm::cl::init(false),
+        llvm::cl::desc("Give contexts only to the functions and objects selected by a cost model over an Andersen pre-analysis"));
+
+static llvm::cl::opt<bool> CtxParallel("ctx-parallel", llvm::cl::init(false),
+        llvm::cl::desc("Solve the partitions of the constraint graph (one per origin) on parallel threads instead of one after the other"));
+
+static llvm::cl::opt<unsigned> CtxThreads("ctx-threads", llvm::cl::init(0),
+        llvm::cl::desc("Number of threads for -ctx-parallel, 0 for one per hardware thread"));
+
+static llvm::cl::opt<bool> CtxDumpConsG("ctx-dump-consg", llvm::cl::init(false),
+        llvm::cl::desc("Dump the solved context-sensitive constraint graph"));
+
+CtxSensitiveOptions::CallGraphKind CtxSensitiveOptions::getCallGraphKind() {
+    return CtxCallGraph;
+}
+
+bool CtxSensitiveOptions::cloneReachableOnly() {
+    return CtxCloneReachable;
+}
+
+bool CtxSensitiveOptions::selectContexts() {
+    return CtxSelective;
+}
+
+bool CtxSensitiveOptions::solveInParallel() {
+    return CtxParallel;
+}
+
+unsigned CtxSensitiveOptions::getNumOfThreads() {
+    return CtxThreads;
+}
+
+bool CtxSensitiveOptions::dumpConstraintGraph() {
+    return CtxDumpConsG;
+}
@@ -0,0 +1,154 @@
+//===- CtxSensitiveStat.cpp -- Statistics of context-sensitive analysis-------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+#include "WPA/WPAStat.h"
+
+#include <llvm/Support/CommandLine.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/resource.h>
+
+static llvm::cl::opt<std::string> CtxStatJSON("ctx-stat-json", llvm::cl::init(""),
+        llvm::cl::desc("Write the statistics of the context-sensitive analysis into the given JSON file"));
+
+const char* CtxSensitiveStat::PreAnalysisTime = "PreAnalysisTime";
+const char* CtxSensitiveStat::BuildCtxPAGTime = "BuildCtxPAGTime";
+const char* CtxSensitiveStat::SolvingTime = "SolvingTime";
+const char* CtxSensitiveStat::ProjectionTime = "ProjectionTime";
+const char* CtxSensitiveStat::AverageCloneFactor = "AvgCloneFactor";
+const char* CtxSensitiveStat::NumOfCtxPAGNodes = "CtxPAGNodeNum";
+const char* CtxSensitiveStat::NumOfCtxPAGObjNodes = "CtxPAGObjNodeNum";
+const char* CtxSensitiveStat::NumOfCtxPAGPtrNodes = "CtxPAGPtrNodeNum";
+const char* CtxSensitiveStat::NumOfCtxPAGEdges = "CtxPAGEdgeNum";
+const char* CtxSensitiveStat::NumOfCtxCGNodes = "CtxCGNodeNum";
+const char* CtxSensitiveStat::MaxCloneFactor = "MaxCloneFactor";
+const char* CtxSensitiveStat::NumOfSharedPtsSets = "SharedPtsSets";
+const char* CtxSensitiveStat::NumOfPartitions = "Partitions";
+const char* CtxSensitiveStat::NumOfPartitionRounds = "PartitionRounds";
+const char* CtxSensitiveStat::NumOfInsensitiveFuncs = "CtxInsenFuncs";
+const char* CtxSensitiveStat::NumOfInsensitiveObjs = "CtxInsenObjs";
+const char* CtxSensitiveStat::PeakRSS = "PeakRSS(KB)";
+
+u32_t CtxSensitiveStat::getPtsSizeBucket(u32_t size) {
+    u32_t bucket = 1;
+    if (size == 0)
+        return 0;
+    while (bucket * 2 <= size)
+        bucket *= 2;
+    return bucket;
+}
+
+static u32_t getPeakRSSKB() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    // kilobytes on Linux
+    return usage.ru_maxrss;
+}
+
+void CtxSensitiveStat::performStat() {
+    endClk();
+
+    // the PAG and call graph statistics, printed on their own
+    PTAStat::performStat();
+
+    timeStatMap = ctxTimeStatMap;
+    timeStatMap[TotalAnalysisTime] = (endTime - startTime) / TIMEINTERVAL;
+
+    PTNumStatMap = ctxNumStatMap;
+    PTNumStatMap[PeakRSS] = getPeakRSSKB();
+
+    printStat();
+
+    if (!CtxStatJSON.empty())
+        writeJSON(CtxStatJSON);
+}
+
+void CtxSensitiveStat::printStat() {
+    std::cout << "\n****Context-Sensitive Pointer Analysis Statistics****\n";
+    PTAStat::printStat();
+
+    unsigned field_width = 20;
+    std::cout.flags(std::ios::left);
+    std::cout << "Contexts per node:\n";
+    for (const auto &entry : ctxPerNode)
+        std::cout << "  " << std::setw(field_width) << entry.first << entry.second << "\n";
+    std::cout << "Points-to sizes:\n";
+    for (const auto &entry : ptsSizes)
+        std::cout << "  " << std::setw(field_width) << entry.first << entry.second << "\n";
+    if (partitionTimes.size() > 1) {
+        std::cout << "Solving time per partition:\n";
+        for (const auto &entry : partitionTimes)
+            std::cout << "  " << std::setw(field_width) << entry.first << entry.second << "\n";
+    }
+    std::cout << "#######################################################" << std::endl;
+}
+
+template <typename Map>
+static void writeJSONObject(std::ofstream &out, const Map &map) {
+    out << '{';
+    bool first = true;
+    for (const auto &entry : map) {
+        if (!first)
+            out << ',';
+        first = false;
+        std::ostringstream key;
+        key << entry.first;
+        out << analysisUtil::getJSONString(key.str());
+        out << ':' << entry.second;
+    }
+    out << '}';
+}
+
+/*!
+ * {"time": {..}, "numbers": {..}, "functionClones": {..}, "contextsPerNode": {..}, "ptsSizes": {..},
+ *  "partitions": [{"name": .., "time": ..}, ..]}, times in seconds
+ */
+void CtxSensitiveStat::writeJSON(const std::string &fileName) const {
+    std::ofstream out(fileName);
+    if (!out.is_open()) {
+        analysisUtil::wrnMsg("cannot open " + fileName);
+        return;
+    }
+
+    out << "{\"time\":";
+    writeJSONObject(out, timeStatMap);
+    out << ",\"numbers\":";
+    writeJSONObject(out, PTNumStatMap);
+    out << ",\"functionClones\":";
+    writeJSONObject(out, funcClones);
+    out << ",\"contextsPerNode\":";
+    writeJSONObject(out, ctxPerNode);
+    out << ",\"ptsSizes\":";
+    writeJSONObject(out, ptsSizes);
+    out << ",\"partitions\":[";
+    for (size_t i = 0; i < partitionTimes.size(); i++) {
+        if (i)
+            out << ',';
+        out << "{\"name\":";
+        out << analysisUtil::getJSONString(partitionTimes[i].first);
+        out << ",\"time\":" << partitionTimes[i].second << '}';
+    }
+    out << "]}\n";
+}
@@ -31,10 +31,21 @@
 #include "WPA/WPAStat.h"
 #include "WPA/FlowSensitive.h"
 #include "WPA/Andersen.h"
+#include "Util/Parallel.h"
 #include <llvm/Support/Debug.h>		// DEBUG TYPE
+#include <llvm/Support/CommandLine.h>
 
 using namespace llvm;
 
+static cl::opt<bool> FSParallel("fs-parallel", cl::init(false),
+                                cl::desc("Solve flow-sensitive analysis level by level over the SCCs of SVFG, propagating along indirect edges in parallel"));
+
+static cl::opt<unsigned> FSThreads("fs-threads", cl::init(0),
+                                   cl::desc("Number of threads for -fs-parallel, 0 for one per hardware thread"));
+
+/// Levels with fewer successors to update are propagated on the calling thread
+static const u32_t MinParallelTasks = 64;
+
 
 FlowSensitive* FlowSensitive::fspta = NULL;
 
@@ -47,11 +58,37 @@ void FlowSensitive::initialize(SVFModule svfModule) {
     AndersenWaveDiff* ander = AndersenWaveDiff::createAndersenWaveDiff(svfModule);
     svfg = memSSA.buildSVFG(ander);
     setGraph(svfg);
+    initDFVars();
     //AndersenWaveDiff::releaseAndersenWaveDiff();
 
     stat = new FlowSensitiveStat(this);
 }
 
+/*!
+ * The address-taken variables which may have IN/OUT sets at an SVFG node are
+ * the objects on its indirect edges, number them once so that IN/OUT are flat arrays.
+ * Variables showing up later (e.g. fields of collapsed objects) are numbered when they are updated.
+ */
+void FlowSensitive::initDFVars()
+{
+    for (SVFG::iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it) {
+        const SVFGNode* node = it->second;
+        PointsTo vars;
+        for (SVFGNode::const_iterator edgeIt = node->InEdgeBegin(), edgeEit = node->InEdgeEnd();
+                edgeIt != edgeEit; ++edgeIt) {
+            if (const IndirectSVFGEdge* indEdge = dyn_cast<IndirectSVFGEdge>(*edgeIt))
+                vars |= indEdge->getPointsTo();
+        }
+        for (SVFGNode::const_iterator edgeIt = node->OutEdgeBegin(), edgeEit = node->OutEdgeEnd();
+                edgeIt != edgeEit; ++edgeIt) {
+            if (const IndirectSVFGEdge* indEdge = dyn_cast<IndirectSVFGEdge>(*edgeIt))
+                vars |= indEdge->getPointsTo();
+        }
+        if (!vars.empty())
+            getDFPTDataTy()->initDFVars(node->getId(), vars);
+    }
+}
+
 /*!
  * Start analysis
  */
@@ -119,6 +156,160 @@ NodeStack& FlowSensitive::SCCDetect()
     return nodeStack;
 }
 
+/*!
+ * Constraint solving
+ */
+void FlowSensitive::solve()
+{
+    if (FSParallel && getAnalysisTy() == FSSPARSE_WPA)
+        solveByLevels();
+    else
+        WPASVFGFSSolver::solve();
+}
+
+/*!
+ * Solve SVFG level by level.
+ * Successors are updated with the unions of propVarPtsFromSrcToDst, the variables with new points-to are
+ * picked on the calling thread so that each parallel task only reads its predecessors and writes its own IN set.
+ */
+void FlowSensitive::solveByLevels()
+{
+    /// every node is processed at its level
+    while (!isWorklistEmpty())
+        popFromWorklist();
+
+    NodeStack& nodeStack = SCCDetect();
+    std::vector<NodeID> topoOrder;
+    NodeID numOfNodes = 0;
+    while (!nodeStack.empty()) {
+        NodeID id = nodeStack.top();
+        nodeStack.pop();
+        topoOrder.push_back(id);
+        if (id >= numOfNodes)
+            numOfNodes = id + 1;
+    }
+
+    /// Levels of the SCCs, the predecessors of an SCC come before it in topological order
+    std::vector<u32_t> levelOf(numOfNodes, 0);
+    std::vector<std::vector<NodeID> > levels;
+    for (std::vector<NodeID>::const_iterator it = topoOrder.begin(), eit = topoOrder.end(); it != eit; ++it) {
+        NodeID rep = getSCCDetector()->repNode(*it);
+        if (rep == *it) {
+            if (levelOf[rep] >= levels.size())
+                levels.resize(levelOf[rep] + 1);
+            levels[levelOf[rep]].push_back(rep);
+        }
+        SVFGNode* node = svfg->getSVFGNode(*it);
+        for (SVFGNode::const_iterator edgeIt = node->OutEdgeBegin(), edgeEit = node->OutEdgeEnd();
+                edgeIt != edgeEit; ++edgeIt) {
+            NodeID dstRep = getSCCDetector()->repNode((*edgeIt)->getDstID());
+            if (dstRep != rep && levelOf[dstRep] < levelOf[rep] + 1)
+                levelOf[dstRep] = levelOf[rep] + 1;
+        }
+    }
+
+    getDFPTDataTy()->initLocs(numOfNodes);
+
+    typedef std::pair<const SVFGNode*, NodeID> SrcVar;
+    for (u32_t level = 0; level < levels.size(); level++) {
+        std::vector<NodeID> singles;
+        std::vector<NodeID> sccs;
+        for (std::vector<NodeID>::const_iterator it = levels[level].begin(), eit = levels[level].end(); it != eit; ++it) {
+            SVFGNode* node = svfg->getSVFGNode(*it);
+            bool trivial = getSCCDetector()->subNodes(*it).count() == 1;
+            for (SVFGNode::const_iterator edgeIt = node->OutEdgeBegin(), edgeEit = node->OutEdgeEnd();
+                    trivial && edgeIt != edgeEit; ++edgeIt) {
+                if ((*edgeIt)->getDstID() == *it)
+                    trivial = false;
+            }
+            if (trivial)
+                singles.push_back(*it);
+            else
+                sccs.push_back(*it);
+        }
+
+        /// Single-node SCCs
+        std::vector<SVFGNode*> changedNodes;
+        for (std::vector<NodeID>::const_iterator it = singles.begin(), eit = singles.end(); it != eit; ++it) {
+            SVFGNode* node = svfg->getSVFGNode(*it);
+            if (processSVFGNode(node))
+                changedNodes.push_back(node);
+            else
+                clearAllDFOutVarFlag(node);
+        }
+
+        double start = stat->getClk();
+        llvm::DenseMap<NodeID, u32_t> dstToTask;
+        std::vector<const SVFGNode*> taskDsts;
+        std::vector<std::vector<SrcVar> > taskVars;
+        for (std::vector<SVFGNode*>::const_iterator it = changedNodes.begin(), eit = changedNodes.end(); it != eit; ++it) {
+            const SVFGNode* src = *it;
+            bool fromOut = isa<StoreSVFGNode>(src);
+            for (SVFGNode::const_iterator edgeIt = src->OutEdgeBegin(), edgeEit = src->OutEdgeEnd();
+                    edgeIt != edgeEit; ++edgeIt) {
+                const IndirectSVFGEdge* edge = dyn_cast<IndirectSVFGEdge>(*edgeIt);
+                if (edge == NULL)
+                    continue;
+                std::pair<llvm::DenseMap<NodeID, u32_t>::iterator, bool> task =
+                    dstToTask.insert(std::make_pair(edge->getDstID(), taskDsts.size()));
+                if (task.second) {
+                    taskDsts.push_back(edge->getDstNode());
+                    taskVars.push_back(std::vector<SrcVar>());
+                }
+                std::vector<SrcVar>& vars = taskVars[task.first->second];
+                const PointsTo& pts = edge->getPointsTo();
+                for (PointsTo::iterator ptdIt = pts.begin(), ptdEit = pts.end(); ptdIt != ptdEit; ++ptdIt) {
+                    NodeBS objs;
+                    objs.set(*ptdIt);
+                    /// If this is a field-insensitive obj, propagate all field node's pts
+                    if (isFIObjNode(*ptdIt))
+                        objs |= getAllFieldsObjNode(*ptdIt);
+                    for (NodeBS::iterator objIt = objs.begin(), objEit = objs.end(); objIt != objEit; ++objIt) {
+                        if (fromOut ? getDFPTDataTy()->hasNewDFOutPts(src->getId(), *objIt)
+                                : getDFPTDataTy()->hasNewDFInPts(src->getId(), *objIt))
+                            vars.push_back(std::make_pair(src, *objIt));
+                    }
+                }
+            }
+        }
+
+        parallel::parallelFor(taskDsts.size(), [&](size_t i) {
+            const SVFGNode* dst = taskDsts[i];
+            const std::vector<SrcVar>& vars = taskVars[i];
+            for (std::vector<SrcVar>::const_iterator it = vars.begin(), eit = vars.end(); it != eit; ++it) {
+                if (isa<StoreSVFGNode>(it->first))
+                    propDFOutToIn(it->first, it->second, dst, it->second);
+                else
+                    propDFInToIn(it->first, it->second, dst, it->second);
+            }
+        }, taskDsts.size() < MinParallelTasks ? 1 : FSThreads);
+        double end = stat->getClk();
+        indirectPropaTime += (end - start) / TIMEINTERVAL;
+
+        for (std::vector<SVFGNode*>::const_iterator it = changedNodes.begin(), eit = changedNodes.end(); it != eit; ++it) {
+            SVFGNode* src = *it;
+            for (SVFGNode::const_iterator edgeIt = src->OutEdgeBegin(), edgeEit = src->OutEdgeEnd();
+                    edgeIt != edgeEit; ++edgeIt) {
+                if (const DirectSVFGEdge* edge = dyn_cast<DirectSVFGEdge>(*edgeIt))
+                    propAlongDirectEdge(edge);
+            }
+            clearAllDFOutVarFlag(src);
+        }
+
+        /// SCCs with more than one node, successors out of the SCC are processed at their own level
+        for (std::vector<NodeID>::const_iterator it = sccs.begin(), eit = sccs.end(); it != eit; ++it) {
+            const NodeBS& subNodes = getSCCDetector()->subNodes(*it);
+            for (NodeBS::iterator nodeIt = subNodes.begin(), nodeEit = subNodes.end(); nodeIt != nodeEit; ++nodeIt)
+                pushIntoWorklist(*nodeIt);
+            while (!isWorklistEmpty()) {
+                NodeID nodeId = popFromWorklist();
+                if (getSCCDetector()->repNode(nodeId) == *it)
+                    processNode(nodeId);
+            }
+        }
+    }
+}
+
 /*!
  * Process each SVFG node
  */
@@ -296,9 +296,9 @@ void FlowSensitiveStat::statNullPtr()
 void FlowSensitiveStat::statPtsSize()
 {
     // stat of IN set
-    statInOutPtsSize(fspta->getDFInputMap(), IN);
+    statInOutPtsSize(IN);
     // stat of OUT set
-    statInOutPtsSize(fspta->getDFOutputMap(), OUT);
+    statInOutPtsSize(OUT);
 
     /// get points-to set size information for top-level pointers.
     u32_t totalValidTopLvlPointers = 0;
@@ -327,16 +327,16 @@ void FlowSensitiveStat::statPtsSize()
         _AvgPtsSize = (double) _TotalPtsSize / totalPointer;
 }
 
-void FlowSensitiveStat::statInOutPtsSize(const DFInOutMap& data, ENUM_INOUT inOrOut)
+void FlowSensitiveStat::statInOutPtsSize(ENUM_INOUT inOrOut)
 {
-    // Get number of nodes which have IN/OUT set
-    _NumOfSVFGNodesHaveInOut[inOrOut] = data.size();
-
     u32_t inOutPtsSize = 0;
-    DFInOutMap::const_iterator it = data.begin();
-    DFInOutMap::const_iterator eit = data.end();
-    for (; it != eit; ++it) {
-        const SVFGNode* node = fspta->svfg->getSVFGNode(it->first);
+    for (NodeID loc = 0, numOfLocs = fspta->getNumOfDFLocs(); loc < numOfLocs; ++loc) {
+        if (inOrOut == IN ? !fspta->hasDFInSet(loc) : !fspta->hasDFOutSet(loc))
+            continue;
+
+        // Get number of nodes which have IN/OUT set
+        _NumOfSVFGNodesHaveInOut[inOrOut]++;
+        const SVFGNode* node = fspta->svfg->getSVFGNode(loc);
 
         // Count number of SVFG nodes have IN/OUT set.
         if (isa<FormalINSVFGNode>(node))
@@ -359,13 +359,12 @@ void FlowSensitiveStat::statInOutPtsSize(const DFInOutMap& data, ENUM_INOUT inOr
         /*-----------------------------------------------------*/
 
         // Count PAG nodes and their points-to set size.
-        const PtsMap& cptsMap = it->second;
-        PtsMap::const_iterator ptsIt = cptsMap.begin();
-        PtsMap::const_iterator ptsEit = cptsMap.end();
-        for (; ptsIt != ptsEit; ++ptsIt) {
-            if (ptsIt->second.empty()) continue;
+        const DFVarList& vars = fspta->getDFVars(loc);
+        for (DFVarList::const_iterator varIt = vars.begin(), varEit = vars.end(); varIt != varEit; ++varIt) {
+            const PointsTo& pts = inOrOut == IN ? fspta->getDFInPtsSet(node, *varIt) : fspta->getDFOutPtsSet(node, *varIt);
+            if (pts.empty()) continue;
 
-            u32_t ptsNum = ptsIt->second.count();	/// points-to target number
+            u32_t ptsNum = pts.count();	/// points-to target number
 
             // Only node with non-empty points-to set are counted.
             _NumOfVarHaveINOUTPts[inOrOut]++;
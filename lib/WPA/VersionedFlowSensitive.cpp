@@ -0,0 +1,404 @@
+//===- VersionedFlowSensitive.cpp -- Versioned flow-sensitive analysis--------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+#include "WPA/VersionedFlowSensitive.h"
+#include "WPA/WPAStat.h"
+#include "WPA/Andersen.h"
+#include "Util/AnalysisUtil.h"
+#include "Util/WorkList.h"
+
+#include <algorithm>
+#include <map>
+
+using namespace llvm;
+
+/*!
+ * Build the SVFG and label the objects of its nodes with versions
+ */
+void VersionedFlowSensitive::initialize(SVFModule svfModule) {
+    PointerAnalysis::initialize(svfModule);
+
+    AndersenWaveDiff* ander = AndersenWaveDiff::createAndersenWaveDiff(svfModule);
+    svfg = memSSA.buildSVFG(ander);
+    setGraph(svfg);
+
+    stat = new FlowSensitiveStat(this);
+
+    double start = stat->getClk();
+    prelabel();
+    double end = stat->getClk();
+    prelabelTime = (end - start) / TIMEINTERVAL;
+}
+
+/*!
+ * Finalize analysis
+ */
+void VersionedFlowSensitive::finalize() {
+    if (printStat())
+        llvm::outs() << "Versioned flow-sensitive analysis: " << numOfPrelabels << " prelabels, "
+                     << numOfVersions << " versions, " << numOfVersionPropagations << " version propagations, "
+                     << "pre-labelling time " << prelabelTime << "\n";
+
+    FlowSensitive::finalize();
+}
+
+/*!
+ * Formal-ins of address-taken functions and actual-outs of indirect call sites may be connected on the fly.
+ */
+bool VersionedFlowSensitive::isDeltaNode(const SVFGNode* node) const {
+    if (const FormalINSVFGNode* formalIn = dyn_cast<FormalINSVFGNode>(node))
+        return formalIn->getFun()->hasAddressTaken();
+    if (const ActualOUTSVFGNode* actualOut = dyn_cast<ActualOUTSVFGNode>(node))
+        return analysisUtil::getCallee(actualOut->getCallSite()) == NULL;
+    return false;
+}
+
+void VersionedFlowSensitive::collectObjects(const IndirectSVFGEdge* edge, PointsTo& objs) {
+    const PointsTo& pts = edge->getPointsTo();
+    objs |= pts;
+    for (PointsTo::iterator it = pts.begin(), eit = pts.end(); it != eit; ++it) {
+        /// Loads read all the fields of a field-insensitive object
+        if (isFIObjNode(*it))
+            objs |= getAllFieldsObjNode(*it);
+    }
+}
+
+void VersionedFlowSensitive::collectObjects(const SVFGNode* node, bool incoming, PointsTo& objs) {
+    SVFGNode::const_iterator it = incoming ? node->InEdgeBegin() : node->OutEdgeBegin();
+    SVFGNode::const_iterator eit = incoming ? node->InEdgeEnd() : node->OutEdgeEnd();
+    for (; it != eit; ++it) {
+        if (const IndirectSVFGEdge* edge = dyn_cast<IndirectSVFGEdge>(*it))
+            collectObjects(edge, objs);
+    }
+}
+
+/*!
+ * A label is a set of prelabels, a prelabel stands for the definition of an object at a store
+ * or for the unknown definitions reaching a delta node.
+ * Stores and delta nodes are given prelabels, then the labels are propagated along the indirect edges
+ * (a store yields its own prelabel, any other node yields what it consumes) until a fixed point.
+ * Nodes with the same label of an object are reached by the same definitions and share a version.
+ */
+void VersionedFlowSensitive::prelabel() {
+    NodeID numOfNodes = 0;
+    for (SVFG::iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it)
+        numOfNodes = std::max(numOfNodes, it->first + 1);
+    consume.resize(numOfNodes);
+    yield.resize(numOfNodes);
+
+    typedef llvm::DenseMap<NodeID, PointsTo> ObjToLabelMap;
+    typedef llvm::DenseMap<NodeID, u32_t> ObjToPrelabelMap;
+    std::vector<ObjToLabelMap> consumeLabels(numOfNodes);
+    std::vector<ObjToPrelabelMap> yieldLabels(numOfNodes);
+    FIFOWorkList<NodeID> worklist;
+
+    for (SVFG::iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it) {
+        const SVFGNode* node = it->second;
+        PointsTo objs;
+        if (isa<StoreSVFGNode>(node)) {
+            collectObjects(node, false, objs);
+            for (PointsTo::iterator objIt = objs.begin(), objEit = objs.end(); objIt != objEit; ++objIt)
+                yieldLabels[it->first][*objIt] = numOfPrelabels++;
+            worklist.push(it->first);
+        }
+        else if (isDeltaNode(node)) {
+            collectObjects(node, true, objs);
+            collectObjects(node, false, objs);
+            for (PointsTo::iterator objIt = objs.begin(), objEit = objs.end(); objIt != objEit; ++objIt)
+                consumeLabels[it->first][*objIt].set(numOfPrelabels++);
+            worklist.push(it->first);
+        }
+    }
+
+    while (!worklist.empty()) {
+        NodeID id = worklist.pop();
+        const SVFGNode* node = svfg->getSVFGNode(id);
+        bool isStore = isa<StoreSVFGNode>(node);
+        for (SVFGNode::const_iterator edgeIt = node->OutEdgeBegin(), edgeEit = node->OutEdgeEnd();
+                edgeIt != edgeEit; ++edgeIt) {
+            const IndirectSVFGEdge* edge = dyn_cast<IndirectSVFGEdge>(*edgeIt);
+            NodeID dst = (*edgeIt)->getDstID();
+            // a node consumes what it yields anyway
+            if (edge == NULL || (dst == id && !isStore))
+                continue;
+
+            PointsTo objs;
+            collectObjects(edge, objs);
+            bool changed = false;
+            for (PointsTo::iterator objIt = objs.begin(), objEit = objs.end(); objIt != objEit; ++objIt) {
+                if (isStore) {
+                    ObjToPrelabelMap::const_iterator labelIt = yieldLabels[id].find(*objIt);
+                    if (labelIt != yieldLabels[id].end() && consumeLabels[dst][*objIt].test_and_set(labelIt->second))
+                        changed = true;
+                }
+                else {
+                    ObjToLabelMap::const_iterator labelIt = consumeLabels[id].find(*objIt);
+                    if (labelIt != consumeLabels[id].end() && (consumeLabels[dst][*objIt] |= labelIt->second))
+                        changed = true;
+                }
+            }
+
+            if (changed && !isa<StoreSVFGNode>(svfg->getSVFGNode(dst)))
+                worklist.push(dst);
+        }
+    }
+
+    /// Number the distinct labels of each object
+    typedef std::map<std::vector<u32_t>, Version> LabelToVersionMap;
+    llvm::DenseMap<NodeID, LabelToVersionMap> labelVersions;
+    auto getVersion = [&labelVersions](NodeID obj, const PointsTo& label) {
+        std::vector<u32_t> key;
+        for (PointsTo::iterator it = label.begin(), eit = label.end(); it != eit; ++it)
+            key.push_back(*it);
+        LabelToVersionMap& versions = labelVersions[obj];
+        return versions.insert(std::make_pair(key, (Version) versions.size())).first->second;
+    };
+
+    for (NodeID id = 0; id < numOfNodes; id++) {
+        for (ObjToLabelMap::const_iterator it = consumeLabels[id].begin(), eit = consumeLabels[id].end(); it != eit; ++it) {
+            if (!it->second.empty())
+                consume[id][it->first] = getVersion(it->first, it->second);
+        }
+        for (ObjToPrelabelMap::const_iterator it = yieldLabels[id].begin(), eit = yieldLabels[id].end(); it != eit; ++it) {
+            PointsTo label;
+            label.set(it->second);
+            yield[id][it->first] = getVersion(it->first, label);
+        }
+    }
+
+    for (llvm::DenseMap<NodeID, LabelToVersionMap>::const_iterator it = labelVersions.begin(), eit = labelVersions.end();
+            it != eit; ++it) {
+        ObjVersions& versions = objVersions[it->first];
+        versions.pts.resize(it->second.size());
+        versions.reliance.resize(it->second.size());
+        versions.stmtReliance.resize(it->second.size());
+        numOfVersions += it->second.size();
+    }
+
+    /// A consumed version includes the versions yielded by the predecessors,
+    /// a load/store is processed again whenever a version it consumes changes
+    for (SVFG::iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it) {
+        const SVFGNode* node = it->second;
+        for (SVFGNode::const_iterator edgeIt = node->OutEdgeBegin(), edgeEit = node->OutEdgeEnd();
+                edgeIt != edgeEit; ++edgeIt) {
+            const IndirectSVFGEdge* edge = dyn_cast<IndirectSVFGEdge>(*edgeIt);
+            if (edge == NULL)
+                continue;
+
+            PointsTo objs;
+            collectObjects(edge, objs);
+            for (PointsTo::iterator objIt = objs.begin(), objEit = objs.end(); objIt != objEit; ++objIt) {
+                Version src = getYield(node, *objIt);
+                Version dst = getConsume(edge->getDstID(), *objIt);
+                if (src != InvalidVersion && dst != InvalidVersion && src != dst)
+                    addReliance(*objIt, src, dst);
+            }
+        }
+
+        if (isa<LoadSVFGNode>(node) || isa<StoreSVFGNode>(node)) {
+            const ObjToVersionMap& versions = consume[it->first];
+            for (ObjToVersionMap::const_iterator verIt = versions.begin(), verEit = versions.end(); verIt != verEit; ++verIt)
+                objVersions[verIt->first].stmtReliance[verIt->second].set(it->first);
+        }
+    }
+}
+
+void VersionedFlowSensitive::addReliance(NodeID obj, Version src, Version dst) {
+    std::vector<Version>& reliance = objVersions[obj].reliance[src];
+    if (std::find(reliance.begin(), reliance.end(), dst) == reliance.end())
+        reliance.push_back(dst);
+}
+
+bool VersionedFlowSensitive::unionVersionPts(NodeID obj, Version dst, Version src) {
+    if (dst == src)
+        return false;
+    ObjVersions& versions = objVersions[obj];
+    if (!(versions.pts[dst] |= versions.pts[src]))
+        return false;
+    propagateVersion(obj, dst);
+    return true;
+}
+
+bool VersionedFlowSensitive::unionVersionPts(NodeID obj, Version dst, const PointsTo& pts) {
+    if (!(objVersions[obj].pts[dst] |= pts))
+        return false;
+    propagateVersion(obj, dst);
+    return true;
+}
+
+void VersionedFlowSensitive::propagateVersion(NodeID obj, Version version) {
+    double start = stat->getClk();
+
+    ObjVersions& versions = objVersions[obj];
+    FIFOWorkList<Version> worklist;
+    worklist.push(version);
+    while (!worklist.empty()) {
+        Version changed = worklist.pop();
+        numOfVersionPropagations++;
+
+        const NodeBS& stmts = versions.stmtReliance[changed];
+        for (NodeBS::iterator it = stmts.begin(), eit = stmts.end(); it != eit; ++it)
+            pushIntoWorklist(*it);
+
+        const std::vector<Version>& reliance = versions.reliance[changed];
+        for (std::vector<Version>::const_iterator it = reliance.begin(), eit = reliance.end(); it != eit; ++it) {
+            if (versions.pts[*it] |= versions.pts[changed])
+                worklist.push(*it);
+        }
+    }
+
+    double end = stat->getClk();
+    indirectPropaTime += (end - start) / TIMEINTERVAL;
+}
+
+/*!
+ * Process load node
+ *
+ * Foreach node \in src
+ * pts(dst) = union pts(node:consumed version)
+ */
+bool VersionedFlowSensitive::processLoad(const LoadSVFGNode* load) {
+    double start = stat->getClk();
+    bool changed = false;
+
+    NodeID dstVar = load->getPAGDstNodeID();
+
+    const PointsTo& srcPts = getPts(load->getPAGSrcNodeID());
+    for (PointsTo::iterator ptdIt = srcPts.begin(); ptdIt != srcPts.end(); ++ptdIt) {
+        NodeID ptd = *ptdIt;
+
+        if (pag->isConstantObj(ptd) || pag->isNonPointerObj(ptd))
+            continue;
+
+        Version version = getConsume(load->getId(), ptd);
+        if (version != InvalidVersion && unionPts(dstVar, getVersionPts(ptd, version)))
+            changed = true;
+
+        if (isFIObjNode(ptd)) {
+            /// If the ptd is a field-insensitive node, we should also get all field nodes'
+            /// points-to sets and pass them to pagDst.
+            const NodeBS& allFields = getAllFieldsObjNode(ptd);
+            for (NodeBS::iterator fieldIt = allFields.begin(), fieldEit = allFields.end();
+                    fieldIt != fieldEit; ++fieldIt) {
+                Version fieldVersion = getConsume(load->getId(), *fieldIt);
+                if (fieldVersion != InvalidVersion && unionPts(dstVar, getVersionPts(*fieldIt, fieldVersion)))
+                    changed = true;
+            }
+        }
+    }
+
+    double end = stat->getClk();
+    loadTime += (end - start) / TIMEINTERVAL;
+    return changed;
+}
+
+/*!
+ * Process store node
+ *
+ * foreach node \in dst
+ * pts(node:yielded version) = union pts(src)
+ * The yielded versions include the consumed ones except for the target of a strong update.
+ */
+bool VersionedFlowSensitive::processStore(const StoreSVFGNode* store) {
+
+    const PointsTo & dstPts = getPts(store->getPAGDstNodeID());
+
+    /// STORE statement can only be processed if the pointer on the LHS
+    /// points to something, see FlowSensitive::processStore.
+    if (dstPts.empty())
+        return false;
+
+    double start = stat->getClk();
+    bool changed = false;
+
+    const PointsTo& srcPts = getPts(store->getPAGSrcNodeID());
+    if (srcPts.empty() == false) {
+        for (PointsTo::iterator it = dstPts.begin(), eit = dstPts.end(); it != eit; ++it) {
+            NodeID ptd = *it;
+
+            if (pag->isConstantObj(ptd) || pag->isNonPointerObj(ptd))
+                continue;
+
+            Version version = getYield(store, ptd);
+            if (version != InvalidVersion && unionVersionPts(ptd, version, srcPts))
+                changed = true;
+        }
+    }
+
+    double end = stat->getClk();
+    storeTime += (end - start) / TIMEINTERVAL;
+
+    double updateStart = stat->getClk();
+    /// check if this is a strong updates store
+    NodeID singleton;
+    bool isSU = isStrongUpdate(store, singleton);
+    if (isSU)
+        svfgHasSU.set(store->getId());
+    else
+        svfgHasSU.reset(store->getId());
+
+    const ObjToVersionMap& yields = yield[store->getId()];
+    for (ObjToVersionMap::const_iterator it = yields.begin(), eit = yields.end(); it != eit; ++it) {
+        if (isSU && it->first == singleton)
+            continue;
+        Version consumed = getConsume(store->getId(), it->first);
+        if (consumed != InvalidVersion && unionVersionPts(it->first, it->second, consumed))
+            changed = true;
+    }
+    double updateEnd = stat->getClk();
+    updateTime += (updateEnd - updateStart) / TIMEINTERVAL;
+
+    return changed;
+}
+
+/*!
+ * Push nodes connected during update call graph into worklist, and let the versions
+ * consumed by the formal-ins/actual-outs include the ones yielded over the new edges.
+ */
+void VersionedFlowSensitive::updateConnectedNodes(const SVFGEdgeSetTy& edges)
+{
+    for (SVFGEdgeSetTy::const_iterator it = edges.begin(), eit = edges.end(); it != eit; ++it) {
+        const SVFGEdge* edge = *it;
+        SVFGNode* dstNode = edge->getDstNode();
+        if (isa<PHISVFGNode>(dstNode)) {
+            /// If this is a formal-param or actual-ret node, we need to solve this phi
+            /// node in next iteration
+            pushIntoWorklist(dstNode->getId());
+            continue;
+        }
+
+        const IndirectSVFGEdge* indEdge = dyn_cast<IndirectSVFGEdge>(edge);
+        if (indEdge == NULL)
+            continue;
+
+        PointsTo objs;
+        collectObjects(indEdge, objs);
+        for (PointsTo::iterator objIt = objs.begin(), objEit = objs.end(); objIt != objEit; ++objIt) {
+            Version src = getYield(edge->getSrcNode(), *objIt);
+            Version dst = getConsume(dstNode->getId(), *objIt);
+            if (src == InvalidVersion || dst == InvalidVersion || src == dst)
+                continue;
+            addReliance(*objIt, src, dst);
+            unionVersionPts(*objIt, dst, src);
+        }
+    }
+}
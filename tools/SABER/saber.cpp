@@ -71,18 +71,23 @@ int main(int argc, char ** argv) {
 
     SVFModule svfModule(moduleNameVec);
 
-    LeakChecker *saber;
+    std::vector<LeakChecker*> checkers;
 
     if(LEAKCHECKER)
-        saber = new LeakChecker();
-    else if(FILECHECKER)
-        saber = new FileChecker();
-    else if(DFREECHECKER)
-        saber = new DoubleFreeChecker();
-    else
-	saber = new LeakChecker();  // if no checker is specified, we use leak checker as the default one.
-
-    saber->runOnModule(svfModule);
+        checkers.push_back(new LeakChecker());
+    if(FILECHECKER)
+        checkers.push_back(new FileChecker());
+    if(DFREECHECKER)
+        checkers.push_back(new DoubleFreeChecker());
+    if(checkers.empty())
+        checkers.push_back(new LeakChecker());  // if no checker is specified, we use leak checker as the default one.
+
+    /// the SVFG is built once by the first checker and reused by the others in this process
+    for (u32_t i = 0; i < checkers.size(); i++) {
+        if (i > 0)
+            checkers[i]->reuseSVFGOf(checkers[0]);
+        checkers[i]->runOnModule(svfModule);
+    }
 
     svfModule.dumpModulesToFile(".dvf");
 
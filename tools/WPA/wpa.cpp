@@ -29,6 +29,7 @@
 #include "WPA/WPAPass.h"
 #include "RaceDetectorBase/RaceDetectorBase.h"
 #include "Util/AnalysisUtil.h" //for source loc
+#include "Util/ThreadAPI.h" //for thread/lock APIs
 
 #include <string>
 #include <vector>
@@ -51,7 +52,10 @@
 using namespace llvm;
 using namespace std;
 
-static bool sharedOutput=false, outputFiles = true, outputMethods = true, outputVariables = false, debug = false;
+static bool sharedOutput=false, outputFiles = true, outputMethods = true, outputVariables = false, debug = false, incremental = false, dumpGraphs = false;
+static string threadAPIFile = "../../ThreadAPI.txt";
+static TSAReport::Format candidates = TSAReport::NoCandidates;
+static RaceDetectorBase::PTAKind ptaKind = RaceDetectorBase::AndersenPTA;
 static cl::opt<std::string> InputFilename(cl::Positional, cl::desc("<input bitcode>"), cl::init("-"));
 
 int config(){
@@ -67,6 +71,14 @@ int config(){
             else if (*index == "-NoMethodOutput" || *index == "-nomethodoutput") { outputMethods = false; }
             else if (*index == "-OutputVariables" || *index == "-outputvariables") { outputVariables = true; }
             else if (*index == "-Debug" || *index == "-debug") { debug = true; }
+            else if (*index == "-Incremental" || *index == "-incremental") { incremental = true; }
+            else if (*index == "-DumpGraphs" || *index == "-dumpgraphs") { dumpGraphs = true; }
+            else if (*index == "-RaceCandidates=JSON" || *index == "-racecandidates=json") { candidates = TSAReport::JSON; }
+            else if (*index == "-RaceCandidates=CSV" || *index == "-racecandidates=csv") { candidates = TSAReport::CSV; }
+            else if (*index == "-PointerAnalysis=Andersen" || *index == "-pointeranalysis=andersen") { ptaKind = RaceDetectorBase::AndersenPTA; }
+            else if (*index == "-PointerAnalysis=Origin" || *index == "-pointeranalysis=origin") { ptaKind = RaceDetectorBase::OriginPTA; }
+            else if (*index == "-PointerAnalysis=CallSite" || *index == "-pointeranalysis=callsite") { ptaKind = RaceDetectorBase::CallSitePTA; }
+            else if (index->find("-ThreadAPI=")==0 || index->find("-threadapi=")==0) { threadAPIFile = index->substr(11); }
             else if (*index == "-Help" || *index == "-help") {
                 cout << "---------------------------------------------------------------------------------\n";
                 cout << "| -PotentiallySharedOutput\t\tOutputs data that is not determined to be local\t|\n";
@@ -74,6 +86,11 @@ int config(){
                 cout << "| -NoMethodOutput\t\t\t\tPrevents output from containing full methods\t|\n";
                 cout << "| -OutputVariables\t\t\t\tAdds individual variable output\t\t\t\t\t|\n";
                 cout << "| -Debug\t\t\t\t\t\tEnables debugging console output\t\t\t\t|\n";
+                cout << "| -Incremental\t\t\t\t\tReuses TSAState.txt to only re-analyze changes\t|\n";
+                cout << "| -DumpGraphs\t\t\t\t\tDumps the PAG and the SHB graph\t\t\t\t\t|\n";
+                cout << "| -RaceCandidates=<JSON|CSV>\t\tWrites race candidates (RaceCandidates.*)\t|\n";
+                cout << "| -ThreadAPI=<file>\t\t\t\tReads extra thread/lock APIs (ThreadAPI.txt)\t|\n";
+                cout << "| -PointerAnalysis=<Andersen|Origin|CallSite>\tPointer analysis (Andersen)\t|\n";
                 cout << "| -Help\t\t\t\t\t\t\tReturns this information\t\t\t\t\t\t|\n";
                 cout << "---------------------------------------------------------------------------------";
                 return 0;
@@ -84,12 +101,19 @@ int config(){
             }
         }
     }
+    bool threadAPILoaded = ThreadAPI::getThreadAPI()->loadAPIFile(threadAPIFile);
+    if (!threadAPILoaded) {cerr << "Warning: cannot open thread API file " << threadAPIFile << ", using built-in APIs only\n";}
     cout << "--Current Configuration Settings:--\n";
     cout << "\tOutput Style:\t\t"; if(sharedOutput){cout << "Potentially Shared";}else{cout << "Unshared";} cout << "\n";
     cout << "\tFile Checks:\t\t"; if(outputFiles){cout << "Enabled";}else{cout << "Disabled";} cout << "\n";
     cout << "\tMethod Checks:\t\t"; if(outputMethods){cout << "Enabled";}else{cout << "Disabled";} cout << "\n";
     cout << "\tVariable Checks:\t"; if(outputVariables){cout << "Enabled";}else{cout << "Disabled";} cout << "\n";
-    cout << "\tDebug Mode:\t\t\t"; if(debug){cout << "Enabled";}else{cout << "Disabled";} cout<<"\n\n";
+    cout << "\tDebug Mode:\t\t\t"; if(debug){cout << "Enabled";}else{cout << "Disabled";} cout<<"\n";
+    cout << "\tIncremental:\t\t"; if(incremental){cout << "Enabled";}else{cout << "Disabled";} cout<<"\n";
+    cout << "\tGraph Dumps:\t\t"; if(dumpGraphs){cout << "Enabled";}else{cout << "Disabled";} cout<<"\n";
+    cout << "\tRace Candidates:\t"; if(candidates==TSAReport::JSON){cout << "JSON";}else if(candidates==TSAReport::CSV){cout << "CSV";}else{cout << "Disabled";} cout<<"\n";
+    cout << "\tPointer Analysis:\t"; if(ptaKind==RaceDetectorBase::OriginPTA){cout << "Origin";}else if(ptaKind==RaceDetectorBase::CallSitePTA){cout << "CallSite";}else{cout << "Andersen";} cout<<"\n";
+    cout << "\tThread APIs:\t\t"; if(threadAPILoaded){cout << threadAPIFile;}else{cout << "Built-in";} cout<<"\n\n";
     return -1;
 }
 
@@ -113,5 +137,5 @@ int main(int argc, char ** argv) {
     //Analysis
         SVFModule svfModule(moduleNameVec);
         auto detector = new RaceDetectorBase();
-        return detector->runOnModule(svfModule,sharedOutput,outputFiles,outputMethods,outputVariables,debug);
+        return detector->runOnModule(svfModule,sharedOutput,outputFiles,outputMethods,outputVariables,debug,incremental,candidates,ptaKind,dumpGraphs);
 }